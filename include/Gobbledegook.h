@@ -57,6 +57,8 @@
 
 #pragma once
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif //__cplusplus
@@ -79,6 +81,23 @@ void ggkLogRegisterFatal(GGKLogReceiver receiver);
 void ggkLogRegisterAlways(GGKLogReceiver receiver);
 void ggkLogRegisterTrace(GGKLogReceiver receiver);
 
+// Enable asynchronous log delivery
+//
+// Callers deposit messages into a preallocated lock-free ring and return immediately; a background drain thread
+// invokes the registered receivers. Each delivered message is prefixed with a monotonic `[seconds.microseconds]`
+// timestamp captured when it was logged. FATAL logs bypass the ring and remain synchronous. If the ring overflows,
+// the message is dropped and counted (see `ggkGetLogDroppedMessageCount`.)
+void ggkLogEnableAsync();
+
+// Disable asynchronous log delivery, draining any queued messages before returning
+//
+// Logging reverts to synchronous delivery on the calling thread. Safe to call when asynchronous delivery was never
+// enabled.
+void ggkLogDisableAsync();
+
+// Returns the number of log messages dropped due to ring overflow since asynchronous delivery was first enabled
+uint32_t ggkGetLogDroppedMessageCount();
+
 // -----------------------------------------------------------------------------------------------------------------------------
 // SERVER DATA
 // -----------------------------------------------------------------------------------------------------------------------------
@@ -113,20 +132,107 @@ typedef const void *(*GGKServerDataGetter)(const char *pName);
 //   * Any other failure, as deemed by the delegate handler
 typedef int (*GGKServerDataSetter)(const char *pName, const void *pData);
 
+// A zero-copy view of application-owned data
+//
+// The application owns the memory behind `pData`. The server reads the span only while marshaling a response or a
+// change notification on the main loop thread, and never holds onto it between calls - but the application must keep
+// the memory valid (and unchanged) for a given generation until it publishes the next one.
+//
+// `generation` is incremented by the application each time it publishes new data for the name; the server uses it to
+// recognize whether a cached encoding of the span is still current.
+typedef struct {
+    const uint8_t *pData; // The bytes (NULL if no data is available for the requested name)
+    uint32_t count;       // The number of bytes in the view
+    uint32_t generation;  // Incremented by the application on each publish
+} GGKDataSpan;
+
+// A delegate for retrieving zero-copy views of named server data (see `GGKDataSpan`)
+//
+// This is an optional companion to `GGKServerDataGetter` for large values (our state blob is 4KB) where the copy
+// through the void-pointer getter is measurable. Return a span with a NULL `pData` for names that are not served this
+// way - the server falls back to the regular data getter.
+typedef GGKDataSpan (*GGKServerDataSpanGetter)(const char *pName);
+
+// Registers the application's span getter (see `GGKServerDataSpanGetter`)
+//
+// This may be called before or after `ggkStart()`. Pass NULL to unregister.
+void ggkRegisterDataSpanGetter(GGKServerDataSpanGetter getter);
+
 // -----------------------------------------------------------------------------------------------------------------------------
 // SERVER DATA UPDATE MANAGEMENT
 // -----------------------------------------------------------------------------------------------------------------------------
 
+// Priority classes for queued updates
+//
+// The update queue is divided into strict-priority lanes. The dispatcher always services the control lane first,
+// then the normal lane, then the bulk lane - so a control update (an e-stop status change, say) is dispatched next
+// even when a bulk transfer has hundreds of data-chunk updates queued. The bulk lane is protected from outright
+// starvation: it is granted one entry after every sixteen consecutive higher-lane dispatches while its entries
+// wait.
+//
+// Updates pushed without an explicit priority go to the normal lane.
+enum GGKUpdatePriority {
+    GGK_PRIO_CONTROL = 0, // Safety-critical or latency-sensitive control traffic - always dispatched first
+    GGK_PRIO_NORMAL = 1,  // Everything else (the default for the priority-less notify methods)
+    GGK_PRIO_BULK = 2     // High-rate data-chunk updates that must never delay the lanes above
+};
+
 // Adds an update to the front of the queue for a characteristic at the given object path
 //
 // Returns non-zero value on success or 0 on failure.
 int ggkNofifyUpdatedCharacteristic(const char *pObjectPath);
 
+// As `ggkNofifyUpdatedCharacteristic()`, but queues the update in the given priority lane (see `GGKUpdatePriority`)
+//
+// Returns non-zero value on success or 0 on failure (including an invalid priority.)
+int ggkNofifyUpdatedCharacteristicWithPriority(const char *pObjectPath, enum GGKUpdatePriority priority);
+
 // Adds an update to the front of the queue for a descriptor at the given object path
 //
 // Returns non-zero value on success or 0 on failure.
 int ggkNofifyUpdatedDescriptor(const char *pObjectPath);
 
+// Adds updates for several characteristics at once, dispatching them together
+//
+// The entries are queued as a group and the main loop is woken exactly once, so all of the resulting notifications
+// are emitted within a single main-loop dispatch rather than one wakeup per path. Use this when related
+// characteristics change as a unit.
+//
+// Returns the number of paths successfully queued (which may be less than `count` if the queue fills.)
+int ggkNofifyUpdatedCharacteristics(const char **ppObjectPaths, int count);
+
+// Interns the characteristic at the given object path, returning a small integer ID for use with
+// `ggkNofifyUpdatedCharacteristicById()`
+//
+// Interning a path once (typically at startup) lets high-rate updates skip the per-push string copy and the per-
+// dispatch string lookup - interned updates are resolved by array index. Interning the same path again returns the
+// same ID.
+//
+// Returns the ID (>= 0) on success, or -1 if the interning table is full or the path is too long.
+int ggkInternCharacteristicPath(const char *pObjectPath);
+
+// Interns the descriptor at the given object path (see `ggkInternCharacteristicPath()`)
+//
+// Returns the ID (>= 0) on success, or -1 if the interning table is full or the path is too long.
+int ggkInternDescriptorPath(const char *pObjectPath);
+
+// Adds an update to the front of the queue for a previously interned path (characteristic or descriptor)
+//
+// This is the allocation-free fast path for high-rate updates. See `ggkInternCharacteristicPath()`.
+//
+// Returns non-zero value on success or 0 on failure (including an ID that was never interned.)
+int ggkNofifyUpdatedCharacteristicById(int pathId);
+
+// As `ggkNofifyUpdatedCharacteristicById()`, but queues the update in the given priority lane (see
+// `GGKUpdatePriority`)
+//
+// This is the right call for a bulk transfer's data-chunk updates: intern the path once, then push by ID into the
+// bulk lane so the chunks never delay control traffic.
+//
+// Returns non-zero value on success or 0 on failure (including an invalid priority or an ID that was never
+// interned.)
+int ggkNofifyUpdatedCharacteristicByIdWithPriority(int pathId, enum GGKUpdatePriority priority);
+
 // Adds a named update to the front of the queue. Generally, this routine should not be used directly. Instead, use the
 // `ggkNofifyUpdatedCharacteristic()` instead.
 //
@@ -143,20 +249,156 @@ int ggkPushUpdateQueue(const char *pObjectPath, const char *pInterfaceName);
 // will not fit within `elementLen` bytes, the method returns `-1` and does nothing.
 //
 // If `keep` is set to non-zero, the entry is not removed and will be retrieved again on the next call. Otherwise, the
-// element is removed.
+// element is removed. Note that entries are served in priority-lane order (see `GGKUpdatePriority`), so a kept entry
+// may be superseded by a higher-priority arrival before the next call.
 //
 // Returns 1 on success, 0 if the queue is empty, -1 on error (such as the length too small to store the element)
 int ggkPopUpdateQueue(char *pElement, int elementLen, int keep);
 
+// As `ggkPopUpdateQueue()`, but additionally returns the entry's interned-path ID in `*pPathId` (or -1 for an entry
+// that was pushed by path string.) This is used by the server's dispatcher to resolve interned updates by array index.
+int ggkPopUpdateQueueWithId(char *pElement, int elementLen, int keep, int *pPathId);
+
 // Returns 1 if the queue is empty, otherwise 0
 int ggkUpdateQueueIsEmpty();
 
-// Returns the number of entries waiting in the queue
+// Returns the number of entries waiting in the queue (across all priority lanes)
 int ggkUpdateQueueSize();
 
-// Removes all entries from the queue
+// Removes all entries from the queue (all priority lanes)
 void ggkUpdateQueueClear();
 
+// Statistics describing the update queue's behavior since the process started, aggregated across the priority lanes
+//
+// Note that `totalCoalesced` and `totalDropped` count pushes that did NOT result in a queued entry: coalesced pushes
+// were folded into an already-pending entry for the same (objectPath, interfaceName) pair (see
+// `ggkUpdateQueueSetCoalescing`), while dropped pushes were rejected due to the queue bound (see
+// `ggkUpdateQueueSetMaxSize`.)
+typedef struct {
+    uint32_t capacity;       // Hard capacity of the queue
+    uint32_t maxSize;        // Configured soft bound (<= capacity)
+    uint32_t size;           // Current number of pending entries
+    uint32_t totalPushed;    // Total pushes attempted
+    uint32_t totalPopped;    // Total entries consumed
+    uint32_t totalCoalesced; // Pushes folded into an already-pending entry
+    uint32_t totalDropped;   // Pushes rejected (queue at bound or entry too large)
+} GGKUpdateQueueStats;
+
+// Retrieve a snapshot of the update queue statistics (see `GGKUpdateQueueStats`)
+void ggkUpdateQueueStats(GGKUpdateQueueStats *pStats);
+
+// Enable (non-zero) or disable (0) per-path coalescing
+//
+// When coalescing is enabled, the queue keeps at most one pending entry per (objectPath, interfaceName) pair. A push
+// for a pair that is already pending succeeds without growing the queue - the pending entry covers it, since entries
+// carry no payload and the newest data is read when the update is dispatched. This prevents a fast producer from
+// flooding the client with stale PropertiesChanged signals.
+//
+// Coalescing is disabled by default.
+void ggkUpdateQueueSetCoalescing(int enable);
+
+// Set the maximum number of pending entries each priority lane will accept (backpressure bound)
+//
+// Pushes beyond the bound fail (and are counted in `totalDropped`.) The value is clamped to a lane's hard capacity;
+// values less than 1 are ignored. The default bound is the hard capacity.
+void ggkUpdateQueueSetMaxSize(int maxSize);
+
+// -----------------------------------------------------------------------------------------------------------------------------
+// DATA STORE
+//
+// A built-in value store shared between the application's threads and the server thread. Application threads publish
+// named byte values from any thread; the server reads them without ever blocking on an application lock (each slot is
+// guarded by a seqlock, so reads retry only in the rare case a publish overlapped the snapshot.) Use the same names
+// here that the server description uses with `getDataValue()` / `getStoredValue()`.
+// -----------------------------------------------------------------------------------------------------------------------------
+
+// Registers a named slot in the value store with a fixed capacity in bytes
+//
+// Registration should happen once, at startup, before the name is published or read. Registering an existing name
+// succeeds if the capacity fits the existing slot (the slot is not resized.)
+//
+// Returns non-zero value on success, or 0 if the store is full, the name is too long, or the capacity is 0.
+int ggkDataStoreRegister(const char *pName, uint32_t capacity);
+
+// Publishes a new value into a registered slot (any thread)
+//
+// Returns non-zero value on success, or 0 if the name was never registered or the value exceeds the slot's capacity.
+int ggkDataStorePublish(const char *pName, const void *pData, uint32_t count);
+
+// Reads the current value of a registered slot into `pBuffer` (any thread; wait-free with respect to publishers)
+//
+// Returns the number of bytes read, or -1 if the name was never registered or `bufferLen` is smaller than the slot's
+// current value.
+int ggkDataStoreRead(const char *pName, void *pBuffer, uint32_t bufferLen);
+
+// Returns the registered capacity of a slot in bytes, or -1 if the name was never registered
+int ggkDataStoreCapacity(const char *pName);
+
+// -----------------------------------------------------------------------------------------------------------------------------
+// FILE-BACKED VALUES
+// -----------------------------------------------------------------------------------------------------------------------------
+
+// Binds the value of the characteristic at `pObjectPath` to the file at `pFilePath` (pass NULL to unbind)
+//
+// A bound characteristic serves ReadValue requests zero-copy from a read-only memory mapping of the file: nothing
+// beyond the pages actually read becomes resident, and no heap copy of the payload is made. The file may be
+// replaced in place (a firmware update dropping a new image) - the mapping re-validates on every read and picks up
+// the new contents automatically, while reads already in flight finish against the old ones.
+//
+// The file takes precedence over the characteristic's data getter while bound. Must be called after `ggkStart()`
+// has brought the server up.
+//
+// Returns non-zero on success, or 0 if no characteristic lives at `pObjectPath`
+int ggkBindCharacteristicValueFile(const char *pObjectPath, const char *pFilePath);
+
+// -----------------------------------------------------------------------------------------------------------------------------
+// STREAMING TRANSFERS
+//
+// A built-in engine for pushing large payloads (firmware images, config blobs) over the stream characteristic pair:
+// the payload is fragmented to the negotiated MTU, multiple chunks are pipelined within a credit window the receiver
+// controls, and sequence/ack tracking with go-back-N retransmission recovers dropped chunks - all without an
+// application-level ack per chunk. See the wire-protocol discussion in StreamEngine.cpp; the receiving side must
+// speak that protocol (acks and credit grants written to the stream command characteristic.)
+//
+// One transfer may be in flight at a time, and the client must hold an acquired notification fd on the stream data
+// characteristic before a transfer starts.
+// -----------------------------------------------------------------------------------------------------------------------------
+
+// Progress delegate for streaming transfers
+//
+// Called (on the server thread) each time the receiver's cumulative ack advances, and a final time on completion (at
+// which point `bytesAcked` equals `totalBytes`.)
+typedef void (*GGKStreamProgressCallback)(uint32_t bytesAcked, uint32_t totalBytes);
+
+// Pull delegate for transfers too large (or too dynamic) to stage in memory
+//
+// Called (on the server thread) to fill `pBuffer` with up to `count` bytes of the payload starting at `offset`.
+// Return the number of bytes provided; returning less than `count` before the end of the payload aborts the
+// transfer. The delegate may be called for the same range more than once (retransmission.)
+typedef uint32_t (*GGKStreamPullCallback)(uint32_t offset, void *pBuffer, uint32_t count);
+
+// Begins a streaming transfer of `count` bytes from `pData` (which is copied - the buffer may be released as soon as
+// this returns)
+//
+// `progress` may be NULL. Returns non-zero if the transfer was started, or 0 if one is already in flight.
+int ggkStreamSendBuffer(const void *pData, uint32_t count, GGKStreamProgressCallback progress);
+
+// As `ggkStreamSendBuffer`, but the payload is pulled on demand via `pull` instead of being staged in memory
+int ggkStreamSendPull(GGKStreamPullCallback pull, uint32_t totalBytes, GGKStreamProgressCallback progress);
+
+// As `ggkStreamSendBuffer`, but the payload is the file at `pFilePath`, memory-mapped rather than staged
+//
+// Chunks are built straight from the page cache, so an 8MB firmware image costs no resident heap copy. The mapping
+// taken at transfer start is held to the end of the transfer, so replacing the file mid-transfer cannot tear the
+// payload - the old contents are sent to completion.
+int ggkStreamSendFile(const char *pFilePath, GGKStreamProgressCallback progress);
+
+// Aborts the in-flight streaming transfer (if any.) Safe to call from any thread.
+void ggkStreamCancel();
+
+// Returns non-zero while a streaming transfer is in flight
+int ggkStreamIsActive();
+
 // -----------------------------------------------------------------------------------------------------------------------------
 // SERVER CONTROL
 // -----------------------------------------------------------------------------------------------------------------------------
@@ -223,6 +465,25 @@ int ggkStart(
     int maxAsyncInitTimeoutMS
 );
 
+// Same as `ggkStart`, but binds the server to a specific HCI controller (hci0, hci1, ...)
+//
+// `hciIndex` is the zero-based controller index as recognized by the OS. The controller selection steers both the
+// management (HCI) commands used to configure the adapter and the BlueZ adapter object the GATT application is
+// registered against. `ggkStart` is equivalent to `ggkStartOnAdapter` with an index of 0.
+//
+// A process hosts one server, so serving N controllers means running N processes, each started on its own index.
+int ggkStartOnAdapter(
+    int hciIndex,
+    const char *pServiceName,
+    const char *pAdvertisingName,
+    const char *pAdvertisingShortName,
+    bool enableMultipleConnections,
+    bool externalAdvertising,
+    GGKServerDataGetter getter,
+    GGKServerDataSetter setter,
+    int maxAsyncInitTimeoutMS
+);
+
 // Blocks for up to maxAsyncInitTimeoutMS milliseconds until the server shuts down.
 //
 // If shutdown is successful, this method will return a non-zero value. Otherwise, it will return 0.
@@ -281,6 +542,134 @@ const char *ggkGetServerRunStateString(enum GGKServerRunState state);
 // Convenience method to check ServerRunState for a running server
 int ggkIsServerRunning();
 
+// Returns the ATT MTU negotiated on the current connection, or 0 if it is not yet known
+//
+// BlueZ reports the negotiated MTU when a client acquires an fd channel (AcquireNotify/AcquireWrite), so this
+// returns 0 until at least one channel has been acquired. Callers sizing payloads should subtract the 3-byte ATT
+// notification header from this value, and treat 0 as "assume the 23-byte default".
+int ggkGetConnectionMTU();
+
+// -----------------------------------------------------------------------------------------------------------------------------
+// CONNECTION TUNING
+// -----------------------------------------------------------------------------------------------------------------------------
+
+// Connection-parameter profiles (see `ggkRequestConnectionProfile`)
+enum GGKConnectionProfile {
+    GGK_PROFILE_BALANCED = 0,   // Moderate interval - the default trade between latency and radio time
+    GGK_PROFILE_THROUGHPUT = 1, // Short (15-30ms) interval - for bulk transfers
+    GGK_PROFILE_LOW_POWER = 2   // Long (200-400ms) interval with slave latency - for idle, battery-sensitive periods
+};
+
+// Request a connection-parameter profile for the current connection
+//
+// By default the connection runs at whatever interval the central picked, which is often far from optimal - a phone
+// negotiating a ~50ms interval caps a firmware transfer at a fraction of what the link can carry. This asks the
+// kernel to negotiate the given profile's connection interval and slave latency with the connected central.
+//
+// The request is remembered: a profile requested while no central is connected is applied as soon as one connects,
+// and while the streaming engine has a transfer in flight, the throughput profile is forced automatically with the
+// profile requested here restored when the transfer ends. The central is free to reject the negotiation, so treat
+// this as a request, not a guarantee.
+//
+// Returns 1 if the parameter update was sent for the current connection, 2 if the request was recorded and will be
+// applied later (no device connected yet, or a transfer is in flight), or 0 on failure (an invalid profile, or the
+// command could not be sent.)
+int ggkRequestConnectionProfile(enum GGKConnectionProfile profile);
+
+// -----------------------------------------------------------------------------------------------------------------------------
+// STARTUP TIMINGS
+// -----------------------------------------------------------------------------------------------------------------------------
+
+// Per-phase startup durations
+//
+// Each value is the elapsed time in milliseconds from the start of the server thread to the completion of that
+// initialization phase. A value of 0 means the phase has not completed yet, so these may be polled during
+// initialization to see how far the server has progressed.
+typedef struct {
+    uint32_t busAcquiredMS;           // Connected to the D-Bus system bus
+    uint32_t nameAcquiredMS;          // Acquired our owned name on the bus
+    uint32_t objectManagerMS;         // Obtained BlueZ's ObjectManager client
+    uint32_t adapterFoundMS;          // Located the adapter's GattManager1 interface
+    uint32_t adapterConfiguredMS;     // Finished configuring the adapter (power, LE, advertising, etc.)
+    uint32_t objectsRegisteredMS;     // Registered our object hierarchy with D-Bus
+    uint32_t applicationRegisteredMS; // Registered our GATT application with BlueZ
+    uint32_t totalMS;                 // Reached the running state
+} GGKStartupTimings;
+
+// Retrieve the per-phase startup durations for the current (or most recent) server
+//
+// Returns non-zero on success, or 0 if `pTimings` is NULL
+int ggkGetStartupTimings(GGKStartupTimings *pTimings);
+
+// -----------------------------------------------------------------------------------------------------------------------------
+// METRICS
+// -----------------------------------------------------------------------------------------------------------------------------
+
+// A summary of one latency histogram
+//
+// All durations are in nanoseconds. Percentiles are bucket-resolution (power-of-two buckets), so they are accurate to
+// within a factor of two - suitable for telling 100us from 10ms, not for fine-grained comparisons.
+typedef struct {
+    uint64_t count;
+    uint64_t minNS;
+    uint64_t maxNS;
+    uint64_t meanNS;
+    uint64_t p50NS;
+    uint64_t p95NS;
+    uint64_t p99NS;
+} GGKLatencySnapshot;
+
+// A snapshot of the server's hot-path metrics
+//
+// All counters and histograms accumulate from server start. `updateQueueDepth` is the number of updates currently
+// pending; `updateQueueHighWater` is the deepest the queue has ever been (a persistently high value means the main
+// loop is not keeping up with the application's publish rate.)
+typedef struct {
+    uint32_t updateQueueDepth;
+    uint32_t updateQueueHighWater;
+
+    // Notification dispatch latency, from the application's push to the signal/fd write completing
+    GGKLatencySnapshot notificationLatency;
+
+    // D-Bus method service time (every ReadValue/WriteValue from a client lands here)
+    GGKLatencySnapshot methodServiceTime;
+
+    // HCI command round-trip time
+    GGKLatencySnapshot hciCommandRoundTrip;
+
+    // Reconnect gap - from a known device's disconnect to the same device reconnecting (bonded devices whose keys
+    // are cached reconnect without rediscovery, which is what this histogram is meant to verify)
+    GGKLatencySnapshot reconnectTime;
+} GGKMetricsSnapshot;
+
+// Retrieve a snapshot of the server's hot-path metrics
+//
+// Safe to call from any thread at any time - recording is wait-free and never blocked by a snapshot.
+//
+// Returns non-zero on success, or 0 if `pSnapshot` is NULL
+int ggkGetMetricsSnapshot(GGKMetricsSnapshot *pSnapshot);
+
+// -----------------------------------------------------------------------------------------------------------------------------
+// TRACING
+// -----------------------------------------------------------------------------------------------------------------------------
+
+// Dump the server's flight-recorder trace ring to the file at `pPath`
+//
+// The server continuously records fixed-size binary trace records (HCI socket reads/writes, HCI events and command
+// round-trips, D-Bus method entry/exit, update-queue dequeues) into an in-memory ring holding the most recent few
+// thousand events. Recording is lock-free and cheap enough to stay enabled in production; this call writes the ring's
+// current contents to a file for offline decoding.
+//
+// The file begins with a 16-byte header (the magic "GGKTRACE", a 32-bit format version, and the 32-bit record size)
+// followed by the records, oldest first. Each record holds a monotonic nanosecond timestamp (the same timebase as the
+// metrics snapshot), a 16-bit event id, and 8 payload bytes whose meaning depends on the event.
+//
+// Safe to call from any thread at any time; recording continues while the dump runs, so a handful of records that are
+// in flight during the walk may be dropped.
+//
+// Returns the number of records written, or -1 if `pPath` is NULL or the file could not be written
+int ggkDumpTrace(const char *pPath);
+
 // -----------------------------------------------------------------------------------------------------------------------------
 // SERVER HEALTH
 // -----------------------------------------------------------------------------------------------------------------------------
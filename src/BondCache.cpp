@@ -0,0 +1,204 @@
+// Copyright 2017-2019 Paul Nettle
+//
+// This file is part of Gobbledegook.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file in the root of the source tree.
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// >>
+// >>>  INSIDE THIS FILE
+// >>
+//
+// A persistent cache of bonded-device keys, so known devices reconnect fast instead of re-pairing
+//
+// >>
+// >>>  DISCUSSION
+// >>
+//
+// Without this cache, every process restart forgets every bond: a known phone reconnecting goes through the full
+// discovery and pairing dance again, which costs several seconds of user-visible latency dozens of times a day. The
+// kernel hands us everything we need to avoid that - when a device bonds, the management API reports its Long Term
+// Key and Identity Resolving Key as events. We capture those on the HCI event thread, keep them here, and persist
+// them to a small binary file so the next run can load them straight back into the controller's resolving and
+// accept lists (see `Mgmt::loadBondedDevices`.)
+//
+// The cache file holds link keys, so it lives under /var/lib (bonds survive a reboot - /tmp would silently unbond
+// everyone on power cycle) and is written with owner-only permissions. Like the adapter config cache, it is purely
+// an optimization: if it can't be read or written, devices simply pair the slow way.
+//
+// The file is a 16-byte header (magic "GGKBONDS", a format version, and the two key counts) followed by the raw key
+// structures - the same layouts the management API uses, so nothing is translated on the way in or out.
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include <fcntl.h>
+#include <mutex>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "BondCache.h"
+#include "Logger.h"
+
+namespace ggk {
+
+// The cache file (see the discussion above for why it is not in /tmp)
+static const char *kBondCachePath = "/var/lib/ggk-bonds.cache";
+
+// The file header: a magic, a format version, and the key counts
+static const char kBondCacheMagic[8] = {'G', 'G', 'K', 'B', 'O', 'N', 'D', 'S'};
+static const uint32_t kBondCacheVersion = 1;
+
+// The in-memory cache (guarded by `cacheMutex`; loaded from disk on first use)
+static std::mutex cacheMutex;
+static std::vector<BondLongTermKey> longTermKeys;
+static std::vector<BondIdentityKey> identityKeys;
+static bool bCacheLoaded = false;
+
+// Returns true if the two addresses (with their types) refer to the same device
+static bool sameDevice(const uint8_t *pAddressA, uint8_t typeA, const uint8_t *pAddressB, uint8_t typeB) {
+    return typeA == typeB && 0 == memcmp(pAddressA, pAddressB, 6);
+}
+
+// Loads the cache from disk (callers hold `cacheMutex`; a missing or malformed file just leaves the cache empty)
+static void loadCache() {
+    if (bCacheLoaded) {
+        return;
+    }
+
+    bCacheLoaded = true;
+
+    FILE *pFile = fopen(kBondCachePath, "rb");
+    if (nullptr == pFile) {
+        return;
+    }
+
+    char magic[8];
+    uint32_t version = 0;
+    uint16_t ltkCount = 0;
+    uint16_t irkCount = 0;
+    if (1 != fread(magic, sizeof(magic), 1, pFile) || 0 != memcmp(magic, kBondCacheMagic, sizeof(magic)) ||
+        1 != fread(&version, sizeof(version), 1, pFile) || kBondCacheVersion != version ||
+        1 != fread(&ltkCount, sizeof(ltkCount), 1, pFile) || 1 != fread(&irkCount, sizeof(irkCount), 1, pFile)) {
+        Logger::warn(SSTR << "Ignoring malformed bond cache '" << kBondCachePath << "'");
+        fclose(pFile);
+        return;
+    }
+
+    longTermKeys.resize(ltkCount);
+    identityKeys.resize(irkCount);
+    if ((ltkCount != 0 && ltkCount != fread(longTermKeys.data(), sizeof(BondLongTermKey), ltkCount, pFile)) ||
+        (irkCount != 0 && irkCount != fread(identityKeys.data(), sizeof(BondIdentityKey), irkCount, pFile))) {
+        Logger::warn(SSTR << "Ignoring truncated bond cache '" << kBondCachePath << "'");
+        longTermKeys.clear();
+        identityKeys.clear();
+        fclose(pFile);
+        return;
+    }
+
+    fclose(pFile);
+    Logger::info(
+        SSTR << "Loaded bond cache: " << longTermKeys.size() << " long term key(s), " << identityKeys.size()
+             << " identity key(s)"
+    );
+}
+
+// Writes the cache to disk (callers hold `cacheMutex`)
+//
+// The file holds link keys, so it is created owner-read/write only - atomically, via open() with the mode, so the
+// key material is never readable by anyone else even for an instant.
+static void saveCache() {
+    int fd = open(kBondCachePath, O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        Logger::debug(SSTR << "Unable to write bond cache '" << kBondCachePath << "'");
+        return;
+    }
+
+    FILE *pFile = fdopen(fd, "wb");
+    if (nullptr == pFile) {
+        Logger::debug(SSTR << "Unable to write bond cache '" << kBondCachePath << "'");
+        close(fd);
+        return;
+    }
+
+    uint16_t ltkCount = static_cast<uint16_t>(longTermKeys.size());
+    uint16_t irkCount = static_cast<uint16_t>(identityKeys.size());
+    bool bOk = 1 == fwrite(kBondCacheMagic, sizeof(kBondCacheMagic), 1, pFile) &&
+               1 == fwrite(&kBondCacheVersion, sizeof(kBondCacheVersion), 1, pFile) &&
+               1 == fwrite(&ltkCount, sizeof(ltkCount), 1, pFile) && 1 == fwrite(&irkCount, sizeof(irkCount), 1, pFile);
+    if (bOk && 0 != ltkCount) {
+        bOk = ltkCount == fwrite(longTermKeys.data(), sizeof(BondLongTermKey), ltkCount, pFile);
+    }
+    if (bOk && 0 != irkCount) {
+        bOk = irkCount == fwrite(identityKeys.data(), sizeof(BondIdentityKey), irkCount, pFile);
+    }
+
+    fclose(pFile);
+
+    if (!bOk) {
+        Logger::debug(SSTR << "Unable to write bond cache '" << kBondCachePath << "'");
+    }
+}
+
+// Add (or refresh) the Long Term Key for a device, persisting the cache
+void BondCache::addLongTermKey(const BondLongTermKey &key) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    loadCache();
+
+    for (BondLongTermKey &existing : longTermKeys) {
+        if (sameDevice(existing.address, existing.addressType, key.address, key.addressType) &&
+            existing.master == key.master) {
+            existing = key;
+            saveCache();
+            return;
+        }
+    }
+
+    longTermKeys.push_back(key);
+    saveCache();
+}
+
+// Add (or refresh) the Identity Resolving Key for a device, persisting the cache
+void BondCache::addIdentityKey(const BondIdentityKey &key) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    loadCache();
+
+    for (BondIdentityKey &existing : identityKeys) {
+        if (sameDevice(existing.address, existing.addressType, key.address, key.addressType)) {
+            existing = key;
+            saveCache();
+            return;
+        }
+    }
+
+    identityKeys.push_back(key);
+    saveCache();
+}
+
+// Fill `keys` with every cached Long Term Key
+void BondCache::getLongTermKeys(std::vector<BondLongTermKey> &keys) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    loadCache();
+    keys = longTermKeys;
+}
+
+// Fill `keys` with every cached Identity Resolving Key
+void BondCache::getIdentityKeys(std::vector<BondIdentityKey> &keys) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    loadCache();
+    keys = identityKeys;
+}
+
+// Returns the number of bonded devices in the cache
+//
+// A device bonds with at most one identity key but may store two long term keys (one per role), so the identity
+// list is the better device count when present.
+size_t BondCache::deviceCount() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    loadCache();
+    return identityKeys.empty() ? longTermKeys.size() : identityKeys.size();
+}
+
+}; // namespace ggk
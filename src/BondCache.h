@@ -0,0 +1,77 @@
+// Copyright 2017-2019 Paul Nettle
+//
+// This file is part of Gobbledegook.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file in the root of the source tree.
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// >>
+// >>>  INSIDE THIS FILE
+// >>
+//
+// A persistent cache of bonded-device keys, so known devices reconnect fast instead of re-pairing
+//
+// >>
+// >>>  DISCUSSION
+// >>
+//
+// See the discussion at the top of BondCache.cpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+namespace ggk {
+
+// A Long Term Key for a bonded device
+//
+// The layout matches the key structure of the management API's Load Long Term Keys command, so cached keys can be
+// loaded back into the kernel verbatim.
+struct BondLongTermKey {
+    uint8_t address[6];
+    uint8_t addressType;
+    uint8_t keyType;
+    uint8_t master;
+    uint8_t encryptionSize;
+    uint16_t ediv;
+    uint64_t rand;
+    uint8_t value[16];
+} __attribute__((packed));
+
+// An Identity Resolving Key for a bonded device
+//
+// The layout matches the key structure of the management API's Load Identity Resolving Keys command.
+struct BondIdentityKey {
+    uint8_t address[6];
+    uint8_t addressType;
+    uint8_t value[16];
+} __attribute__((packed));
+
+// Our bonded-device cache
+//
+// Keys arrive on the HCI event thread as devices pair (see the New Long Term Key and New Identity Resolving Key
+// events in `HciAdapter::runEventThread`) and are persisted immediately; `Mgmt::loadBondedDevices` reads them back
+// at startup to program the controller's resolving and accept lists, which is what turns a multi-second
+// rediscovery into a sub-second reconnect.
+struct BondCache {
+    // Add (or refresh) the Long Term Key for a device, persisting the cache
+    static void addLongTermKey(const BondLongTermKey &key);
+
+    // Add (or refresh) the Identity Resolving Key for a device, persisting the cache
+    static void addIdentityKey(const BondIdentityKey &key);
+
+    // Fill `keys` with every cached Long Term Key
+    static void getLongTermKeys(std::vector<BondLongTermKey> &keys);
+
+    // Fill `keys` with every cached Identity Resolving Key
+    static void getIdentityKeys(std::vector<BondIdentityKey> &keys);
+
+    // Returns the number of bonded devices in the cache
+    static size_t deviceCount();
+};
+
+}; // namespace ggk
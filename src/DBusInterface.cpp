@@ -45,6 +45,9 @@
 // additional code on the server's part.
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
+#include <algorithm>
+#include <utility>
+
 #include "DBusInterface.h"
 #include "DBusObject.h"
 #include "GattProperty.h"
@@ -56,9 +59,9 @@ namespace ggk {
 // Construction
 //
 
-DBusInterface::DBusInterface(DBusObject &owner, const std::string &name) :
+DBusInterface::DBusInterface(DBusObject &owner, std::string name) :
     owner(owner),
-    name(name) {}
+    name(std::move(name)) {}
 
 DBusInterface::~DBusInterface() {}
 
@@ -72,8 +75,8 @@ const std::string &DBusInterface::getName() const {
 }
 
 // Sets the name of the interface (ex: "org.freedesktop.DBus.Properties")
-DBusInterface &DBusInterface::setName(const std::string &name) {
-    this->name = name;
+DBusInterface &DBusInterface::setName(std::string name) {
+    this->name = std::move(name);
     return *this;
 }
 
@@ -104,15 +107,86 @@ DBusObjectPath DBusInterface::getPath() const {
 //
 // This method returns a reference to `this` in order to enable chaining inside the server description.
 DBusInterface &DBusInterface::addMethod(
-    const std::string &name,
+    std::string name,
     const char *pInArgs[],
     const char *pOutArgs,
     DBusMethod::Callback callback
 ) {
-    methods.push_back(DBusMethod(this, name, pInArgs, pOutArgs, callback));
+    methods.emplace_back(this, std::move(name), pInArgs, pOutArgs, callback);
+
+    // If the dispatch table has already been built, it no longer covers the full method set - discard it so lookups
+    // fall back to scanning the list until `finalizeMethodDispatch` runs again
+    methodDispatch.clear();
+
     return *this;
 }
 
+// FNV-1a hash of a method name
+//
+// This is the integer key the dispatch table is sorted and searched by. Collisions are tolerated (see `findMethod`),
+// so the hash only needs to be fast and well-distributed, not perfect.
+uint32_t DBusInterface::hashMethodName(const std::string &methodName) {
+    uint32_t hash = 2166136261u;
+    for (char c : methodName) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+    }
+    return hash;
+}
+
+// Builds the flat method-dispatch table for this interface
+//
+// The method set of an interface is fixed once the server description is complete, so the server constructor calls
+// this once per interface after the object tree is final. From then on, `findMethod` resolves names with a binary
+// search over precomputed hashes instead of walking the method list comparing strings.
+void DBusInterface::finalizeMethodDispatch() {
+    methodDispatch.clear();
+    methodDispatch.reserve(methods.size());
+
+    for (const DBusMethod &method : methods) {
+        methodDispatch.push_back({hashMethodName(method.getName()), &method});
+    }
+
+    std::sort(
+        methodDispatch.begin(),
+        methodDispatch.end(),
+        [](const MethodDispatchEntry &a, const MethodDispatchEntry &b) { return a.nameHash < b.nameHash; }
+    );
+}
+
+// Locates a method on this interface by name, or nullptr if the interface has no such method
+//
+// Once the dispatch table has been built, this is a binary search on the name hash followed by a string compare on
+// the matching entry (a run of entries, should two method names ever collide on a 32-bit hash.) Before the table is
+// built - that is, while the server description is still under construction - we fall back to scanning the method
+// list the way this lookup always used to work.
+const DBusMethod *DBusInterface::findMethod(const std::string &methodName) const {
+    if (!methodDispatch.empty()) {
+        uint32_t nameHash = hashMethodName(methodName);
+        std::vector<MethodDispatchEntry>::const_iterator found = std::lower_bound(
+            methodDispatch.begin(),
+            methodDispatch.end(),
+            nameHash,
+            [](const MethodDispatchEntry &entry, uint32_t hash) { return entry.nameHash < hash; }
+        );
+
+        for (; found != methodDispatch.end() && found->nameHash == nameHash; ++found) {
+            if (methodName == found->pMethod->getName()) {
+                return found->pMethod;
+            }
+        }
+
+        return nullptr;
+    }
+
+    for (const DBusMethod &method : methods) {
+        if (methodName == method.getName()) {
+            return &method;
+        }
+    }
+
+    return nullptr;
+}
+
 // Calls a named method on this interface
 //
 // This method returns false if the method could not be found, otherwise it returns true. Note that the return value is
@@ -127,12 +201,10 @@ bool DBusInterface::callMethod(
     GDBusMethodInvocation *pInvocation,
     gpointer pUserData
 ) const {
-    for (const DBusMethod &method : methods) {
-        if (methodName == method.getName()) {
-            method.call<
-                DBusInterface>(pConnection, getPath(), getName(), methodName, pParameters, pInvocation, pUserData);
-            return true;
-        }
+    if (const DBusMethod *pMethod = findMethod(methodName)) {
+        pMethod
+            ->call<DBusInterface>(pConnection, getPath(), getName(), methodName, pParameters, pInvocation, pUserData);
+        return true;
     }
 
     return false;
@@ -152,18 +224,40 @@ DBusInterface &DBusInterface::onEvent(int tickFrequency, void *pUserData, TickEv
     return *this;
 }
 
-// Ticks each event within this interface
+// Add an event to this interface with its period given in milliseconds
 //
-// For details on events, see TickEvent.cpp.
+// This is the sub-second counterpart to `onEvent` - use it for things like high-rate telemetry where a one-second
+// period is too coarse.
 //
-// NOTE: Subclasses are encouraged to override this method in order to support different callback types that are
-// specific to their subclass type.
-void DBusInterface::tickEvents(GDBusConnection *pConnection, void *pUserData) const {
+// This method returns a reference to `this` in order to enable chaining inside the server description.
+//
+// NOTE: Subclasses are encouraged to overload this method for the same reasons as `onEvent`.
+DBusInterface &DBusInterface::onEventMS(int periodMS, void *pUserData, TickEvent::Callback callback) {
+    events.push_back(TickEvent(this, 0, callback, pUserData));
+    events.back().setPeriodMS(periodMS);
+    return *this;
+}
+
+// Appends (interface, event) pairs for each of this interface's events to `eventList`
+//
+// The tick scheduler in Init.cpp calls this (via `DBusObject::collectTickEvents`) once the application is registered,
+// building its min-heap schedule from the result. The pairs remain valid for the life of the server - events live in
+// a std::list and are never removed.
+void DBusInterface::collectTickEvents(std::vector<std::pair<const DBusInterface *, const TickEvent *>> &eventList
+) const {
     for (const TickEvent &event : events) {
-        event.tick<DBusInterface>(getPath(), pConnection, pUserData);
+        eventList.push_back(std::make_pair(this, &event));
     }
 }
 
+// Fires the given event (which must belong to this interface)
+//
+// NOTE: Subclasses are encouraged to override this method in order to support different callback types that are
+// specific to their subclass type.
+void DBusInterface::fireTickEvent(const TickEvent &event, GDBusConnection *pConnection, void *pUserData) const {
+    event.fire<DBusInterface>(getPath(), pConnection, pUserData);
+}
+
 // Internal method used to generate introspection XML used to describe our services on D-Bus
 std::string DBusInterface::generateIntrospectionXML(int depth) const {
     std::string prefix;
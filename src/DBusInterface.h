@@ -24,7 +24,10 @@
 
 #include <gio/gio.h>
 #include <list>
+#include <stdint.h>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "DBusMethod.h"
 #include "TickEvent.h"
@@ -83,7 +86,7 @@ struct DBusInterface {
     );
 
     // Standard constructor
-    DBusInterface(DBusObject &owner, const std::string &name);
+    DBusInterface(DBusObject &owner, std::string name);
     virtual ~DBusInterface();
 
     // Returns a string identifying the type of interface
@@ -96,7 +99,7 @@ struct DBusInterface {
     //
 
     const std::string &getName() const;
-    DBusInterface &setName(const std::string &name);
+    DBusInterface &setName(std::string name);
 
     //
     // Owner information
@@ -111,7 +114,21 @@ struct DBusInterface {
     //
 
     DBusInterface &
-    addMethod(const std::string &name, const char *pInArgs[], const char *pOutArgs, DBusMethod::Callback callback);
+    addMethod(std::string name, const char *pInArgs[], const char *pOutArgs, DBusMethod::Callback callback);
+
+    // Builds the flat method-dispatch table for this interface (see `findMethod`)
+    //
+    // Called once per interface by the server constructor after the object tree is final. The method set of an
+    // interface never changes after that point; should `addMethod` be called anyway, the table is discarded and
+    // lookups fall back to scanning the method list.
+    void finalizeMethodDispatch();
+
+    // Locates a method on this interface by name, or nullptr if the interface has no such method
+    //
+    // Once `finalizeMethodDispatch` has run, this is a binary search over a flat array of precomputed name hashes
+    // (integer compares, with a single string compare on the matching entry to guard against hash collisions.)
+    // Every GATT operation a client performs crosses this lookup, so it's worth keeping cheap.
+    const DBusMethod *findMethod(const std::string &methodName) const;
 
     // NOTE: Subclasses are encouraged to override this method in order to support different callback types that are
     // specific to their subclass type.
@@ -132,18 +149,42 @@ struct DBusInterface {
     // description by allowing calls to chain.
     DBusInterface &onEvent(int tickFrequency, void *pUserData, TickEvent::Callback callback);
 
+    // Same as `onEvent`, but with the period given in milliseconds for sub-second events
+    //
+    // NOTE: Subclasses are encouraged to overload this method for the same reasons as `onEvent`.
+    DBusInterface &onEventMS(int periodMS, void *pUserData, TickEvent::Callback callback);
+
+    // Appends (interface, event) pairs for each of this interface's events to `eventList` (used by the tick scheduler
+    // in Init.cpp to build its schedule)
+    void collectTickEvents(std::vector<std::pair<const DBusInterface *, const TickEvent *>> &eventList) const;
+
+    // Fires the given event (which must belong to this interface)
+    //
     // NOTE: Subclasses are encouraged to override this method in order to support different callback types that are
     // specific to their subclass type.
-    virtual void tickEvents(GDBusConnection *pConnection, void *pUserData) const;
+    virtual void fireTickEvent(const TickEvent &event, GDBusConnection *pConnection, void *pUserData) const;
 
     // Internal method used to generate introspection XML used to describe our services on D-Bus
     virtual std::string generateIntrospectionXML(int depth) const;
 
 protected:
+    // One row of the flat dispatch table: a method's name hash and a pointer to the method itself (methods live in
+    // a std::list, so the pointers are stable)
+    struct MethodDispatchEntry {
+        uint32_t nameHash;
+        const DBusMethod *pMethod;
+    };
+
+    // FNV-1a hash of a method name - the integer key the dispatch table is sorted and searched by
+    static uint32_t hashMethodName(const std::string &methodName);
+
     DBusObject &owner;
     std::string name;
     std::list<DBusMethod> methods;
     std::list<TickEvent> events;
+
+    // The flat dispatch table, sorted by name hash (empty until `finalizeMethodDispatch` runs)
+    std::vector<MethodDispatchEntry> methodDispatch;
 };
 
 }; // namespace ggk
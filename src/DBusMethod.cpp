@@ -26,6 +26,7 @@
 
 #include <gio/gio.h>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "DBusMethod.h"
@@ -35,18 +36,23 @@ namespace ggk {
 // Instantiate a named method on a given interface (pOwner) with a given set of arguments and a callback delegate
 DBusMethod::DBusMethod(
     const DBusInterface *pOwner,
-    const std::string &name,
+    std::string name,
     const char *pInArgs[],
     const char *pOutArgs,
     Callback callback
 ) :
     pOwner(pOwner),
-    name(name),
+    name(std::move(name)),
     callback(callback) {
-    const char **ppInArg = pInArgs;
-    while (*ppInArg) {
-        this->inArgs.push_back(std::string(*ppInArg));
-        ppInArg++;
+    // Size the argument list up front - these lists are tiny, but there's no reason to let the vector grow in steps
+    size_t inArgCount = 0;
+    while (pInArgs[inArgCount]) {
+        ++inArgCount;
+    }
+    this->inArgs.reserve(inArgCount);
+
+    for (size_t i = 0; i < inArgCount; ++i) {
+        this->inArgs.emplace_back(pInArgs[i]);
     }
 
     if (nullptr != pOutArgs) {
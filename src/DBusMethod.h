@@ -30,6 +30,7 @@
 
 #include <gio/gio.h>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "DBusObjectPath.h"
@@ -55,7 +56,7 @@ struct DBusMethod {
     // Instantiate a named method on a given interface (pOwner) with a given set of arguments and a callback delegate
     DBusMethod(
         const DBusInterface *pOwner,
-        const std::string &name,
+        std::string name,
         const char *pInArgs[],
         const char *pOutArgs,
         Callback callback
@@ -73,8 +74,8 @@ struct DBusMethod {
     // Sets the name of the method
     //
     // This method should generally not be called directly. Rather, the name should be set by the constructor
-    DBusMethod &setName(const std::string &name) {
-        this->name = name;
+    DBusMethod &setName(std::string name) {
+        this->name = std::move(name);
         return *this;
     }
 
@@ -91,9 +92,9 @@ struct DBusMethod {
     // Set the argument types for this method
     //
     // This method should generally not be called directly. Rather, the arguments should be set by the constructor
-    DBusMethod &setArgs(const std::vector<std::string> &inArgs, const std::string &outArgs) {
-        this->inArgs = inArgs;
-        this->outArgs = outArgs;
+    DBusMethod &setArgs(std::vector<std::string> inArgs, std::string outArgs) {
+        this->inArgs = std::move(inArgs);
+        this->outArgs = std::move(outArgs);
         return *this;
     }
 
@@ -51,17 +51,17 @@ namespace ggk {
 // Construct a root object with no parent
 //
 // We'll include a publish flag since only root objects can be published
-DBusObject::DBusObject(const DBusObjectPath &path, bool publish) :
+DBusObject::DBusObject(DBusObjectPath path, bool publish) :
     publish(publish),
-    path(path),
+    path(std::move(path)),
     pParent(nullptr) {}
 
 // Construct a node object
 //
 // Nodes inherit their parent's publish path
-DBusObject::DBusObject(DBusObject *pParent, const DBusObjectPath &pathElement) :
+DBusObject::DBusObject(DBusObject *pParent, DBusObjectPath pathElement) :
     publish(pParent->publish),
-    path(pathElement),
+    path(std::move(pathElement)),
     pParent(pParent) {}
 
 //
@@ -107,8 +107,9 @@ const std::list<DBusObject> &DBusObject::getChildren() const {
 }
 
 // Add a child to this object
-DBusObject &DBusObject::addChild(const DBusObjectPath &pathElement) {
-    children.push_back(DBusObject(this, pathElement));
+DBusObject &DBusObject::addChild(DBusObjectPath pathElement) {
+    invalidateIntrospectionCache();
+    children.emplace_back(this, std::move(pathElement));
     return children.back();
 }
 
@@ -121,8 +122,8 @@ const DBusObject::InterfaceList &DBusObject::getInterfaces() const {
 //
 // We simply add a new child at the given path and add an interface configured as a GATT service to it using the given
 // UUID.
-GattService &DBusObject::gattServiceBegin(const std::string &pathElement, const GattUuid &uuid) {
-    DBusObject &child = addChild(DBusObjectPath(pathElement));
+GattService &DBusObject::gattServiceBegin(std::string pathElement, const GattUuid &uuid) {
+    DBusObject &child = addChild(DBusObjectPath(std::move(pathElement)));
     GattService &service = *child.addInterface(std::make_shared<GattService>(child, "org.bluez.GattService1"));
     service.addProperty<GattService>("UUID", uuid);
     service.addProperty<GattService>("Primary", true);
@@ -195,14 +196,14 @@ bool DBusObject::callMethod(
     return false;
 }
 
-// Periodic timer tick propagation
-void DBusObject::tickEvents(GDBusConnection *pConnection, void *pUserData) const {
+// Tick event collection (see the tick scheduler in Init.cpp)
+void DBusObject::collectTickEvents(std::vector<std::pair<const DBusInterface *, const TickEvent *>> &eventList) const {
     for (std::shared_ptr<const DBusInterface> interface : interfaces) {
-        interface->tickEvents(pConnection, pUserData);
+        interface->collectTickEvents(eventList);
     }
 
     for (const DBusObject &child : getChildren()) {
-        child.tickEvents(pConnection, pUserData);
+        child.collectTickEvents(eventList);
     }
 }
 
@@ -211,7 +212,16 @@ void DBusObject::tickEvents(GDBusConnection *pConnection, void *pUserData) const
 // ---------------------------------------------------------------------------------------------------------------------------------
 
 // Internal method used to generate introspection XML used to describe our services on D-Bus
+//
+// The result is cached on first build: the tree is immutable once the server is constructed, while clients
+// introspect on every connect. The cache lives at whatever depth the caller starts generation from (in practice, the
+// root of each registered object) and is invalidated by the tree mutators (see `invalidateIntrospectionCache`.)
 std::string DBusObject::generateIntrospectionXML(int depth) const {
+    // Serve from the cache if we've built this before
+    if (!introspectionXMLCache.empty()) {
+        return introspectionXMLCache;
+    }
+
     std::string prefix;
     prefix.insert(0, depth * 2, ' ');
 
@@ -231,7 +241,7 @@ std::string DBusObject::generateIntrospectionXML(int depth) const {
         xml += interface->generateIntrospectionXML(depth + 1);
     }
 
-    for (DBusObject child : getChildren()) {
+    for (const DBusObject &child : getChildren()) {
         xml += child.generateIntrospectionXML(depth + 1);
     }
 
@@ -242,9 +252,22 @@ std::string DBusObject::generateIntrospectionXML(int depth) const {
         Logger::debug(xml);
     }
 
+    introspectionXMLCache = xml;
+
     return xml;
 }
 
+// Discard any cached introspection XML for this object and its ancestors
+//
+// Ancestors embed our XML in theirs, so changing this object stales every cache on the path up to the root
+void DBusObject::invalidateIntrospectionCache() {
+    introspectionXMLCache.clear();
+
+    for (DBusObject *pCurrent = pParent; nullptr != pCurrent; pCurrent = pCurrent->pParent) {
+        pCurrent->introspectionXMLCache.clear();
+    }
+}
+
 // ---------------------------------------------------------------------------------------------------------------------------------
 // D-Bus signals
 // ---------------------------------------------------------------------------------------------------------------------------------
@@ -26,6 +26,8 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "DBusObjectPath.h"
 
@@ -35,6 +37,7 @@ struct GattProperty;
 struct GattService;
 struct GattUuid;
 struct DBusInterface;
+struct TickEvent;
 
 struct DBusObject {
     // A convenience typedef for describing our list of interface
@@ -43,12 +46,12 @@ struct DBusObject {
     // Construct a root object with no parent
     //
     // We'll include a publish flag since only root objects can be published
-    DBusObject(const DBusObjectPath &path, bool publish = true);
+    DBusObject(DBusObjectPath path, bool publish = true);
 
     // Construct a node object
     //
     // Nodes inherit their parent's publish path
-    DBusObject(DBusObject *pParent, const DBusObjectPath &pathElement);
+    DBusObject(DBusObject *pParent, DBusObjectPath pathElement);
 
     //
     // Accessors
@@ -74,27 +77,37 @@ struct DBusObject {
     const std::list<DBusObject> &getChildren() const;
 
     // Add a child to this object
-    DBusObject &addChild(const DBusObjectPath &pathElement);
+    DBusObject &addChild(DBusObjectPath pathElement);
 
     // Returns a list of interfaces for this object
     const InterfaceList &getInterfaces() const;
 
     // Templated method for adding typed interfaces to the object
     template <typename T> std::shared_ptr<T> addInterface(std::shared_ptr<T> interface) {
-        interfaces.push_back(interface);
+        invalidateIntrospectionCache();
+        interfaces.push_back(std::move(interface));
         return std::static_pointer_cast<T>(interfaces.back());
     }
 
     // Internal method used to generate introspection XML used to describe our services on D-Bus
+    //
+    // The generated XML is cached on first build (the tree is immutable once the server is constructed, and clients
+    // introspect on every connect.) Mutating the tree via `addChild` or `addInterface` invalidates the cache.
     std::string generateIntrospectionXML(int depth = 0) const;
 
+    // Discard any cached introspection XML for this object and its ancestors
+    //
+    // Called automatically by the tree mutators (`addChild`, `addInterface`); only needed directly if an interface is
+    // altered in place after it has been added.
+    void invalidateIntrospectionCache();
+
     // Convenience functions to add a GATT service to the hierarchy
     //
     // We simply add a new child at the given path and add an interface configured as a GATT service to it using the
     // given UUID.
     //
     // To end a service, call `gattServiceEnd()`
-    GattService &gattServiceBegin(const std::string &pathElement, const GattUuid &uuid);
+    GattService &gattServiceBegin(std::string pathElement, const GattUuid &uuid);
 
     //
     // Helpful routines for searching objects
@@ -119,8 +132,9 @@ struct DBusObject {
         const DBusObjectPath &basePath = DBusObjectPath()
     ) const;
 
-    // Periodic timer tick propagation
-    void tickEvents(GDBusConnection *pConnection, void *pUserData = nullptr) const;
+    // Appends (interface, event) pairs for every tick event in this object and its children to `eventList` (used by
+    // the tick scheduler in Init.cpp to build its schedule)
+    void collectTickEvents(std::vector<std::pair<const DBusInterface *, const TickEvent *>> &eventList) const;
 
     // -----------------------------------------------------------------------------------------------------------------------------
     // D-Bus signals
@@ -141,6 +155,10 @@ private:
     InterfaceList interfaces;
     std::list<DBusObject> children;
     DBusObject *pParent;
+
+    // The introspection XML cached by `generateIntrospectionXML` (empty = not generated yet.) Mutable because
+    // generation is logically const - the cache is pure memoization.
+    mutable std::string introspectionXMLCache;
 };
 
 }; // namespace ggk
@@ -28,6 +28,7 @@
 
 #include <ostream>
 #include <string>
+#include <utility>
 
 namespace ggk {
 
@@ -41,6 +42,10 @@ struct DBusObjectPath {
     inline DBusObjectPath(const DBusObjectPath &path) :
         path(path.path) {}
 
+    // Move constructor
+    inline DBusObjectPath(DBusObjectPath &&path) :
+        path(std::move(path.path)) {}
+
     // Constructor that accepts a C string
     //
     // Note: explicit because we don't want accidental conversion. Creating a DBusObjectPath must be intentional.
@@ -53,6 +58,12 @@ struct DBusObjectPath {
     inline explicit DBusObjectPath(const std::string &path) :
         path(path) {}
 
+    // Constructor that adopts an rvalue std::string without copying it
+    //
+    // Note: explicit because we don't want accidental conversion. Creating a DBusObjectPath must be intentional.
+    inline explicit DBusObjectPath(std::string &&path) :
+        path(std::move(path)) {}
+
     // Explicit conversion to std::string
     inline const std::string &toString() const {
         return path;
@@ -72,6 +83,15 @@ struct DBusObjectPath {
         return *this;
     }
 
+    // Move assignment
+    inline DBusObjectPath &operator=(DBusObjectPath &&rhs) {
+        if (this == &rhs) {
+            return *this;
+        }
+        path = std::move(rhs.path);
+        return *this;
+    }
+
     // Concatenation
     inline const DBusObjectPath &append(const char *rhs) {
         if (nullptr == rhs || !*rhs) {
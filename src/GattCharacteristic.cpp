@@ -22,17 +22,40 @@
 // the detailed discussion in Server.cpp.
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
+#include <errno.h>
+#include <gio/gunixfdlist.h>
+#include <glib-unix.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
 #include "GattCharacteristic.h"
 #include "DBusObject.h"
 #include "GattDescriptor.h"
 #include "GattProperty.h"
 #include "GattService.h"
 #include "GattUuid.h"
+#include "Globals.h"
 #include "Logger.h"
+#include "MethodWorker.h"
 #include "Utils.h"
 
 namespace ggk {
 
+// Our one and only D-Bus connection (owned by Init.cpp) - the acquired-write path needs it to invoke callbacks
+extern GDBusConnection *pBusConnection;
+
+// The default ATT MTU, used if a client doesn't offer one when acquiring a notification fd
+static const uint16_t kDefaultMtu = 23;
+
+// The size of the ATT notification header - the usable payload per notification is the MTU less this
+static const uint16_t kAttNotifyHeaderSize = 3;
+
+// The largest possible ATT payload (maximum ATT MTU less the write header) - sizes the receive buffer for acquired
+// writes
+static const size_t kMaxAttPayloadSize = 517;
+
 //
 // Standard constructor
 //
@@ -41,10 +64,20 @@ namespace ggk {
 //
 // Genreally speaking, these objects should not be constructed directly. Rather, use the `gattCharacteristicBegin()`
 // method in `GattService`.
-GattCharacteristic::GattCharacteristic(DBusObject &owner, GattService &service, const std::string &name) :
-    GattInterface(owner, name),
+GattCharacteristic::GattCharacteristic(DBusObject &owner, GattService &service, std::string name) :
+    GattInterface(owner, std::move(name)),
     service(service),
-    pOnUpdatedValueFunc(nullptr) {}
+    pOnUpdatedValueFunc(nullptr),
+    pOnAcquiredWriteFunc(nullptr),
+    notifyFd(-1),
+    notifyMtu(0),
+    writeFd(-1),
+    writeWatchId(0),
+    writeMtu(0),
+    bTrackSubscriptions(false),
+    notifySessions(0),
+    bBatchNotifies(false),
+    notifyBatchIdleId(0) {}
 
 // Returning the owner pops us one level up the hierarchy
 //
@@ -61,12 +94,10 @@ bool GattCharacteristic::callMethod(
     GDBusMethodInvocation *pInvocation,
     gpointer pUserData
 ) const {
-    for (const DBusMethod &method : methods) {
-        if (methodName == method.getName()) {
-            method.call<
-                GattCharacteristic>(pConnection, getPath(), getName(), methodName, pParameters, pInvocation, pUserData);
-            return true;
-        }
+    if (const DBusMethod *pMethod = findMethod(methodName)) {
+        pMethod->call<
+            GattCharacteristic>(pConnection, getPath(), getName(), methodName, pParameters, pInvocation, pUserData);
+        return true;
     }
 
     return false;
@@ -83,14 +114,20 @@ GattCharacteristic &GattCharacteristic::onEvent(int tickFrequency, void *pUserDa
     return *this;
 }
 
-// Ticks events within this characteristic
+// Adds an event with a millisecond period to the characteristic and returns a refereence to 'this` to enable method
+// chaining in the server description (see `onEvent` for details on the overload/chaining conventions)
+GattCharacteristic &GattCharacteristic::onEventMS(int periodMS, void *pUserData, EventCallback callback) {
+    events.push_back(TickEvent(this, 0, reinterpret_cast<TickEvent::Callback>(callback), pUserData));
+    events.back().setPeriodMS(periodMS);
+    return *this;
+}
+
+// Fires the given event (which must belong to this characteristic)
 //
 // Note: we specifically override this method in order to translate the generic TickEvent::Callback into our own
 // EventCallback
-void GattCharacteristic::tickEvents(GDBusConnection *pConnection, void *pUserData) const {
-    for (const TickEvent &event : events) {
-        event.tick<GattCharacteristic>(getPath(), pConnection, pUserData);
-    }
+void GattCharacteristic::fireTickEvent(const TickEvent &event, GDBusConnection *pConnection, void *pUserData) const {
+    event.fire<GattCharacteristic>(getPath(), pConnection, pUserData);
 }
 
 // Specialized support for ReadlValue method
@@ -123,6 +160,642 @@ GattCharacteristic &GattCharacteristic::onWriteValue(MethodCallback callback) {
     return *this;
 }
 
+// The D-Bus error BlueZ maps back to an ATT "Invalid Offset" response
+static const char kErrorInvalidOffset[] = "org.bluez.Error.InvalidOffset";
+
+// Extracts the "offset" option from a method's options dict (`childIndex` selects which input argument holds the
+// dict - 0 for ReadValue, 1 for WriteValue.) Returns 0 when no offset was passed.
+static guint16 offsetFromOptions(GVariant *pParameters, int childIndex) {
+    guint16 offset = 0;
+    GVariant *pOptions = g_variant_get_child_value(pParameters, childIndex);
+    if (nullptr != pOptions) {
+        GVariant *pOffsetValue = g_variant_lookup_value(pOptions, "offset", G_VARIANT_TYPE_UINT16);
+        if (nullptr != pOffsetValue) {
+            offset = g_variant_get_uint16(pOffsetValue);
+            g_variant_unref(pOffsetValue);
+        }
+        g_variant_unref(pOptions);
+    }
+
+    return offset;
+}
+
+// Returns the "offset" option from ReadValue parameters (0 when no offset was passed)
+guint16 GattCharacteristic::readValueOffset(GVariant *pParameters) {
+    return offsetFromOptions(pParameters, 0);
+}
+
+// Returns the "offset" option from WriteValue parameters (0 when no offset was passed)
+guint16 GattCharacteristic::writeValueOffset(GVariant *pParameters) {
+    return offsetFromOptions(pParameters, 1);
+}
+
+// Returns true if the WriteValue parameters carry "type": "command" - BlueZ's mapping of an ATT Write Command
+// (write-without-response)
+bool GattCharacteristic::writeValueIsCommand(GVariant *pParameters) {
+    bool bIsCommand = false;
+    GVariant *pOptions = g_variant_get_child_value(pParameters, 1);
+    if (nullptr != pOptions) {
+        GVariant *pTypeValue = g_variant_lookup_value(pOptions, "type", G_VARIANT_TYPE_STRING);
+        if (nullptr != pTypeValue) {
+            bIsCommand = 0 == strcmp(g_variant_get_string(pTypeValue, nullptr), "command");
+            g_variant_unref(pTypeValue);
+        }
+        g_variant_unref(pOptions);
+    }
+
+    return bIsCommand;
+}
+
+// Completes a WriteValue invocation, routing write-without-response commands through a reply-free fast path (see the
+// header for the full story)
+void GattCharacteristic::methodCompleteWrite(
+    GDBusConnection *pConnection,
+    GVariant *pParameters,
+    GDBusMethodInvocation *pInvocation,
+    void *pUserData
+) const {
+    if (writeValueIsCommand(pParameters)) {
+        // Coalesce the post-write work through the update queue - back-to-back command packets for the same
+        // characteristic collapse into a single delegate pass on the next dispatch
+        ggkNofifyUpdatedCharacteristic(getPath().toString().c_str());
+
+        // Nothing is waiting on a reply (the message is flagged no-reply-expected), so complete the invocation with
+        // no return value at all - GDBus sends nothing on the bus for it
+        g_dbus_method_invocation_return_value(pInvocation, nullptr);
+        return;
+    }
+
+    callOnUpdatedValue(pConnection, pUserData);
+    methodReturnVariant(pInvocation, NULL);
+}
+
+// Binds (or, with an empty path, unbinds) this characteristic's value to the file at `path` (see the header)
+void GattCharacteristic::bindValueFile(const std::string &path) const {
+    valueFile.bind(path);
+}
+
+// Returns the current mapping of the bound value file, or nullptr if none is bound or it cannot be mapped
+std::shared_ptr<const FileMapping> GattCharacteristic::acquireValueFile() const {
+    return valueFile.acquire();
+}
+
+// The destroy notify for reply variants built over a file mapping - drops the pin keeping the pages mapped
+static void releaseFileMappingPin(gpointer pUserData) {
+    delete static_cast<std::shared_ptr<const FileMapping> *>(pUserData);
+}
+
+// Serves a read segment zero-copy from the bound value file, if there is one (see the header)
+bool GattCharacteristic::methodReturnMappedReadSegment(GDBusMethodInvocation *pInvocation, GVariant *pParameters)
+    const {
+    std::shared_ptr<const FileMapping> pMapping = valueFile.acquire();
+    if (nullptr == pMapping) {
+        return false;
+    }
+
+    guint16 offset = readValueOffset(pParameters);
+    if (offset > pMapping->count) {
+        g_dbus_method_invocation_return_dbus_error(
+            pInvocation,
+            kErrorInvalidOffset,
+            "Read offset is past the end of the value"
+        );
+        return true;
+    }
+
+    // The variant references the mapped pages directly - no copy into the reply - and holds a pin on the mapping,
+    // so a file replacement mid-serialization can't pull the pages out from under GDBus
+    GVariant *pVariant = g_variant_new_from_data(
+        G_VARIANT_TYPE("ay"),
+        pMapping->pData + offset,
+        pMapping->count - offset,
+        TRUE,
+        releaseFileMappingPin,
+        new std::shared_ptr<const FileMapping>(pMapping)
+    );
+
+    methodReturnVariant(pInvocation, pVariant, true);
+    return true;
+}
+
+// Serves a long-read segment from the snapshot taken at offset 0, if there is one to serve from (see the header for
+// the intended read-callback pattern)
+bool GattCharacteristic::methodReturnCachedReadSegment(GDBusMethodInvocation *pInvocation, GVariant *pParameters)
+    const {
+    guint16 offset = readValueOffset(pParameters);
+    if (0 == offset || longReadCache.empty()) {
+        return false;
+    }
+
+    if (offset > longReadCache.size()) {
+        g_dbus_method_invocation_return_dbus_error(
+            pInvocation,
+            kErrorInvalidOffset,
+            "Read offset is past the end of the value"
+        );
+        return true;
+    }
+
+    methodReturnVariant(
+        pInvocation,
+        Utils::gvariantFromByteArray(
+            longReadCache.data() + offset,
+            static_cast<int>(longReadCache.size() - offset)
+        ),
+        true
+    );
+    return true;
+}
+
+// Answers a ReadValue invocation with the requested segment of the given value
+//
+// At offset 0 (a fresh read) the value is snapshotted first - every later segment of this logical read is then served
+// out of the snapshot by `methodReturnCachedReadSegment`, so the client sees one consistent value even if the
+// underlying data changes mid-read.
+void GattCharacteristic::methodReturnReadSegment(
+    GDBusMethodInvocation *pInvocation,
+    GVariant *pParameters,
+    const guint8 *pData,
+    size_t count
+) const {
+    guint16 offset = readValueOffset(pParameters);
+
+    if (0 == offset) {
+        longReadCache.assign(pData, pData + count);
+    }
+
+    if (offset > count) {
+        g_dbus_method_invocation_return_dbus_error(
+            pInvocation,
+            kErrorInvalidOffset,
+            "Read offset is past the end of the value"
+        );
+        return;
+    }
+
+    methodReturnVariant(
+        pInvocation,
+        Utils::gvariantFromByteArray(pData + offset, static_cast<int>(count - offset)),
+        true
+    );
+}
+
+// The captured state of a deferred read, passed between the worker pool and the main loop (see
+// `methodReturnReadAsync`)
+struct AsyncReadContext {
+    const GattCharacteristic *pSelf;
+    GDBusMethodInvocation *pInvocation;
+    GVariant *pParameters;
+    GattCharacteristic::AsyncValueGetter getter;
+    void *pUserData;
+    std::vector<guint8> value;
+};
+
+// The completion half of a deferred read - back on the main loop, answer the invocation
+static void onAsyncReadComplete(void *pUserData) {
+    AsyncReadContext *pContext = static_cast<AsyncReadContext *>(pUserData);
+    pContext->pSelf->methodReturnReadSegment(
+        pContext->pInvocation,
+        pContext->pParameters,
+        pContext->value.data(),
+        pContext->value.size()
+    );
+
+    g_variant_unref(pContext->pParameters);
+    delete pContext;
+}
+
+// The worker half of a deferred read - run the (possibly slow) value getter off the main loop
+static void onAsyncReadWork(void *pUserData) {
+    AsyncReadContext *pContext = static_cast<AsyncReadContext *>(pUserData);
+    pContext->value = pContext->getter(*pContext->pSelf, pContext->pUserData);
+    MethodWorker::postToMainLoop(onAsyncReadComplete, pUserData);
+}
+
+// Answers a ReadValue invocation asynchronously, so a slow value getter doesn't stall the main loop
+//
+// GDBus is happy for an invocation to be answered after the handler returns - the client just waits - so we capture
+// it (along with a reference on the parameters, which GDBus releases when the handler returns) and return
+// immediately. The reply runs back on the main loop via `methodReturnReadSegment`, keeping the long-read snapshot
+// main-loop-only; nothing of this characteristic is touched from the worker beyond what `getter` itself does.
+void GattCharacteristic::methodReturnReadAsync(
+    GDBusMethodInvocation *pInvocation,
+    GVariant *pParameters,
+    AsyncValueGetter getter,
+    void *pUserData
+) const {
+    AsyncReadContext *pContext = new AsyncReadContext{this, pInvocation, g_variant_ref(pParameters), getter, pUserData, {}};
+
+    if (!MethodWorker::post(onAsyncReadWork, pContext)) {
+        // The pool is shutting down - answer inline rather than dropping the invocation
+        g_variant_unref(pContext->pParameters);
+        delete pContext;
+
+        const std::vector<guint8> value = getter(*this, pUserData);
+        methodReturnReadSegment(pInvocation, pParameters, value.data(), value.size());
+    }
+}
+
+// Merges a WriteValue segment into the reassembly buffer at the offset the parameters carry, returning the assembled
+// value so far
+//
+// An unsegmented write (offset 0) simply replaces the buffer, so the common case costs one copy. Segments beyond the
+// current end grow the buffer (zero-filled if the client leaves a gap, which a sane client never does.)
+const std::vector<guint8> &GattCharacteristic::assembleWriteSegment(GVariant *pParameters) const {
+    guint16 offset = writeValueOffset(pParameters);
+
+    GVariant *pAyBuffer = g_variant_get_child_value(pParameters, 0);
+    gsize count = 0;
+    const guint8 *pData = static_cast<const guint8 *>(g_variant_get_fixed_array(pAyBuffer, &count, sizeof(guint8)));
+
+    if (0 == offset) {
+        longWriteBuffer.assign(pData, pData + count);
+    } else {
+        if (longWriteBuffer.size() < offset + count) {
+            longWriteBuffer.resize(offset + count, 0);
+        }
+
+        memcpy(longWriteBuffer.data() + offset, pData, count);
+    }
+
+    g_variant_unref(pAyBuffer);
+    return longWriteBuffer;
+}
+
+// Specialized support for the AcquireNotify method (BlueZ fd-based notifications)
+//
+// Defined as: (fd, MTU) AcquireNotify(dict options)
+//
+// D-Bus breakdown:
+//
+//     Input args:  options - "a{sv}"
+//     Output args: fd      - "h"
+//                  mtu     - "q"
+//
+// The handler creates a non-blocking SEQPACKET socket pair, hands one end back to BlueZ (which forwards raw
+// notification payloads from it to the subscribed client), and keeps the other end on this characteristic for
+// `sendChangeNotificationValue` to write to. BlueZ only offers AcquireNotify for characteristics exposing the
+// `NotifyAcquired` property, so we add that here as well.
+GattCharacteristic &GattCharacteristic::enableAcquireNotify() {
+    addProperty<GattCharacteristic>("NotifyAcquired", false);
+
+    MethodCallback acquireFunc = [](const GattCharacteristic &self,
+                                    GDBusConnection * /*pConnection*/,
+                                    const std::string & /*methodName*/,
+                                    GVariant *pParameters,
+                                    GDBusMethodInvocation *pInvocation,
+                                    void * /*pUserData*/) {
+        // A re-acquisition (say, after a client reconnect) replaces any previous fd
+        self.releaseNotifyFd();
+
+        // Use the MTU negotiated for the connection, if BlueZ passed one along
+        guint16 mtu = kDefaultMtu;
+        GVariant *pOptions = g_variant_get_child_value(pParameters, 0);
+        if (nullptr != pOptions) {
+            GVariant *pMtuValue = g_variant_lookup_value(pOptions, "mtu", G_VARIANT_TYPE_UINT16);
+            if (nullptr != pMtuValue) {
+                mtu = g_variant_get_uint16(pMtuValue);
+                g_variant_unref(pMtuValue);
+            }
+            g_variant_unref(pOptions);
+        }
+
+        // SEQPACKET preserves our write boundaries as notification boundaries; non-blocking so a slow client can
+        // never stall the main loop
+        int fds[2];
+        if (socketpair(AF_LOCAL, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, fds) < 0) {
+            Logger::error(SSTR << "AcquireNotify: socketpair failed: " << strerror(errno));
+            g_dbus_method_invocation_return_dbus_error(
+                pInvocation,
+                kErrorFailed.c_str(),
+                "Unable to allocate a notification channel"
+            );
+            return;
+        }
+
+        // Hand BlueZ's end over via an fd list (the list keeps its own duplicate)
+        GError *pError = nullptr;
+        GUnixFDList *pFdList = g_unix_fd_list_new();
+        gint handle = g_unix_fd_list_append(pFdList, fds[1], &pError);
+        close(fds[1]);
+        if (handle < 0) {
+            Logger::error(
+                SSTR << "AcquireNotify: unable to append fd: " << (nullptr == pError ? "Unknown" : pError->message)
+            );
+            close(fds[0]);
+            g_object_unref(pFdList);
+            g_dbus_method_invocation_return_dbus_error(
+                pInvocation,
+                kErrorFailed.c_str(),
+                "Unable to transfer the notification fd"
+            );
+            return;
+        }
+
+        self.notifyFd = fds[0];
+        self.notifyMtu = mtu;
+
+        Logger::info(SSTR << "Notification fd acquired for '" << self.getPath() << "' (MTU " << mtu << ")");
+        g_dbus_method_invocation_return_value_with_unix_fd_list(
+            pInvocation,
+            g_variant_new("(hq)", handle, mtu),
+            pFdList
+        );
+        g_object_unref(pFdList);
+    };
+
+    static const char *inArgs[] = {"a{sv}", nullptr};
+    addMethod("AcquireNotify", inArgs, "hq", reinterpret_cast<DBusMethod::Callback>(acquireFunc));
+    return *this;
+}
+
+// Main-loop watch callback for an acquired write fd (see `enableAcquireWrite`)
+static gboolean onAcquiredWriteReady(gint fd, GIOCondition condition, gpointer pUserData) {
+    const GattCharacteristic *pCharacteristic = static_cast<const GattCharacteristic *>(pUserData);
+    return pCharacteristic->handleAcquiredWriteReady(fd, condition) ? G_SOURCE_CONTINUE : G_SOURCE_REMOVE;
+}
+
+// Specialized support for the AcquireWrite method (BlueZ fd-based inbound writes)
+//
+// Defined as: (fd, MTU) AcquireWrite(dict options)
+//
+// D-Bus breakdown:
+//
+//     Input args:  options - "a{sv}"
+//     Output args: fd      - "h"
+//                  mtu     - "q"
+//
+// The handler creates a non-blocking SEQPACKET socket pair and hands one end back to BlueZ, which then forwards each
+// client write as one packet on the socket - no per-chunk D-Bus method call or GVariant unpacking. We watch our end on
+// the main loop and invoke `callback` once per received packet. BlueZ only offers AcquireWrite for characteristics
+// exposing the `WriteAcquired` property, so we add that here as well.
+GattCharacteristic &GattCharacteristic::enableAcquireWrite(AcquiredWriteCallback callback) {
+    pOnAcquiredWriteFunc = callback;
+    addProperty<GattCharacteristic>("WriteAcquired", false);
+
+    MethodCallback acquireFunc = [](const GattCharacteristic &self,
+                                    GDBusConnection * /*pConnection*/,
+                                    const std::string & /*methodName*/,
+                                    GVariant *pParameters,
+                                    GDBusMethodInvocation *pInvocation,
+                                    void * /*pUserData*/) {
+        // A re-acquisition (say, after a client reconnect) replaces any previous fd
+        self.releaseWriteFd();
+
+        // Use the MTU negotiated for the connection, if BlueZ passed one along
+        guint16 mtu = kDefaultMtu;
+        GVariant *pOptions = g_variant_get_child_value(pParameters, 0);
+        if (nullptr != pOptions) {
+            GVariant *pMtuValue = g_variant_lookup_value(pOptions, "mtu", G_VARIANT_TYPE_UINT16);
+            if (nullptr != pMtuValue) {
+                mtu = g_variant_get_uint16(pMtuValue);
+                g_variant_unref(pMtuValue);
+            }
+            g_variant_unref(pOptions);
+        }
+
+        // SEQPACKET preserves BlueZ's packet boundaries as write boundaries; non-blocking so the main loop can drain
+        // without ever stalling
+        int fds[2];
+        if (socketpair(AF_LOCAL, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, fds) < 0) {
+            Logger::error(SSTR << "AcquireWrite: socketpair failed: " << strerror(errno));
+            g_dbus_method_invocation_return_dbus_error(
+                pInvocation,
+                kErrorFailed.c_str(),
+                "Unable to allocate a write channel"
+            );
+            return;
+        }
+
+        // Hand BlueZ's end over via an fd list (the list keeps its own duplicate)
+        GError *pError = nullptr;
+        GUnixFDList *pFdList = g_unix_fd_list_new();
+        gint handle = g_unix_fd_list_append(pFdList, fds[1], &pError);
+        close(fds[1]);
+        if (handle < 0) {
+            Logger::error(
+                SSTR << "AcquireWrite: unable to append fd: " << (nullptr == pError ? "Unknown" : pError->message)
+            );
+            close(fds[0]);
+            g_object_unref(pFdList);
+            g_dbus_method_invocation_return_dbus_error(
+                pInvocation,
+                kErrorFailed.c_str(),
+                "Unable to transfer the write fd"
+            );
+            return;
+        }
+
+        self.writeFd = fds[0];
+        self.writeMtu = mtu;
+        self.writeWatchId = g_unix_fd_add(
+            fds[0],
+            static_cast<GIOCondition>(G_IO_IN | G_IO_HUP | G_IO_ERR),
+            onAcquiredWriteReady,
+            const_cast<GattCharacteristic *>(&self)
+        );
+
+        Logger::info(SSTR << "Write fd acquired for '" << self.getPath() << "' (MTU " << mtu << ")");
+        g_dbus_method_invocation_return_value_with_unix_fd_list(
+            pInvocation,
+            g_variant_new("(hq)", handle, mtu),
+            pFdList
+        );
+        g_object_unref(pFdList);
+    };
+
+    static const char *inArgs[] = {"a{sv}", nullptr};
+    addMethod("AcquireWrite", inArgs, "hq", reinterpret_cast<DBusMethod::Callback>(acquireFunc));
+    return *this;
+}
+
+// Enables MTU-sized packing of fd-based notifications (see the header for the boundary-merging caveat)
+GattCharacteristic &GattCharacteristic::enableNotifyBatching() {
+    bBatchNotifies = true;
+    return *this;
+}
+
+// Stage a value in the notification batch buffer (see `enableNotifyBatching`)
+//
+// Returns true if the value was staged; false if batching doesn't apply (disabled, no fd, or the value fills a packet
+// on its own) and the caller should send the value directly.
+bool GattCharacteristic::appendToNotifyBatch(const guint8 *pData, size_t count) const {
+    if (!bBatchNotifies || notifyFd < 0) {
+        return false;
+    }
+
+    size_t maxPayload = (notifyMtu > kAttNotifyHeaderSize ? notifyMtu : kDefaultMtu) - kAttNotifyHeaderSize;
+
+    // A value that fills a packet on its own gains nothing from batching - push anything staged ahead of it out
+    // first so ordering is preserved, then let the caller send it whole
+    if (count >= maxPayload) {
+        flushNotifyBatch();
+        return false;
+    }
+
+    // Flush first if this value wouldn't fit behind what's already staged
+    if (notifyBatchBuffer.size() + count > maxPayload) {
+        flushNotifyBatch();
+    }
+
+    notifyBatchBuffer.insert(notifyBatchBuffer.end(), pData, pData + count);
+
+    // Arrange a flush at the end of this main-loop iteration, so updates dispatched in the same burst coalesce but
+    // nothing lingers beyond the iteration that staged it
+    if (0 == notifyBatchIdleId) {
+        auto flushFunc = [](gpointer pUserData) -> gboolean {
+            const GattCharacteristic &self = *static_cast<const GattCharacteristic *>(pUserData);
+            self.notifyBatchIdleId = 0;
+            self.flushNotifyBatch();
+            return FALSE;
+        };
+
+        notifyBatchIdleId = g_idle_add(flushFunc, const_cast<GattCharacteristic *>(this));
+    }
+
+    return true;
+}
+
+// Writes any staged batched notification bytes to the notification fd as a single packet. Safe to call when nothing
+// is staged.
+void GattCharacteristic::flushNotifyBatch() const {
+    if (0 != notifyBatchIdleId) {
+        g_source_remove(notifyBatchIdleId);
+        notifyBatchIdleId = 0;
+    }
+
+    if (notifyBatchBuffer.empty()) {
+        return;
+    }
+
+    writeNotifyFd(notifyBatchBuffer.data(), notifyBatchBuffer.size());
+    notifyBatchBuffer.clear();
+}
+
+// Drain the acquired write fd, invoking the acquired-write callback once per received packet
+//
+// This is called from the main-loop watch on the fd. Returns true to keep the watch alive, or false if the fd was torn
+// down (client hangup or error) and the watch should be removed.
+bool GattCharacteristic::handleAcquiredWriteReady(int fd, GIOCondition condition) const {
+    if ((condition & (G_IO_HUP | G_IO_ERR | G_IO_NVAL)) != 0) {
+        Logger::info(SSTR << "Write fd for '" << getPath() << "' closed by client");
+        releaseWriteFd(false);
+        return false;
+    }
+
+    // Drain everything that's arrived - each recv returns exactly one client write
+    guint8 buffer[kMaxAttPayloadSize];
+    for (;;) {
+        ssize_t count = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (count < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+
+            Logger::info(SSTR << "Write fd for '" << getPath() << "' failed (" << strerror(errno) << ")");
+            releaseWriteFd(false);
+            return false;
+        }
+
+        if (count == 0) {
+            Logger::info(SSTR << "Write fd for '" << getPath() << "' closed by client");
+            releaseWriteFd(false);
+            return false;
+        }
+
+        if (nullptr != pOnAcquiredWriteFunc) {
+            pOnAcquiredWriteFunc(*this, pBusConnection, buffer, static_cast<size_t>(count));
+        }
+    }
+
+    return true;
+}
+
+// Close the acquired write fd (if any) and remove its main-loop watch. Safe to call when nothing is acquired.
+//
+// `removeWatch` should be false when tearing down from within the watch callback itself (the callback removes the
+// watch by returning false.)
+void GattCharacteristic::releaseWriteFd(bool removeWatch) const {
+    if (writeFd >= 0) {
+        if (removeWatch && writeWatchId != 0) {
+            g_source_remove(writeWatchId);
+        }
+        close(writeFd);
+        writeFd = -1;
+        writeWatchId = 0;
+        writeMtu = 0;
+    }
+}
+
+// Emit a PropertiesChanged signal for the `Notifying` property (see `enableNotifySubscriptions`)
+static void emitNotifyingChanged(const GattCharacteristic &self, GDBusConnection *pConnection, bool notifying) {
+    g_auto(GVariantBuilder) builder;
+    g_variant_builder_init(&builder, G_VARIANT_TYPE_ARRAY);
+    g_variant_builder_add(&builder, "{sv}", "Notifying", Utils::gvariantFromBoolean(notifying));
+    GVariant *pSasv = g_variant_new("(sa{sv})", "org.bluez.GattCharacteristic1", &builder);
+    self.getOwner().emitSignal(pConnection, "org.freedesktop.DBus.Properties", "PropertiesChanged", pSasv);
+}
+
+// Specialized support for the StartNotify/StopNotify methods (subscription tracking)
+//
+// Defined as: void StartNotify()
+//             void StopNotify()
+//
+// The handlers keep a count of active notify sessions on this characteristic so the notification path can tell
+// whether anybody is listening (see `hasSubscribers`.) The standard `Notifying` property is added as well, and a
+// PropertiesChanged signal is emitted when the characteristic transitions between notifying and not.
+GattCharacteristic &GattCharacteristic::enableNotifySubscriptions() {
+    bTrackSubscriptions = true;
+    addProperty<GattCharacteristic>("Notifying", false);
+
+    MethodCallback startNotifyFunc = [](const GattCharacteristic &self,
+                                        GDBusConnection *pConnection,
+                                        const std::string & /*methodName*/,
+                                        GVariant * /*pParameters*/,
+                                        GDBusMethodInvocation *pInvocation,
+                                        void * /*pUserData*/) {
+        self.notifySessions += 1;
+        Logger::info(
+            SSTR << "Client subscribed to '" << self.getPath() << "' (" << self.notifySessions << " session(s))"
+        );
+
+        if (1 == self.notifySessions) {
+            emitNotifyingChanged(self, pConnection, true);
+        }
+
+        g_dbus_method_invocation_return_value(pInvocation, nullptr);
+    };
+
+    MethodCallback stopNotifyFunc = [](const GattCharacteristic &self,
+                                       GDBusConnection *pConnection,
+                                       const std::string & /*methodName*/,
+                                       GVariant * /*pParameters*/,
+                                       GDBusMethodInvocation *pInvocation,
+                                       void * /*pUserData*/) {
+        if (self.notifySessions > 0) {
+            self.notifySessions -= 1;
+            Logger::info(
+                SSTR << "Client unsubscribed from '" << self.getPath() << "' (" << self.notifySessions
+                     << " session(s) remain)"
+            );
+
+            if (0 == self.notifySessions) {
+                emitNotifyingChanged(self, pConnection, false);
+            }
+        }
+
+        g_dbus_method_invocation_return_value(pInvocation, nullptr);
+    };
+
+    static const char *inArgs[] = {nullptr};
+    addMethod("StartNotify", inArgs, nullptr, reinterpret_cast<DBusMethod::Callback>(startNotifyFunc));
+    addMethod("StopNotify", inArgs, nullptr, reinterpret_cast<DBusMethod::Callback>(stopNotifyFunc));
+    return *this;
+}
+
 // Custom support for handling updates to our characteristic's value
 //
 // Defined as: (NOT defined by Bluetooth or BlueZ - this method is internal only)
@@ -184,11 +857,11 @@ bool GattCharacteristic::callOnUpdatedValue(GDBusConnection *pConnection, void *
 //
 // To end a descriptor, call `GattDescriptor::gattDescriptorEnd()`
 GattDescriptor &GattCharacteristic::gattDescriptorBegin(
-    const std::string &pathElement,
+    std::string pathElement,
     const GattUuid &uuid,
     const std::vector<const char *> &flags
 ) {
-    DBusObject &child = owner.addChild(DBusObjectPath(pathElement));
+    DBusObject &child = owner.addChild(DBusObjectPath(std::move(pathElement)));
     GattDescriptor &descriptor =
         *child.addInterface(std::make_shared<GattDescriptor>(child, *this, "org.bluez.GattDescriptor1"));
     descriptor.addProperty<GattDescriptor>("UUID", uuid);
@@ -205,6 +878,12 @@ GattDescriptor &GattCharacteristic::gattDescriptorBegin(
 // The caller may choose to consult HciAdapter::getInstance().getActiveConnectionCount() in order to determine if there
 // are any active connections before sending a change notification.
 void GattCharacteristic::sendChangeNotificationVariant(GDBusConnection *pBusConnection, GVariant *pNewValue) const {
+    // Nobody is listening - sink and release the floating value rather than signal an empty room
+    if (!hasSubscribers()) {
+        g_variant_unref(g_variant_ref_sink(pNewValue));
+        return;
+    }
+
     g_auto(GVariantBuilder) builder;
     g_variant_builder_init(&builder, G_VARIANT_TYPE_ARRAY);
     g_variant_builder_add(&builder, "{sv}", "Value", pNewValue);
@@ -212,4 +891,110 @@ void GattCharacteristic::sendChangeNotificationVariant(GDBusConnection *pBusConn
     owner.emitSignal(pBusConnection, "org.freedesktop.DBus.Properties", "PropertiesChanged", pSasv);
 }
 
+// Sends a change notification for a byte array value
+//
+// If a notification fd has been acquired (see `enableAcquireNotify`), the bytes are written directly to the socket -
+// a single syscall with no D-Bus marshaling. Otherwise (or if the client has hung up) this falls back to the standard
+// PropertiesChanged signal.
+void GattCharacteristic::sendChangeNotificationValue(GDBusConnection *pBusConnection, const std::vector<guint8> &bytes)
+    const {
+    if (appendToNotifyBatch(bytes.data(), bytes.size())) {
+        return;
+    }
+
+    if (writeNotifyFd(bytes.data(), bytes.size())) {
+        return;
+    }
+
+    // No fd and no subscribers - skip the GVariant marshaling entirely
+    if (!hasSubscribers()) {
+        return;
+    }
+
+    GVariant *pVariant = Utils::gvariantFromByteArray(bytes);
+    sendChangeNotificationVariant(pBusConnection, pVariant);
+}
+
+// Sends a change notification for a raw byte span
+//
+// As the byte-vector overload, but without requiring the bytes to be staged in a vector first - the span is handed
+// straight to the fd write or the GVariant marshaler.
+void GattCharacteristic::sendChangeNotificationValue(GDBusConnection *pBusConnection, const guint8 *pData, size_t count)
+    const {
+    if (appendToNotifyBatch(pData, count)) {
+        return;
+    }
+
+    if (writeNotifyFd(pData, count)) {
+        return;
+    }
+
+    // No fd and no subscribers - skip the GVariant marshaling entirely
+    if (!hasSubscribers()) {
+        return;
+    }
+
+    GVariant *pVariant = Utils::gvariantFromByteArray(pData, static_cast<int>(count));
+    sendChangeNotificationVariant(pBusConnection, pVariant);
+}
+
+// Write a value directly to the acquired notification fd
+//
+// The value is clamped to the negotiated MTU (minus the 3-byte ATT notification header.) Returns true if the write was
+// handled via the fd (including an intentional drop when the socket buffer is full), or false if there is no usable fd
+// and the caller should fall back to a PropertiesChanged signal.
+bool GattCharacteristic::writeNotifyFd(const guint8 *pData, size_t count) const {
+    if (notifyFd < 0) {
+        return false;
+    }
+
+    // BlueZ forwards each packet as one notification, so clamp to what fits in a single ATT notification
+    if (notifyMtu > kAttNotifyHeaderSize && count > static_cast<size_t>(notifyMtu - kAttNotifyHeaderSize)) {
+        count = notifyMtu - kAttNotifyHeaderSize;
+    }
+
+    // Vectored send (sendmsg rather than writev so we can suppress SIGPIPE when the client hangs up)
+    struct iovec iov;
+    iov.iov_base = const_cast<guint8 *>(pData);
+    iov.iov_len = count;
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    ssize_t written = sendmsg(notifyFd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (written >= 0) {
+        return true;
+    }
+
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        // The socket buffer is full - drop this notification rather than stall the main loop. The next update will
+        // carry newer data anyway.
+        Logger::debug(SSTR << "Notification fd for '" << getPath() << "' is backed up - dropping update");
+        return true;
+    }
+
+    // The client has released the fd (or something else has gone wrong) - tear it down and let the caller fall back
+    Logger::info(SSTR << "Notification fd for '" << getPath() << "' closed (" << strerror(errno) << ")");
+    releaseNotifyFd();
+    return false;
+}
+
+// Close the acquired notification fd (if any.) Safe to call when nothing is acquired.
+void GattCharacteristic::releaseNotifyFd() const {
+    // Anything still staged for this fd has nowhere to go
+    notifyBatchBuffer.clear();
+    if (0 != notifyBatchIdleId) {
+        g_source_remove(notifyBatchIdleId);
+        notifyBatchIdleId = 0;
+    }
+
+    if (notifyFd >= 0) {
+        close(notifyFd);
+        notifyFd = -1;
+        notifyMtu = 0;
+    }
+}
+
 }; // namespace ggk
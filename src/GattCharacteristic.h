@@ -29,6 +29,7 @@
 
 #include "GattInterface.h"
 #include "HciAdapter.h"
+#include "MappedFile.h"
 #include "TickEvent.h"
 #include "Utils.h"
 
@@ -86,13 +87,22 @@ struct GattCharacteristic : GattInterface {
         void *pUserData
     );
     typedef bool (*UpdatedValueCallback)(const GattCharacteristic &self, GDBusConnection *pConnection, void *pUserData);
+    typedef void (*AcquiredWriteCallback)(
+        const GattCharacteristic &self,
+        GDBusConnection *pConnection,
+        const guint8 *pData,
+        size_t count
+    );
 
     // Construct a GattCharacteristic
     //
     // Genreally speaking, these objects should not be constructed directly. Rather, use the `gattCharacteristicBegin()`
     // method in `GattService`.
-    GattCharacteristic(DBusObject &owner, GattService &service, const std::string &name);
-    virtual ~GattCharacteristic() {}
+    GattCharacteristic(DBusObject &owner, GattService &service, std::string name);
+    virtual ~GattCharacteristic() {
+        releaseNotifyFd();
+        releaseWriteFd();
+    }
 
     // Returns a string identifying the type of interface
     virtual const std::string getInterfaceType() const {
@@ -121,11 +131,14 @@ struct GattCharacteristic : GattInterface {
     // to chain.
     GattCharacteristic &onEvent(int tickFrequency, void *pUserData, EventCallback callback);
 
-    // Ticks events within this characteristic
+    // Same as `onEvent`, but with the period given in milliseconds for sub-second events
+    GattCharacteristic &onEventMS(int periodMS, void *pUserData, EventCallback callback);
+
+    // Fires the given event (which must belong to this characteristic)
     //
     // Note: we specifically override this method in order to translate the generic TickEvent::Callback into our own
     // EventCallback
-    virtual void tickEvents(GDBusConnection *pConnection, void *pUserData) const;
+    virtual void fireTickEvent(const TickEvent &event, GDBusConnection *pConnection, void *pUserData) const;
 
     // Specialized support for Characteristic ReadlValue method
     //
@@ -148,6 +161,211 @@ struct GattCharacteristic : GattInterface {
     //     Output args: void
     GattCharacteristic &onWriteValue(MethodCallback callback);
 
+    // Specialized support for the Characteristic AcquireNotify method (BlueZ fd-based notifications)
+    //
+    // Defined as: (fd, MTU) AcquireNotify(dict options)
+    //
+    // D-Bus breakdown:
+    //
+    //     Input args:  options - "a{sv}"
+    //     Output args: fd      - "h"
+    //                  mtu     - "q"
+    //
+    // When enabled, BlueZ hands us one end of a socket pair the moment a client subscribes, and value updates are
+    // written directly to that socket (see `sendChangeNotificationValue`) instead of being marshaled through a D-Bus
+    // PropertiesChanged signal per update. This is the path to use for high-rate notification streams.
+    //
+    // Note that BlueZ only offers AcquireNotify for characteristics that expose the `NotifyAcquired` property, which
+    // this method adds. The characteristic must also carry the "notify" flag.
+    GattCharacteristic &enableAcquireNotify();
+
+    // Specialized support for the Characteristic AcquireWrite method (BlueZ fd-based inbound writes)
+    //
+    // Defined as: (fd, MTU) AcquireWrite(dict options)
+    //
+    // D-Bus breakdown:
+    //
+    //     Input args:  options - "a{sv}"
+    //     Output args: fd      - "h"
+    //                  mtu     - "q"
+    //
+    // When enabled, BlueZ hands over a socket fd the moment a client begins writing, and each inbound write lands as
+    // one packet on that socket - no per-chunk D-Bus method call or GVariant unpacking. The socket is watched on the
+    // main loop and `callback` is invoked once per received packet with the raw bytes. This is the path to use for
+    // bulk uploads (firmware images, config blobs.)
+    //
+    // Note that BlueZ only offers AcquireWrite for characteristics that expose the `WriteAcquired` property, which
+    // this method adds. The characteristic must also carry the "write-without-response" flag.
+    GattCharacteristic &enableAcquireWrite(AcquiredWriteCallback callback);
+
+    // Enables MTU-sized packing of fd-based notifications
+    //
+    // Without batching, every `sendChangeNotificationValue` becomes one notification packet - a burst of 20-byte
+    // updates on a link that negotiated a 247- or 517-byte MTU wastes most of each packet. With batching enabled,
+    // small values are staged in a buffer and flushed as a single MTU-filling packet at the end of the main-loop
+    // iteration that staged them (or sooner, whenever the next value wouldn't fit), so updates dispatched in the same
+    // burst coalesce with no added latency beyond the loop iteration.
+    //
+    // IMPORTANT: Batching merges notification boundaries - subscribers receive concatenated values, so only enable
+    // this for characteristics whose payloads are self-delimiting. Values that fill a packet on their own are
+    // unaffected. Batching only applies to the acquired-fd path (see `enableAcquireNotify`); PropertiesChanged
+    // signals always carry whole values.
+    GattCharacteristic &enableNotifyBatching();
+
+    // Writes any staged batched notification bytes to the notification fd (see `enableNotifyBatching`.) Safe to call
+    // when nothing is staged.
+    void flushNotifyBatch() const;
+
+    // Returns the MTU negotiated for this characteristic's acquired channel, or 0 if no channel has been acquired
+    uint16_t getNegotiatedMTU() const {
+        return 0 != notifyMtu ? notifyMtu : writeMtu;
+    }
+
+    // Specialized support for the Characteristic StartNotify/StopNotify methods (subscription tracking)
+    //
+    // Defined as: void StartNotify()
+    //             void StopNotify()
+    //
+    // BlueZ calls StartNotify when a client enables notifications on this characteristic (a CCCD write) and StopNotify
+    // when the client disables them or its notify session ends. Without these handlers GGK never knows whether anyone
+    // is actually listening, so value updates emit PropertiesChanged signals - and run `onUpdatedValue` work - for
+    // nobody.
+    //
+    // This method registers both handlers, adds the standard `Notifying` property, and keeps a subscriber count on the
+    // characteristic. Once tracking is enabled here, `sendChangeNotificationValue`/`sendChangeNotificationVariant`
+    // quietly do nothing while the count is zero and no notification fd is acquired (see `hasSubscribers`.) The update
+    // dispatch path (see Init.cpp) likewise skips `onUpdatedValue` entirely for an unsubscribed characteristic.
+    GattCharacteristic &enableNotifySubscriptions();
+
+    // Returns true if anybody is listening for value changes on this characteristic
+    //
+    // A characteristic has subscribers if a client has called StartNotify (and not yet StopNotify) or holds an
+    // acquired notification fd. For characteristics without subscription tracking enabled (see
+    // `enableNotifySubscriptions`) this always returns true - we can't know, so we assume someone is listening.
+    bool hasSubscribers() const {
+        return !bTrackSubscriptions || notifySessions > 0 || notifyFd >= 0;
+    }
+
+    // Reset the subscription state (see `enableNotifySubscriptions`.) Safe to call when tracking was never enabled.
+    //
+    // BlueZ sends StopNotify on clean teardowns, but not every disconnect is clean - this is called when the last
+    // client disconnects so stale subscriptions can't keep the notification path doing work for nobody.
+    void clearNotifySubscriptions() const {
+        notifySessions = 0;
+    }
+
+    //
+    // Long attribute support (offset-aware reads and segmented writes)
+    //
+    // Values longer than one MTU are transferred by BlueZ as a series of ReadValue/WriteValue calls carrying an
+    // "offset" option. A read callback that ignores the offset serves the same first MTU's worth of bytes for every
+    // segment; a write callback that ignores it sees only the final fragment. The methods below give callbacks
+    // offset handling for free: long reads are served out of a snapshot taken at offset 0 (so the value is consistent
+    // across segments and the application's getter runs once per logical read, not once per segment), and segmented
+    // writes are reassembled before the application's setter sees them.
+    //
+
+    // Returns the "offset" option from ReadValue parameters (0 when no offset was passed)
+    static guint16 readValueOffset(GVariant *pParameters);
+
+    // Returns the "offset" option from WriteValue parameters (0 when no offset was passed)
+    static guint16 writeValueOffset(GVariant *pParameters);
+
+    // Returns true if the WriteValue parameters carry "type": "command" - BlueZ's mapping of an ATT Write Command
+    // (write-without-response)
+    static bool writeValueIsCommand(GVariant *pParameters);
+
+    //
+    // File-backed values (see MappedFile.cpp)
+    //
+    // A characteristic bound to a file serves its value straight out of the page cache: reads reference the mapped
+    // pages directly (no heap copy of the payload, no per-segment memcpy), and a replaced file is picked up on the
+    // next read via the mapping's generation check.
+    //
+
+    // Binds (or, with an empty path, unbinds) this characteristic's value to the file at `path`
+    void bindValueFile(const std::string &path) const;
+
+    // Returns the current mapping of the bound value file, or nullptr if none is bound or it cannot be mapped
+    std::shared_ptr<const FileMapping> acquireValueFile() const;
+
+    // Serves a read segment zero-copy from the bound value file, if there is one
+    //
+    // Returns true if the invocation was answered; false when no file is bound (or it cannot be mapped), in which
+    // case the caller should serve the value from its normal source. The reply variant references the mapped pages
+    // directly and pins the mapping until GDBus is done with it.
+    bool methodReturnMappedReadSegment(GDBusMethodInvocation *pInvocation, GVariant *pParameters) const;
+
+    // Completes a WriteValue invocation, routing write-without-response commands through a reply-free fast path
+    //
+    // A with-response write behaves as ever: the post-write delegate runs inline and a D-Bus method return goes
+    // back. A command gets neither - nothing is waiting on the reply (BlueZ marks the message no-reply-expected),
+    // so the invocation is completed without marshaling a return value, and the post-write work is pushed through
+    // the coalescing update queue instead of running per packet. A burst of unacked command packets then costs one
+    // delegate pass per main-loop dispatch, not one per packet. The intended write-callback pattern:
+    //
+    //     self.setDataPointer(..., new std::vector<guint8>(self.assembleWriteSegment(pParameters)));
+    //     self.methodCompleteWrite(pConnection, pParameters, pInvocation, pUserData);
+    void methodCompleteWrite(
+        GDBusConnection *pConnection,
+        GVariant *pParameters,
+        GDBusMethodInvocation *pInvocation,
+        void *pUserData
+    ) const;
+
+    // Serves a long-read segment from the snapshot taken at offset 0, if there is one to serve from
+    //
+    // Returns true if the invocation was answered (a segment was served or the offset was rejected as invalid.)
+    // Returns false when the parameters carry no offset - or the snapshot is empty, as after a reconnect mid-read -
+    // in which case the caller should fetch a fresh value and answer via `methodReturnReadSegment`. The intended
+    // read-callback pattern:
+    //
+    //     if (self.methodReturnCachedReadSegment(pInvocation, pParameters)) { return; }
+    //     const std::vector<guint8> bytes = self.getDataValue(...);
+    //     self.methodReturnReadSegment(pInvocation, pParameters, bytes.data(), bytes.size());
+    bool methodReturnCachedReadSegment(GDBusMethodInvocation *pInvocation, GVariant *pParameters) const;
+
+    // Answers a ReadValue invocation with the requested segment of the given value
+    //
+    // At offset 0 the value is also snapshotted, becoming the serving source for the read's later segments (see
+    // `methodReturnCachedReadSegment`.)
+    void methodReturnReadSegment(
+        GDBusMethodInvocation *pInvocation,
+        GVariant *pParameters,
+        const guint8 *pData,
+        size_t count
+    ) const;
+
+    // Merges a WriteValue segment into the reassembly buffer at the offset the parameters carry
+    //
+    // Returns the assembled value so far - for an unsegmented write (offset 0, the common case) that is simply the
+    // written value. The returned reference is to the characteristic's own buffer; it remains valid until the next
+    // segment arrives.
+    const std::vector<guint8> &assembleWriteSegment(GVariant *pParameters) const;
+
+    // A value getter for deferred reads (see `methodReturnReadAsync`.) Runs on a worker thread, so it must only do
+    // work that is safe off the main loop - calling the application's data delegates (which must themselves be
+    // thread-safe, as the built-in data store is) and returning the value.
+    typedef std::vector<guint8> (*AsyncValueGetter)(const GattCharacteristic &self, void *pUserData);
+
+    // Answers a ReadValue invocation asynchronously, so a slow value getter doesn't stall the main loop
+    //
+    // The invocation is captured and this returns immediately; `getter` runs on a worker thread (see MethodWorker)
+    // and the reply - via `methodReturnReadSegment`, so long reads work as usual - is marshaled back to the main
+    // loop once the value is in hand. Other characteristics' methods and pending notifications proceed in the
+    // meantime; the read callback pattern becomes:
+    //
+    //     if (self.methodReturnCachedReadSegment(pInvocation, pParameters)) { return; }
+    //     self.methodReturnReadAsync(pInvocation, pParameters, myGetter, pUserData);
+    //
+    // If the worker pool is shutting down, the read falls back to running `getter` inline.
+    void methodReturnReadAsync(
+        GDBusMethodInvocation *pInvocation,
+        GVariant *pParameters,
+        AsyncValueGetter getter,
+        void *pUserData
+    ) const;
+
     // Custom support for handling updates to our characteristic's value
     //
     // Defined as: (NOT defined by Bluetooth or BlueZ - this method is internal only)
@@ -198,7 +416,7 @@ struct GattCharacteristic : GattInterface {
     //
     // To end the descriptor, call `gattDescriptorEnd()`
     GattDescriptor &
-    gattDescriptorBegin(const std::string &pathElement, const GattUuid &uuid, const std::vector<const char *> &flags);
+    gattDescriptorBegin(std::string pathElement, const GattUuid &uuid, const std::vector<const char *> &flags);
 
     // Sends a change notification to subscribers to this characteristic
     //
@@ -221,9 +439,97 @@ struct GattCharacteristic : GattInterface {
         sendChangeNotificationVariant(pBusConnection, pVariant);
     }
 
+    // Sends a change notification for a byte array value
+    //
+    // This non-template overload is preferred by the compiler for byte vectors. If a notification fd has been acquired
+    // (see `enableAcquireNotify`), the bytes are written directly to the socket - a single syscall with no D-Bus
+    // marshaling. Otherwise this falls back to the standard PropertiesChanged signal.
+    void sendChangeNotificationValue(GDBusConnection *pBusConnection, const std::vector<guint8> &bytes) const;
+
+    // Sends a change notification for a raw byte span (see `GGKDataSpan`)
+    //
+    // As the byte-vector overload, but without requiring the bytes to be staged in a vector first - the span is
+    // handed straight to the fd write or the GVariant marshaler.
+    void sendChangeNotificationValue(GDBusConnection *pBusConnection, const guint8 *pData, size_t count) const;
+
+    // Returns true if a client currently holds an acquired notification fd for this characteristic
+    bool isNotifyAcquired() const {
+        return notifyFd >= 0;
+    }
+
+    // Write a value directly to the acquired notification fd
+    //
+    // The value is clamped to the negotiated MTU (minus the 3-byte ATT notification header.) Returns true if the write
+    // was handled via the fd (including an intentional drop when the socket buffer is full), or false if there is no
+    // usable fd (never acquired, or the client hung up) and the caller should fall back to a PropertiesChanged signal.
+    bool writeNotifyFd(const guint8 *pData, size_t count) const;
+
+    // Stage a value in the notification batch buffer (see `enableNotifyBatching`)
+    //
+    // Returns true if the value was staged (or will ride the next flush); false if batching doesn't apply and the
+    // caller should send the value on its own.
+    bool appendToNotifyBatch(const guint8 *pData, size_t count) const;
+
+    // Close the acquired notification fd (if any.) Safe to call when nothing is acquired.
+    void releaseNotifyFd() const;
+
+    // Returns true if a client currently holds an acquired write fd for this characteristic
+    bool isWriteAcquired() const {
+        return writeFd >= 0;
+    }
+
+    // Drain the acquired write fd, invoking the acquired-write callback once per received packet
+    //
+    // This is called from the main-loop watch on the fd. Returns true to keep the watch alive, or false if the fd was
+    // torn down (client hangup or error) and the watch should be removed.
+    bool handleAcquiredWriteReady(int fd, GIOCondition condition) const;
+
+    // Close the acquired write fd (if any) and remove its main-loop watch. Safe to call when nothing is acquired.
+    void releaseWriteFd(bool removeWatch = true) const;
+
 protected:
     GattService &service;
     UpdatedValueCallback pOnUpdatedValueFunc;
+    AcquiredWriteCallback pOnAcquiredWriteFunc;
+
+    // The acquired notification fd (-1 when not acquired.) Mutable because acquisition happens on a const reference
+    // from within method callbacks.
+    mutable int notifyFd;
+
+    // The MTU negotiated when the notification fd was acquired (0 when not acquired)
+    mutable uint16_t notifyMtu;
+
+    // The acquired write fd (-1 when not acquired) and its main-loop watch id
+    mutable int writeFd;
+    mutable guint writeWatchId;
+
+    // The MTU negotiated when the write fd was acquired (0 when not acquired)
+    mutable uint16_t writeMtu;
+
+    // Whether StartNotify/StopNotify subscription tracking is enabled (see `enableNotifySubscriptions`)
+    bool bTrackSubscriptions;
+
+    // The number of active StartNotify sessions. Mutable because subscription changes arrive on a const reference
+    // from within method callbacks.
+    mutable int notifySessions;
+
+    // The snapshot long reads are served from (taken at offset 0 - see `methodReturnReadSegment`.) Mutable because
+    // reads arrive on a const reference from within method callbacks.
+    mutable std::vector<guint8> longReadCache;
+
+    // The optional file backing this characteristic's value (see `bindValueFile`)
+    mutable MappedFile valueFile;
+
+    // The reassembly buffer for segmented writes (see `assembleWriteSegment`)
+    mutable std::vector<guint8> longWriteBuffer;
+
+    // Whether MTU-sized notification packing is enabled (see `enableNotifyBatching`)
+    bool bBatchNotifies;
+
+    // Staged notification bytes and the idle source that will flush them. Mutable because staging happens on a const
+    // reference from within the update dispatch path.
+    mutable std::vector<guint8> notifyBatchBuffer;
+    mutable guint notifyBatchIdleId;
 };
 
 }; // namespace ggk
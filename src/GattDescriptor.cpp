@@ -38,8 +38,8 @@ namespace ggk {
 //
 // Genreally speaking, these objects should not be constructed directly. Rather, use the `gattDescriptorBegin()` method
 // in `GattCharacteristic`.
-GattDescriptor::GattDescriptor(DBusObject &owner, GattCharacteristic &characteristic, const std::string &name) :
-    GattInterface(owner, name),
+GattDescriptor::GattDescriptor(DBusObject &owner, GattCharacteristic &characteristic, std::string name) :
+    GattInterface(owner, std::move(name)),
     characteristic(characteristic),
     pOnUpdatedValueFunc(nullptr) {}
 
@@ -62,12 +62,10 @@ bool GattDescriptor::callMethod(
     GDBusMethodInvocation *pInvocation,
     gpointer pUserData
 ) const {
-    for (const DBusMethod &method : methods) {
-        if (methodName == method.getName()) {
-            method.call<
-                GattDescriptor>(pConnection, getPath(), getName(), methodName, pParameters, pInvocation, pUserData);
-            return true;
-        }
+    if (const DBusMethod *pMethod = findMethod(methodName)) {
+        pMethod
+            ->call<GattDescriptor>(pConnection, getPath(), getName(), methodName, pParameters, pInvocation, pUserData);
+        return true;
     }
 
     return false;
@@ -84,14 +82,20 @@ GattDescriptor &GattDescriptor::onEvent(int tickFrequency, void *pUserData, Even
     return *this;
 }
 
-// Ticks events within this descriptor
+// Adds an event with a millisecond period to the descriptor and returns a refereence to 'this` to enable method
+// chaining in the server description (see `onEvent` for details on the overload/chaining conventions)
+GattDescriptor &GattDescriptor::onEventMS(int periodMS, void *pUserData, EventCallback callback) {
+    events.push_back(TickEvent(this, 0, reinterpret_cast<TickEvent::Callback>(callback), pUserData));
+    events.back().setPeriodMS(periodMS);
+    return *this;
+}
+
+// Fires the given event (which must belong to this descriptor)
 //
 // Note: we specifically override this method in order to translate the generic TickEvent::Callback into our own
 // EventCallback
-void GattDescriptor::tickEvents(GDBusConnection *pConnection, void *pUserData) const {
-    for (const TickEvent &event : events) {
-        event.tick<GattDescriptor>(getPath(), pConnection, pUserData);
-    }
+void GattDescriptor::fireTickEvent(const TickEvent &event, GDBusConnection *pConnection, void *pUserData) const {
+    event.fire<GattDescriptor>(getPath(), pConnection, pUserData);
 }
 
 // Specialized support for ReadlValue method
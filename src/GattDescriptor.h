@@ -91,7 +91,7 @@ struct GattDescriptor : GattInterface {
     //
     // Genreally speaking, these objects should not be constructed directly. Rather, use the `gattDescriptorBegin()`
     // method in `GattCharacteristic`.
-    GattDescriptor(DBusObject &owner, GattCharacteristic &characteristic, const std::string &name);
+    GattDescriptor(DBusObject &owner, GattCharacteristic &characteristic, std::string name);
     virtual ~GattDescriptor() {}
 
     // Returns a string identifying the type of interface
@@ -121,11 +121,14 @@ struct GattDescriptor : GattInterface {
     // to chain.
     GattDescriptor &onEvent(int tickFrequency, void *pUserData, EventCallback callback);
 
-    // Ticks events within this descriptor
+    // Same as `onEvent`, but with the period given in milliseconds for sub-second events
+    GattDescriptor &onEventMS(int periodMS, void *pUserData, EventCallback callback);
+
+    // Fires the given event (which must belong to this descriptor)
     //
     // Note: we specifically override this method in order to translate the generic TickEvent::Callback into our own
     // EventCallback
-    virtual void tickEvents(GDBusConnection *pConnection, void *pUserData) const;
+    virtual void fireTickEvent(const TickEvent &event, GDBusConnection *pConnection, void *pUserData) const;
 
     // Specialized support for Descriptor ReadlValue method
     //
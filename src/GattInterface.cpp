@@ -31,8 +31,8 @@ namespace ggk {
 //
 // Standard constructor
 //
-GattInterface::GattInterface(DBusObject &owner, const std::string &name) :
-    DBusInterface(owner, name) {}
+GattInterface::GattInterface(DBusObject &owner, std::string name) :
+    DBusInterface(owner, std::move(name)) {}
 
 GattInterface::~GattInterface() {}
 
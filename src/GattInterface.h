@@ -25,6 +25,8 @@
 #include <gio/gio.h>
 #include <list>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "DBusInterface.h"
 #include "GattProperty.h"
@@ -49,7 +51,7 @@ struct DBusObject;
 
 struct GattInterface : DBusInterface {
     // Standard constructor
-    GattInterface(DBusObject &owner, const std::string &name);
+    GattInterface(DBusObject &owner, std::string name);
     virtual ~GattInterface();
 
     // Returns a string identifying the type of interface
@@ -71,6 +73,15 @@ struct GattInterface : DBusInterface {
         return *static_cast<T *>(this);
     }
 
+    // Rvalue counterpart of the above - moves the property into place rather than copying it
+    //
+    // The typed helper methods below all construct their `GattProperty` as a temporary, so they land here and the
+    // property's name string is never copied.
+    template <typename T> T &addProperty(GattProperty &&property) {
+        properties.push_back(std::move(property));
+        return *static_cast<T *>(this);
+    }
+
     // Add a named property with a GVariant *
     //
     // There are helper methods for common types (UUIDs, strings, boolean, etc.) Use this method when no helper method
@@ -78,90 +89,90 @@ struct GattInterface : DBusInterface {
     // `GattProperty`.
     template <typename T>
     T &addProperty(
-        const std::string &name,
+        std::string name,
         GVariant *pValue,
         GDBusInterfaceGetPropertyFunc getter = nullptr,
         GDBusInterfaceSetPropertyFunc setter = nullptr
     ) {
-        return addProperty<T>(GattProperty(name, pValue, getter, setter));
+        return addProperty<T>(GattProperty(std::move(name), pValue, getter, setter));
     }
 
     // Helper method for adding a named property with a `GattUuid`
     template <typename T>
     T &addProperty(
-        const std::string &name,
+        std::string name,
         const GattUuid &uuid,
         GDBusInterfaceGetPropertyFunc getter = nullptr,
         GDBusInterfaceSetPropertyFunc setter = nullptr
     ) {
-        return addProperty<T>(GattProperty(name, Utils::gvariantFromString(uuid.toString128().c_str()), getter, setter)
+        return addProperty<T>(GattProperty(std::move(name), Utils::gvariantFromString(uuid.toString128().c_str()), getter, setter)
         );
     }
 
     // Helper method for adding a named property with a `DBusObjectPath`
     template <typename T>
     T &addProperty(
-        const std::string &name,
+        std::string name,
         const DBusObjectPath &path,
         GDBusInterfaceGetPropertyFunc getter = nullptr,
         GDBusInterfaceSetPropertyFunc setter = nullptr
     ) {
-        return addProperty<T>(GattProperty(name, Utils::gvariantFromObject(path), getter, setter));
+        return addProperty<T>(GattProperty(std::move(name), Utils::gvariantFromObject(path), getter, setter));
     }
 
     // Helper method for adding a named property with a std::strings
     template <typename T>
     T &addProperty(
-        const std::string &name,
+        std::string name,
         const std::string &str,
         GDBusInterfaceGetPropertyFunc getter = nullptr,
         GDBusInterfaceSetPropertyFunc setter = nullptr
     ) {
-        return addProperty<T>(GattProperty(name, Utils::gvariantFromString(str), getter, setter));
+        return addProperty<T>(GattProperty(std::move(name), Utils::gvariantFromString(str), getter, setter));
     }
 
     // Helper method for adding a named property with an array of std::strings
     template <typename T>
     T &addProperty(
-        const std::string &name,
+        std::string name,
         const std::vector<std::string> &arr,
         GDBusInterfaceGetPropertyFunc getter = nullptr,
         GDBusInterfaceSetPropertyFunc setter = nullptr
     ) {
-        return addProperty<T>(GattProperty(name, Utils::gvariantFromStringArray(arr), getter, setter));
+        return addProperty<T>(GattProperty(std::move(name), Utils::gvariantFromStringArray(arr), getter, setter));
     }
 
     // Helper method for adding a named property with an array of C strings
     template <typename T>
     T &addProperty(
-        const std::string &name,
+        std::string name,
         const std::vector<const char *> &arr,
         GDBusInterfaceGetPropertyFunc getter = nullptr,
         GDBusInterfaceSetPropertyFunc setter = nullptr
     ) {
-        return addProperty<T>(GattProperty(name, Utils::gvariantFromStringArray(arr), getter, setter));
+        return addProperty<T>(GattProperty(std::move(name), Utils::gvariantFromStringArray(arr), getter, setter));
     }
 
     // Helper method for adding a named property with a given C string
     template <typename T>
     T &addProperty(
-        const std::string &name,
+        std::string name,
         const char *pStr,
         GDBusInterfaceGetPropertyFunc getter = nullptr,
         GDBusInterfaceSetPropertyFunc setter = nullptr
     ) {
-        return addProperty<T>(GattProperty(name, Utils::gvariantFromString(pStr), getter, setter));
+        return addProperty<T>(GattProperty(std::move(name), Utils::gvariantFromString(pStr), getter, setter));
     }
 
     // Helper method for adding a named property with a given boolean value
     template <typename T>
     T &addProperty(
-        const std::string &name,
+        std::string name,
         bool value,
         GDBusInterfaceGetPropertyFunc getter = nullptr,
         GDBusInterfaceSetPropertyFunc setter = nullptr
     ) {
-        return addProperty<T>(GattProperty(name, Utils::gvariantFromBoolean(value), getter, setter));
+        return addProperty<T>(GattProperty(std::move(name), Utils::gvariantFromBoolean(value), getter, setter));
     }
 
     // Return a data value from the server's registered data getter (GGKServerDataGetter)
@@ -188,6 +199,46 @@ struct GattInterface : DBusInterface {
         return nullptr == pData ? defaultValue : static_cast<const T>(pData);
     }
 
+    // Return a value from the built-in value store (see `ggkDataStoreRegister` in Gobbledegook.h)
+    //
+    // Unlike `getDataValue()`, which routes through the application's getter delegate (and whatever locks the
+    // application takes inside it), this reads the store's seqlock-guarded slot directly and never blocks - a busy
+    // application state machine cannot stall the GATT loop. Returns an empty vector for names not in the store.
+    //
+    // This method is intended to be used in the server description. An example usage would be:
+    //
+    //     const std::vector<guint8> bytes = self.getStoredValue("Huupe/state/get");
+    std::vector<guint8> getStoredValue(const char *pName) const {
+        int capacity = ggkDataStoreCapacity(pName);
+        if (capacity <= 0) {
+            return std::vector<guint8>();
+        }
+
+        std::vector<guint8> bytes(capacity);
+        int count = ggkDataStoreRead(pName, bytes.data(), capacity);
+        bytes.resize(count > 0 ? count : 0);
+        return bytes;
+    }
+
+    // Return a zero-copy view of server data from the registered span getter (GGKServerDataSpanGetter)
+    //
+    // If no span getter is registered (or the getter does not serve this name), the returned span's `pData` is
+    // nullptr and the caller should fall back to `getDataValue()`. The view is only valid for the duration of the
+    // current callback - hand it straight to `Utils::gvariantFromByteArray()` rather than holding onto it.
+    //
+    // This method is intended to be used in the server description. An example usage would be:
+    //
+    //     GGKDataSpan span = self.getDataSpan("Huupe/state/get");
+    GGKDataSpan getDataSpan(const char *pName) const {
+        GGKServerDataSpanGetter getter = TheServer->getDataSpanGetter();
+        if (nullptr == getter) {
+            GGKDataSpan empty = {nullptr, 0, 0};
+            return empty;
+        }
+
+        return getter(pName);
+    }
+
     // Sends a data value from the server back to the application through the server's registered data setter
     // (GGKServerDataSetter)
     //
@@ -23,6 +23,7 @@
 
 #include <gio/gio.h>
 #include <string>
+#include <utility>
 
 #include "GattProperty.h"
 #include "Utils.h"
@@ -34,12 +35,12 @@ namespace ggk {
 // In general, properties should not be constructed directly as properties are typically instanticated by adding them to
 // to an interface using one of the the interface's `addProperty` methods.
 GattProperty::GattProperty(
-    const std::string &name,
+    std::string name,
     GVariant *pValue,
     GDBusInterfaceGetPropertyFunc getter,
     GDBusInterfaceSetPropertyFunc setter
 ) :
-    name(name),
+    name(std::move(name)),
     pValue(pValue),
     getterFunc(getter),
     setterFunc(setter) {}
@@ -57,8 +58,8 @@ const std::string &GattProperty::getName() const {
 //
 // In general, this method should not be called directly as properties are typically added to an interface using one of
 // the the interface's `addProperty` methods.
-GattProperty &GattProperty::setName(const std::string &name) {
-    this->name = name;
+GattProperty &GattProperty::setName(std::string name) {
+    this->name = std::move(name);
     return *this;
 }
 
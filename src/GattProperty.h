@@ -24,6 +24,7 @@
 
 #include <gio/gio.h>
 #include <string>
+#include <utility>
 
 namespace ggk {
 
@@ -36,7 +37,7 @@ struct GattProperty {
     // In general, properties should not be constructed directly as properties are typically instanticated by adding
     // them to to an interface using one of the the interface's `addProperty` methods.
     GattProperty(
-        const std::string &name,
+        std::string name,
         GVariant *pValue,
         GDBusInterfaceGetPropertyFunc getter = nullptr,
         GDBusInterfaceSetPropertyFunc setter = nullptr
@@ -53,7 +54,7 @@ struct GattProperty {
     //
     // In general, this method should not be called directly as properties are typically added to an interface using one
     // of the the interface's `addProperty` methods.
-    GattProperty &setName(const std::string &name);
+    GattProperty &setName(std::string name);
 
     //
     // Value
@@ -39,8 +39,8 @@ namespace ggk {
 // ---------------------------------------------------------------------------------------------------------------------------------
 
 // Standard constructor
-GattService::GattService(DBusObject &owner, const std::string &name) :
-    GattInterface(owner, name) {}
+GattService::GattService(DBusObject &owner, std::string name) :
+    GattInterface(owner, std::move(name)) {}
 
 // Returning the parent pops us one level up the hierarchy
 DBusObject &GattService::gattServiceEnd() {
@@ -72,11 +72,11 @@ DBusObject &GattService::gattServiceEnd() {
 //     "secure-write" (Server only)
 //
 GattCharacteristic &GattService::gattCharacteristicBegin(
-    const std::string &pathElement,
+    std::string pathElement,
     const GattUuid &uuid,
     const std::vector<const char *> &flags
 ) {
-    DBusObject &child = owner.addChild(DBusObjectPath(pathElement));
+    DBusObject &child = owner.addChild(DBusObjectPath(std::move(pathElement)));
     GattCharacteristic &characteristic =
         *child.addInterface(std::make_shared<GattCharacteristic>(child, *this, "org.bluez.GattCharacteristic1"));
     characteristic.addProperty<GattCharacteristic>("UUID", uuid);
@@ -52,7 +52,7 @@ struct GattService : GattInterface {
     static constexpr const char *kInterfaceType = "GattService";
 
     // Standard constructor
-    GattService(DBusObject &owner, const std::string &name);
+    GattService(DBusObject &owner, std::string name);
 
     virtual ~GattService() {}
 
@@ -85,7 +85,7 @@ struct GattService : GattInterface {
     //     "secure-write" (Server only)
     //
     GattCharacteristic &gattCharacteristicBegin(
-        const std::string &pathElement,
+        std::string pathElement,
         const GattUuid &uuid,
         const std::vector<const char *> &flags
     );
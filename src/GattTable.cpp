@@ -0,0 +1,137 @@
+// Copyright 2017-2019 Paul Nettle
+//
+// This file is part of Gobbledegook.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file in the root of the source tree.
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// >>
+// >>>  INSIDE THIS FILE
+// >>
+//
+// A static-table declaration layer for GATT trees, with compile-time validation of UUIDs and paths
+//
+// >>
+// >>>  DISCUSSION
+// >>
+//
+// See the discussion at the top of GattTable.h
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include "GattTable.h"
+#include "DBusObject.h"
+#include "GattService.h"
+#include "GattUuid.h"
+
+namespace ggk {
+
+// Convert a `GattFlag` bitmask into the BlueZ flag-string list the builder methods take
+std::vector<const char *> gattFlagStrings(uint32_t flags) {
+    // One mapping per flag bit, in bit order
+    static const struct {
+        uint32_t flag;
+        const char *pString;
+    } kFlagStrings[] = {
+        {EGattRead, "read"},
+        {EGattWrite, "write"},
+        {EGattWriteWithoutResponse, "write-without-response"},
+        {EGattNotify, "notify"},
+        {EGattIndicate, "indicate"},
+        {EGattEncryptRead, "encrypt-read"},
+        {EGattEncryptWrite, "encrypt-write"},
+        {EGattEncryptAuthenticatedRead, "encrypt-authenticated-read"},
+        {EGattEncryptAuthenticatedWrite, "encrypt-authenticated-write"},
+        {EGattSecureRead, "secure-read"},
+        {EGattSecureWrite, "secure-write"},
+    };
+
+    std::vector<const char *> strings;
+    for (size_t i = 0; i < TABLE_ROWS(kFlagStrings); ++i) {
+        if (0 != (flags & kFlagStrings[i].flag)) {
+            strings.push_back(kFlagStrings[i].pString);
+        }
+    }
+
+    return strings;
+}
+
+// Construct the runtime GATT tree beneath `root` in a single pass over `pServices`
+void buildGattTree(DBusObject &root, const GattServiceTableEntry *pServices, size_t serviceCount) {
+    for (size_t serviceIndex = 0; serviceIndex < serviceCount; ++serviceIndex) {
+        const GattServiceTableEntry &serviceEntry = pServices[serviceIndex];
+        GattService &service = root.gattServiceBegin(serviceEntry.pathElement, GattUuid(serviceEntry.uuid));
+
+        for (size_t characteristicIndex = 0; characteristicIndex < serviceEntry.characteristicCount;
+             ++characteristicIndex) {
+            const GattCharacteristicTableEntry &characteristicEntry =
+                serviceEntry.pCharacteristics[characteristicIndex];
+            GattCharacteristic &characteristic = service.gattCharacteristicBegin(
+                characteristicEntry.pathElement,
+                GattUuid(characteristicEntry.uuid),
+                gattFlagStrings(characteristicEntry.flags)
+            );
+
+            // Any notifying characteristic gets subscription tracking, so updates can be suppressed when nobody is
+            // listening (see `GattCharacteristic::enableNotifySubscriptions`)
+            if (0 != (characteristicEntry.flags & (EGattNotify | EGattIndicate))) {
+                characteristic.enableNotifySubscriptions();
+            }
+
+            if (characteristicEntry.acquireNotify) {
+                characteristic.enableAcquireNotify();
+            }
+
+            if (characteristicEntry.batchNotify) {
+                characteristic.enableNotifyBatching();
+            }
+
+            if (nullptr != characteristicEntry.acquiredWriteCallback) {
+                characteristic.enableAcquireWrite(characteristicEntry.acquiredWriteCallback);
+            }
+
+            if (nullptr != characteristicEntry.onReadValue) {
+                characteristic.onReadValue(characteristicEntry.onReadValue);
+            }
+
+            if (nullptr != characteristicEntry.onWriteValue) {
+                characteristic.onWriteValue(characteristicEntry.onWriteValue);
+            }
+
+            if (nullptr != characteristicEntry.onUpdatedValue) {
+                characteristic.onUpdatedValue(characteristicEntry.onUpdatedValue);
+            }
+
+            for (size_t descriptorIndex = 0; descriptorIndex < characteristicEntry.descriptorCount;
+                 ++descriptorIndex) {
+                const GattDescriptorTableEntry &descriptorEntry = characteristicEntry.pDescriptors[descriptorIndex];
+                GattDescriptor &descriptor = characteristic.gattDescriptorBegin(
+                    descriptorEntry.pathElement,
+                    GattUuid(descriptorEntry.uuid),
+                    gattFlagStrings(descriptorEntry.flags)
+                );
+
+                if (nullptr != descriptorEntry.onReadValue) {
+                    descriptor.onReadValue(descriptorEntry.onReadValue);
+                }
+
+                if (nullptr != descriptorEntry.onWriteValue) {
+                    descriptor.onWriteValue(descriptorEntry.onWriteValue);
+                }
+
+                if (nullptr != descriptorEntry.onUpdatedValue) {
+                    descriptor.onUpdatedValue(descriptorEntry.onUpdatedValue);
+                }
+
+                descriptor.gattDescriptorEnd();
+            }
+
+            characteristic.gattCharacteristicEnd();
+        }
+
+        service.gattServiceEnd();
+    }
+}
+
+}; // namespace ggk
@@ -0,0 +1,168 @@
+// Copyright 2017-2019 Paul Nettle
+//
+// This file is part of Gobbledegook.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file in the root of the source tree.
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// >>
+// >>>  INSIDE THIS FILE
+// >>
+//
+// A static-table declaration layer for GATT trees, with compile-time validation of UUIDs and paths
+//
+// >>
+// >>>  DISCUSSION
+// >>
+//
+// The server description (see Server.cpp) has historically been built with the method-chaining builder
+// (`gattServiceBegin` / `gattCharacteristicBegin` / ...). That builder remains the flexible way to describe a tree,
+// but for a fixed characteristic set it does a fair amount of avoidable runtime work: each `GattUuid` is parsed and
+// normalized from a string, each flag list is staged through an initializer list, and a malformed UUID isn't noticed
+// until the server logs an empty UUID at startup.
+//
+// This file provides an alternative: declare the tree as static tables of plain-old-data entries. The entries hold
+// compile-time parsed binary UUIDs (see the `_uuid` literal in GattUuid.h - a malformed UUID is a compile error),
+// flag bitmasks, and function pointers - all resolved at compile time - and `buildGattTree` turns the tables into
+// the runtime tree in a single pass. A path validation helper (written as a C++11 constexpr function, hence the
+// recursion) lets a `static_assert` next to the table turn a malformed path into a compile error too.
+//
+// A minimal example:
+//
+//     static const GattCharacteristicTableEntry kWidgetCharacteristics[] = {
+//         {"serial", "b381"_uuid, EGattRead, onReadSerial, nullptr, nullptr, false, false, nullptr, nullptr, 0},
+//     };
+//
+//     static const GattServiceTableEntry kWidgetServices[] = {
+//         {"widget", "b380"_uuid, kWidgetCharacteristics, TABLE_ROWS(kWidgetCharacteristics)},
+//     };
+//
+//     static_assert(isValidPathElement("widget") && isValidPathElement("serial"), "Malformed widget path");
+//
+//     buildGattTree(root, kWidgetServices, TABLE_ROWS(kWidgetServices));
+//
+// Note that the callbacks are plain function pointers (the same types the builder takes), so captureless lambdas and
+// named static functions both work.
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "GattCharacteristic.h"
+#include "GattDescriptor.h"
+#include "GattUuid.h"
+
+// Convenience macro for the row count of a static table
+#define TABLE_ROWS(table) (sizeof(table) / sizeof((table)[0]))
+
+namespace ggk {
+
+struct DBusObject;
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Compile-time validation
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// Note: UUID validation lives in the `_uuid` literal itself (see GattUuid.h) - a malformed UUID in a table fails
+// the build at the literal, so there is nothing to static_assert for UUIDs anymore.
+
+// Returns true if `c` is legal within a path element (alphanumerics, '_', and '/' for nested elements)
+constexpr bool isPathElementChar(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || '_' == c || '/' == c;
+}
+
+// Returns true if `pPath` is a non-empty path element made of legal characters. Intended for use in a `static_assert`
+// next to a table definition.
+constexpr bool isValidPathElement(const char *pPath) {
+    return 0 == *pPath ? false
+           : isPathElementChar(*pPath) ? (0 == pPath[1] || isValidPathElement(pPath + 1))
+                                       : false;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Flags
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// Characteristic and descriptor flags as a bitmask
+//
+// These map 1:1 onto the BlueZ flag strings (see the flag lists in GattService.h and GattCharacteristic.h); the
+// bitmask form lets a flag set live in a static table and be validated by the compiler, with the string list built
+// once at tree-construction time (see `gattFlagStrings`.)
+enum GattFlag : uint32_t {
+    EGattRead = 1 << 0,
+    EGattWrite = 1 << 1,
+    EGattWriteWithoutResponse = 1 << 2,
+    EGattNotify = 1 << 3,
+    EGattIndicate = 1 << 4,
+    EGattEncryptRead = 1 << 5,
+    EGattEncryptWrite = 1 << 6,
+    EGattEncryptAuthenticatedRead = 1 << 7,
+    EGattEncryptAuthenticatedWrite = 1 << 8,
+    EGattSecureRead = 1 << 9,
+    EGattSecureWrite = 1 << 10
+};
+
+// Convert a `GattFlag` bitmask into the BlueZ flag-string list the builder methods take
+std::vector<const char *> gattFlagStrings(uint32_t flags);
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Table entries
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// One descriptor within a characteristic (see `GattCharacteristicTableEntry`)
+//
+// Callback fields may be nullptr for callbacks the descriptor doesn't need
+struct GattDescriptorTableEntry {
+    const char *pathElement;
+    GattUuid128 uuid;
+    uint32_t flags;
+    GattDescriptor::MethodCallback onReadValue;
+    GattDescriptor::MethodCallback onWriteValue;
+    GattDescriptor::UpdatedValueCallback onUpdatedValue;
+};
+
+// One characteristic within a service (see `GattServiceTableEntry`)
+//
+// Callback fields may be nullptr for callbacks the characteristic doesn't need. A non-null `acquiredWriteCallback`
+// enables the fd-based write path (see `GattCharacteristic::enableAcquireWrite`); `acquireNotify` enables the
+// fd-based notification path. `batchNotify` packs successive notification values into MTU-sized packets on the
+// fd path (see `GattCharacteristic::enableNotifyBatching` for the caveats) - only set it for characteristics
+// whose payloads are self-delimiting.
+struct GattCharacteristicTableEntry {
+    const char *pathElement;
+    GattUuid128 uuid;
+    uint32_t flags;
+    GattCharacteristic::MethodCallback onReadValue;
+    GattCharacteristic::MethodCallback onWriteValue;
+    GattCharacteristic::UpdatedValueCallback onUpdatedValue;
+    bool acquireNotify;
+    bool batchNotify;
+    GattCharacteristic::AcquiredWriteCallback acquiredWriteCallback;
+    const GattDescriptorTableEntry *pDescriptors;
+    size_t descriptorCount;
+};
+
+// One GATT service
+struct GattServiceTableEntry {
+    const char *pathElement;
+    GattUuid128 uuid;
+    const GattCharacteristicTableEntry *pCharacteristics;
+    size_t characteristicCount;
+};
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Tree construction
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// Construct the runtime GATT tree beneath `root` in a single pass over `pServices`
+//
+// This drives the same builder methods the hand-written chain would (so the resulting tree is indistinguishable from
+// one built by hand), but all of the declaration data comes from the static tables.
+void buildGattTree(DBusObject &root, const GattServiceTableEntry *pServices, size_t serviceCount);
+
+}; // namespace ggk
@@ -48,41 +48,107 @@
 //
 // By represetng a UUID in a custom class like this, we are able to give a UUID its own type, and use type safety to
 // ensure that we don't confuse regular strings with GATT UUIDs throughout the codebase.
+//
+// Internally a UUID is held as its 128-bit binary value (two 64-bit halves) - two words instead of a heap-allocated
+// string per UUID - and the dashed string form is rendered lazily, only when something (D-Bus introspection, the UUID
+// property) actually asks for it.
+//
+// For UUIDs known at compile time there is also the `_uuid` literal (see `GattUuid128`):
+//
+//     constexpr GattUuid128 kMyCharacteristic = "00000002-1E3C-FAD4-74E2-97A033F1BFAA"_uuid;
+//
+// The literal parses to the binary value at compile time, and a malformed literal (wrong digit count, bad characters)
+// is a compile error rather than a runtime surprise. The static GATT tables (see GattTable.h) store these.
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
 #pragma once
 
 #include <algorithm>
 #include <ctype.h>
+#include <stddef.h>
+#include <stdexcept>
 #include <stdint.h>
+#include <stdio.h>
 #include <string>
 
-#include "Logger.h"
-#include <iostream>
-
 namespace ggk {
 
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Compile-time UUID parsing
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// The Base Universally Unique Identifier ("00000000-0000-1000-8000-00805f9b34fb") as two 64-bit halves - short UUIDs
+// are merged into this
+constexpr uint64_t kUuidBaseHi = 0x0000000000001000ull;
+constexpr uint64_t kUuidBaseLo = 0x800000805f9b34fbull;
+
+// A 128-bit binary UUID, parseable at compile time (see the `_uuid` literal below)
+//
+// This is the storage form for UUIDs in static tables; construct a `GattUuid` from it (a free conversion - the
+// parsing already happened at compile time) wherever one is needed.
+struct GattUuid128 {
+    uint64_t hi;
+    uint64_t lo;
+    int bitCount;
+};
+
+// Running state of the compile-time parser: the two halves accumulated so far and the count of hex digits consumed
+struct GattUuidParseState {
+    uint64_t hi;
+    uint64_t lo;
+    int digits;
+};
+
+// Returns the value of the hex digit `c`, or fails the build (when evaluated at compile time) for anything else
+constexpr int uuidHexDigitValue(char c) {
+    return (c >= '0' && c <= '9')   ? c - '0'
+           : (c >= 'a' && c <= 'f') ? c - 'a' + 10
+           : (c >= 'A' && c <= 'F') ? c - 'A' + 10
+                                    : throw std::logic_error("Malformed UUID literal: bad character");
+}
+
+// Consumes one character of a UUID literal (dashes and dots pass through; the first 16 hex digits accumulate into
+// `hi`, the rest into `lo`)
+constexpr GattUuidParseState uuidParseChar(GattUuidParseState state, char c) {
+    return ('-' == c || '.' == c) ? state
+           : state.digits < 16
+               ? GattUuidParseState{(state.hi << 4) | uuidHexDigitValue(c), state.lo, state.digits + 1}
+               : GattUuidParseState{state.hi, (state.lo << 4) | uuidHexDigitValue(c), state.digits + 1};
+}
+
+// Recursively consumes the literal (C++11 constexpr allows only a single return expression, hence the recursion)
+constexpr GattUuidParseState uuidParseString(const char *pStr, GattUuidParseState state) {
+    return 0 == *pStr ? state : uuidParseString(pStr + 1, uuidParseChar(state, *pStr));
+}
+
+// Expands the parsed digits to a full 128-bit UUID (merging 16- and 32-bit forms into the Base UUID), or fails the
+// build for a digit count that isn't 4, 8 or 32
+constexpr GattUuid128 uuidFinalize(GattUuidParseState state) {
+    return (4 == state.digits || 8 == state.digits)
+               ? GattUuid128{kUuidBaseHi | (state.hi << 32), kUuidBaseLo, 4 == state.digits ? 16 : 32}
+           : 32 == state.digits
+               ? GattUuid128{state.hi, state.lo, 128}
+               : throw std::logic_error("Malformed UUID literal: must be 4, 8 or 32 hex digits");
+}
+
+// The UUID literal: `"00000002-1E3C-FAD4-74E2-97A033F1BFAA"_uuid` parses to a `GattUuid128` at compile time, and a
+// malformed literal fails the build
+constexpr GattUuid128 operator"" _uuid(const char *pStr, size_t /*length*/) {
+    return uuidFinalize(uuidParseString(pStr, GattUuidParseState{0, 0, 0}));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// The UUID type
+// ---------------------------------------------------------------------------------------------------------------------------------
+
 // "0000180A-0000-1000-8000-00805f9b34fb"
 struct GattUuid {
     static constexpr const char *kGattStandardUuidPart1Prefix = "0000";
     static constexpr const char *kGattStandardUuidSuffix = "-0000-1000-8000-00805f9b34fb";
 
-    // Construct a GattUuid from a partial or complete string UUID
-    //
-    // This constructor will do the best it can with the data it is given. It will first clean the input by removing all
-    // non-hex characters (see `clean`) and the remaining characters are processed in the following way:
-    //
-    //     4-character string is treated as a 16-bit UUID
-    //     8-character string is treated as a 32-bit UUID
-    //     32-character string is treated as a 128-bit UUID
-    //
-    // If the input string is not one of the above lengths, the  UUID will be left uninitialized as an empty string with
-    // a bit count of 0.
-    //
-    // Finally, dashes are inserted into the string at the appropriate locations (see `dashify`).
-    GattUuid(const char *strUuid) {
-        *this = GattUuid(std::string(strUuid));
-    }
+    // Construct a GattUuid from a compile-time parsed UUID (see the `_uuid` literal.) This is the cheap path - no
+    // parsing, no allocation; the string form is rendered only if something asks for it.
+    GattUuid(const GattUuid128 &binary) : hi(binary.hi), lo(binary.lo), bitCount(binary.bitCount) {}
 
     // Construct a GattUuid from a partial or complete string UUID
     //
@@ -93,27 +159,40 @@ struct GattUuid {
     //     8-character string is treated as a 32-bit UUID
     //     32-character string is treated as a 128-bit UUID
     //
-    // If the input string is not one of the above lengths, the  UUID will be left uninitialized as an empty string with
-    // a bit count of 0.
-    //
-    // Finally, dashes are inserted into the string at the appropriate locations (see `dashify`).
-    GattUuid(std::string strUuid) {
+    // If the input string is not one of the above lengths, the UUID will be left uninitialized (an empty string form
+    // with a bit count of 0.)
+    GattUuid(const char *strUuid) : GattUuid(std::string(strUuid)) {}
+
+    // Construct a GattUuid from a partial or complete string UUID (see the `const char *` form above)
+    GattUuid(std::string strUuid) : hi(0), lo(0), bitCount(0) {
         // Clean the string
         strUuid = clean(strUuid);
 
         // It's hex, so each character represents 4 bits
-        bitCount = strUuid.length() * 4;
+        const int digits = static_cast<int>(strUuid.length());
+        if (4 != digits && 8 != digits && 32 != digits) {
+            return;
+        }
 
-        if (bitCount == 16) {
-            strUuid = kGattStandardUuidPart1Prefix + strUuid + kGattStandardUuidSuffix;
-        } else if (bitCount == 32) {
-            strUuid += kGattStandardUuidSuffix;
-        } else if (bitCount != 128) {
-            bitCount = 0;
-            strUuid = "";
+        for (int i = 0; i < digits; ++i) {
+            const char c = strUuid[i];
+            const uint64_t value = c <= '9' ? c - '0' : c - 'a' + 10;
+
+            // Short forms fit entirely in `hi`; the 128-bit form splits after its first 16 digits
+            if (digits <= 16 || i < 16) {
+                hi = (hi << 4) | value;
+            } else {
+                lo = (lo << 4) | value;
+            }
         }
 
-        uuid = dashify(strUuid);
+        if (32 == digits) {
+            bitCount = 128;
+        } else {
+            bitCount = digits * 4;
+            hi = kUuidBaseHi | (hi << 32);
+            lo = kUuidBaseLo;
+        }
     }
 
     // Constructs a GattUuid from a 16-bit Uuid value
@@ -123,12 +202,8 @@ struct GattUuid {
     //     0000????-0000-1000-8000-00805f9b34fb
     //
     // ...where "????" is replaced by the 4-digit hex value of `part`
-    GattUuid(const uint16_t part) {
-        bitCount = 16;
-        char partStr[5];
-        snprintf(partStr, sizeof(partStr), "%04x", part);
-        uuid = std::string(kGattStandardUuidPart1Prefix) + partStr + kGattStandardUuidSuffix;
-    }
+    GattUuid(const uint16_t part)
+        : hi(kUuidBaseHi | (static_cast<uint64_t>(part) << 32)), lo(kUuidBaseLo), bitCount(16) {}
 
     // Constructs a GattUuid from a 32-bit Uuid value
     //
@@ -137,12 +212,8 @@ struct GattUuid {
     //     ????????-0000-1000-8000-00805f9b34fb
     //
     // ...where "????????" is replaced by the 8-digit hex value of `part`
-    GattUuid(const uint32_t part) {
-        bitCount = 32;
-        char partStr[9];
-        snprintf(partStr, sizeof(partStr), "%08x", part);
-        uuid = std::string(partStr) + kGattStandardUuidSuffix;
-    }
+    GattUuid(const uint32_t part)
+        : hi(kUuidBaseHi | (static_cast<uint64_t>(part) << 32)), lo(kUuidBaseLo), bitCount(32) {}
 
     // Constructs a GattUuid from a 5-part set of input values
     //
@@ -160,24 +231,10 @@ struct GattUuid {
         const uint16_t part3,
         const uint16_t part4,
         const uint64_t part5
-    ) {
-        bitCount = 128;
-        char partsStr[37];
-        uint32_t part5a = (part5 >> 4) & 0xffffffff;
-        uint32_t part5b = part5 & 0xffff;
-        snprintf(
-            partsStr,
-            sizeof(partsStr),
-            "%08x-%04x-%04x-%04x-%08x%04x",
-            part1,
-            part2,
-            part3,
-            part4,
-            part5a,
-            part5b
-        );
-        uuid = std::string(partsStr);
-    }
+    )
+        : hi((static_cast<uint64_t>(part1) << 32) | (static_cast<uint64_t>(part2) << 16) | part3),
+          lo((static_cast<uint64_t>(part4) << 48) | (part5 & 0xffffffffffffull)),
+          bitCount(128) {}
 
     // Returns the bit count of the input when the GattUuid was constructed. Valid values are 16, 32, 128.
     //
@@ -191,25 +248,25 @@ struct GattUuid {
     // Note that a 16-bit GATT UUID is only valid for standarg GATT UUIDs (prefixed with "0000" and ending with
     // "0000-1000-8000-00805f9b34fb").
     std::string toString16() const {
-        if (uuid.empty()) {
-            return uuid;
+        if (0 == bitCount) {
+            return std::string();
         }
-        return uuid.substr(4, 4);
+        return render().substr(4, 4);
     }
 
     // Returns the 32-bit portion of the GATT UUID or an empty string if the GattUuid was not created correctly
     //
     // Note that a 32-bit GATT UUID is only valid for standarg GATT UUIDs (ending with "0000-1000-8000-00805f9b34fb").
     std::string toString32() const {
-        if (uuid.empty()) {
-            return uuid;
+        if (0 == bitCount) {
+            return std::string();
         }
-        return uuid.substr(0, 8);
+        return render().substr(0, 8);
     }
 
     // Returns the full 128-bit GATT UUID or an empty string if the GattUuid was not created correctly
     std::string toString128() const {
-        return uuid;
+        return render();
     }
 
     // Returns a string form of the UUID, based on the bit count used when the UUID was created. A 16-bit UUID will
@@ -282,8 +339,36 @@ struct GattUuid {
     }
 
 private:
-    std::string uuid;
+    // Renders (and caches) the dashed 128-bit string form from the binary value
+    //
+    // This is the lazy half of the binary representation: most UUIDs are only ever compared and copied, so the
+    // string form isn't built until something (introspection, the UUID property) asks for it.
+    const std::string &render() const {
+        if (uuid.empty() && 0 != bitCount) {
+            char buffer[37];
+            snprintf(
+                buffer,
+                sizeof(buffer),
+                "%08x-%04x-%04x-%04x-%012llx",
+                static_cast<uint32_t>(hi >> 32),
+                static_cast<uint32_t>((hi >> 16) & 0xffff),
+                static_cast<uint32_t>(hi & 0xffff),
+                static_cast<uint32_t>(lo >> 48),
+                static_cast<unsigned long long>(lo & 0xffffffffffffull)
+            );
+            uuid = buffer;
+        }
+
+        return uuid;
+    }
+
+    // The 128-bit binary value (two 64-bit halves, most significant first)
+    uint64_t hi;
+    uint64_t lo;
     int bitCount;
+
+    // The lazily rendered string form (see `render`)
+    mutable std::string uuid;
 };
 
 }; // namespace ggk
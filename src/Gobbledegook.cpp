@@ -36,16 +36,23 @@
 //     Server control - running and stopping the server
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
-#include <deque>
+#include <atomic>
 #include <memory>
 #include <mutex>
+#include <stdint.h>
+#include <stdio.h>
 #include <string.h>
 #include <string>
 #include <thread>
 
+#include "GattCharacteristic.h"
 #include "Init.h"
 #include "Logger.h"
+#include "Metrics.h"
+#include "Mgmt.h"
 #include "Server.h"
+#include "StreamEngine.h"
+#include "Trace.h"
 
 namespace ggk {
 // During initialization, we'll check for complation at this interval
@@ -60,15 +67,467 @@ volatile static GGKServerRunState serverRunState = EUninitialized;
 // The current server health
 volatile static GGKServerHealth serverHealth = EOk;
 
+// The application's optional zero-copy data getter (see `ggkRegisterDataSpanGetter`)
+static GGKServerDataSpanGetter serverDataSpanGetter = nullptr;
+
+// The HCI controller index the next `ggkStart` will bind its server to (see `ggkStartOnAdapter`)
+static int startControllerIndex = 0;
+
 // We store the old GLib print handler and error print handler so we can restore if
 static GPrintFunc printHandlerGLib;
 static GPrintFunc printerrHandlerGLib;
 static GLogFunc logHandlerGLib;
 
+//
 // Our update queue
-typedef std::tuple<std::string, std::string> QueueEntry;
-std::deque<QueueEntry> updateQueue;
-std::mutex updateQueueMutex;
+//
+// This is a lock-free, bounded, multi-producer/single-consumer ring queue. Producers are the application's data
+// threads (calling `ggkNofifyUpdatedCharacteristic` et al) and the single consumer is the GLib main loop (see the
+// update dispatcher in Init.cpp.) Entries are fixed-size so that a push never allocates and producers never block each
+// other or the consumer.
+//
+// The design follows the well-known bounded MPMC queue by Dmitry Vyukov: each slot carries a sequence number that
+// tells producers when the slot is free and tells the consumer when the slot is filled.
+//
+// There are actually three of these rings - one per priority lane (see `GGKUpdatePriority`.) A bulk transfer can
+// flood the queue with hundreds of data-chunk updates, and with a single FIFO a critical control update (an e-stop
+// status change, say) would queue behind all of them. The consumer drains the lanes in strict priority order
+// (control, then normal, then bulk), so a control update is always the next entry dispatched no matter how deep the
+// bulk lane is. Strict priority can starve the bulk lane outright, so the consumer grants it one entry after every
+// `kUpdateQueueBulkStarvationLimit` consecutive higher-lane pops - bulk progress degrades under control pressure
+// but never stops.
+//
+
+// The capacity of the update queue (must be a power of two.) If the queue fills (the consumer has stalled or the
+// producers are badly outrunning it), pushes will fail until the consumer catches up.
+static const uint32_t kUpdateQueueCapacity = 1024;
+
+// Maximum lengths (including null terminator) for the two strings carried by a queue entry
+static const size_t kUpdateQueueMaxPathLength = 160;
+static const size_t kUpdateQueueMaxInterfaceLength = 64;
+
+// A single fixed-size slot in the update queue
+//
+// The `sequence` field implements the lock-free handshake: a slot is free for a producer at position `pos` when
+// `sequence == pos`, and filled for the consumer when `sequence == pos + 1`.
+//
+// `pathId` is the interned-path ID for the entry (see the interning table below), or -1 for an entry pushed by path
+// string. When `pathId` is valid, the string fields are unused - the strings live in the interning table.
+struct QueueEntry {
+    std::atomic<uint32_t> sequence;
+    int32_t pathId;
+
+    // When the entry was pushed (see `Metrics::timestampNS`) - the dispatcher uses this for push-to-signal latency
+    uint64_t pushTimeNS;
+
+    char objectPath[kUpdateQueueMaxPathLength];
+    char interfaceName[kUpdateQueueMaxInterfaceLength];
+};
+
+//
+// Our interned update paths
+//
+// Pushing an update by path string costs a string copy on every push and a hash of the full path on every dispatch.
+// For paths that update frequently (streaming characteristics), the application can intern the (objectPath,
+// interfaceName) pair once at startup (see `ggkInternCharacteristicPath`) and push by the returned small integer ID
+// instead. Interned pushes copy nothing, and the dispatcher resolves them by array index.
+//
+// The table is append-only: IDs are never reused and entries are immutable once published, so readers need no lock.
+//
+
+// The maximum number of interned paths. This comfortably covers every characteristic and descriptor in our tree.
+static const int kMaxInternedUpdatePaths = 64;
+
+// One interned (objectPath, interfaceName) pair
+struct InternedUpdatePath {
+    char objectPath[kUpdateQueueMaxPathLength];
+    char interfaceName[kUpdateQueueMaxInterfaceLength];
+};
+
+// The interning table and the count of entries in it. The count is atomic so producers can validate an ID without
+// taking the interning lock.
+static InternedUpdatePath internedUpdatePaths[kMaxInternedUpdatePaths];
+static std::atomic<int> internedUpdatePathCount(0);
+
+// Serializes additions to the interning table (interning is a cold, startup-time operation)
+static std::mutex internedUpdatePathMutex;
+
+// Interns an (objectPath, interfaceName) pair, returning its ID
+//
+// If the pair is already interned, the existing ID is returned. Returns -1 if the table is full or either string is
+// too long for a fixed-size entry.
+static int internUpdatePath(const char *pObjectPath, const char *pInterfaceName) {
+    if (strlen(pObjectPath) >= kUpdateQueueMaxPathLength || strlen(pInterfaceName) >= kUpdateQueueMaxInterfaceLength) {
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> lock(internedUpdatePathMutex);
+
+    int count = internedUpdatePathCount.load(std::memory_order_relaxed);
+    for (int id = 0; id < count; ++id) {
+        if (strcmp(internedUpdatePaths[id].objectPath, pObjectPath) == 0 &&
+            strcmp(internedUpdatePaths[id].interfaceName, pInterfaceName) == 0) {
+            return id;
+        }
+    }
+
+    if (count >= kMaxInternedUpdatePaths) {
+        return -1;
+    }
+
+    snprintf(internedUpdatePaths[count].objectPath, kUpdateQueueMaxPathLength, "%s", pObjectPath);
+    snprintf(internedUpdatePaths[count].interfaceName, kUpdateQueueMaxInterfaceLength, "%s", pInterfaceName);
+
+    // Publish the new entry - the release pairs with the acquire in the ID validation on the push path
+    internedUpdatePathCount.store(count + 1, std::memory_order_release);
+    return count;
+}
+
+// The number of slots in the coalescing table (must be a power of two.) Each slot holds the hash tag of a pending
+// (objectPath, interfaceName) pair, or zero when nothing with that hash is pending.
+static const uint32_t kUpdateQueueCoalescingSlots = 256;
+
+// The update queue itself
+//
+// The constructor seeds each slot's sequence number with its own index, marking every slot as free.
+struct UpdateQueue {
+    UpdateQueue() {
+        for (uint32_t i = 0; i < kUpdateQueueCapacity; ++i) {
+            entries[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        for (uint32_t i = 0; i < kUpdateQueueCoalescingSlots; ++i) {
+            pendingTags[i].store(0, std::memory_order_relaxed);
+        }
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+        maxSize.store(kUpdateQueueCapacity, std::memory_order_relaxed);
+        coalescingEnabled.store(false, std::memory_order_relaxed);
+        lastPoppedPushTimeNS = 0;
+        totalPushed.store(0, std::memory_order_relaxed);
+        totalPopped.store(0, std::memory_order_relaxed);
+        totalCoalesced.store(0, std::memory_order_relaxed);
+        totalDropped.store(0, std::memory_order_relaxed);
+    }
+
+    // Hash an (objectPath, interfaceName) pair into a non-zero tag for the coalescing table (FNV-1a)
+    static uint32_t hashPair(const char *pObjectPath, const char *pInterfaceName) {
+        uint32_t hash = 2166136261u;
+        for (const char *p = pObjectPath; *p != 0; ++p) {
+            hash = (hash ^ static_cast<uint8_t>(*p)) * 16777619u;
+        }
+        hash = (hash ^ static_cast<uint8_t>('|')) * 16777619u;
+        for (const char *p = pInterfaceName; *p != 0; ++p) {
+            hash = (hash ^ static_cast<uint8_t>(*p)) * 16777619u;
+        }
+
+        // Zero means "no entry pending", so steer clear of it
+        return hash == 0 ? 1 : hash;
+    }
+
+    // Tag an interned-path ID for the coalescing table
+    //
+    // The high bit keeps ID tags well away from zero; a collision with an FNV tag is no worse than an FNV/FNV
+    // collision.
+    static uint32_t tagForId(int32_t pathId) {
+        return 0x80000000u | static_cast<uint32_t>(pathId);
+    }
+
+    // Push an entry onto the queue (any thread)
+    //
+    // `pathId` is an interned-path ID, or -1 to push by the given strings. Returns true on success or false if the
+    // queue is full or either string is too long for a fixed-size slot.
+    bool push(const char *pObjectPath, const char *pInterfaceName, int32_t pathId) {
+        totalPushed.fetch_add(1, std::memory_order_relaxed);
+
+        // Reject anything that won't fit in a slot - better to fail loudly here than truncate an object path.
+        // Interned entries were validated (and copied) at interning time, so they skip both the check and the copy.
+        if (pathId < 0 &&
+            (strlen(pObjectPath) >= kUpdateQueueMaxPathLength ||
+             strlen(pInterfaceName) >= kUpdateQueueMaxInterfaceLength)) {
+            totalDropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        // Coalescing: keep at most one pending entry per (objectPath, interfaceName) pair. If the pair is already
+        // pending, this push is covered by the pending entry (entries carry no payload - the newest data is read when
+        // the update is dispatched), so we can fold it away without queueing anything.
+        bool tagClaimed = false;
+        uint32_t tag = 0;
+        uint32_t tagIndex = 0;
+        if (coalescingEnabled.load(std::memory_order_relaxed)) {
+            tag = pathId >= 0 ? tagForId(pathId) : hashPair(pObjectPath, pInterfaceName);
+            tagIndex = tag & (kUpdateQueueCoalescingSlots - 1);
+
+            uint32_t expected = 0;
+            if (pendingTags[tagIndex].compare_exchange_strong(expected, tag, std::memory_order_acq_rel)) {
+                tagClaimed = true;
+            } else if (expected == tag) {
+                // Same pair already pending - newest wins by virtue of the dispatcher reading current data
+                totalCoalesced.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+            // A different pair hashed into the same slot - just push uncoalesced
+        }
+
+        // Backpressure: respect the configured soft bound
+        if (size() >= maxSize.load(std::memory_order_relaxed)) {
+            if (tagClaimed) {
+                pendingTags[tagIndex].store(0, std::memory_order_release);
+            }
+            totalDropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        uint32_t pos = head.load(std::memory_order_relaxed);
+        for (;;) {
+            QueueEntry &entry = entries[pos & (kUpdateQueueCapacity - 1)];
+            uint32_t seq = entry.sequence.load(std::memory_order_acquire);
+            int32_t dif = static_cast<int32_t>(seq) - static_cast<int32_t>(pos);
+
+            if (dif == 0) {
+                // The slot is free - try to claim it
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    entry.pathId = pathId;
+                    entry.pushTimeNS = Metrics::timestampNS();
+                    if (pathId < 0) {
+                        snprintf(entry.objectPath, sizeof(entry.objectPath), "%s", pObjectPath);
+                        snprintf(entry.interfaceName, sizeof(entry.interfaceName), "%s", pInterfaceName);
+                    }
+
+                    // Publish the slot to the consumer
+                    entry.sequence.store(pos + 1, std::memory_order_release);
+                    Metrics::recordUpdateQueueDepth(size());
+                    return true;
+                }
+            } else if (dif < 0) {
+                // The slot is still occupied by an entry from a lap ago - the queue is full
+                if (tagClaimed) {
+                    pendingTags[tagIndex].store(0, std::memory_order_release);
+                }
+                totalDropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                // Another producer claimed this slot - move along
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Pop the oldest entry from the queue (consumer thread only)
+    //
+    // If `pPathId` is non-null, it receives the entry's interned-path ID (or -1 for a string entry.) See
+    // `ggkPopUpdateQueue` for the meaning of the other parameters and the return values.
+    int pop(char *pElementBuffer, int elementLen, int keep, int *pPathId) {
+        uint32_t pos = tail.load(std::memory_order_relaxed);
+        QueueEntry &entry = entries[pos & (kUpdateQueueCapacity - 1)];
+        uint32_t seq = entry.sequence.load(std::memory_order_acquire);
+
+        // If the slot hasn't been published yet, the queue is empty
+        if (static_cast<int32_t>(seq) - static_cast<int32_t>(pos + 1) < 0) {
+            return 0;
+        }
+
+        // Interned entries carry no strings - they index straight into the interning table
+        const char *pObjectPath = entry.pathId >= 0 ? internedUpdatePaths[entry.pathId].objectPath : entry.objectPath;
+        const char *pInterfaceName =
+            entry.pathId >= 0 ? internedUpdatePaths[entry.pathId].interfaceName : entry.interfaceName;
+
+        // Build the result string ("com/object/path|com.interface.name")
+        size_t pathLen = strlen(pObjectPath);
+        size_t interfaceLen = strlen(pInterfaceName);
+        if (pathLen + 1 + interfaceLen + 1 > static_cast<size_t>(elementLen)) {
+            return -1;
+        }
+
+        memcpy(pElementBuffer, pObjectPath, pathLen);
+        pElementBuffer[pathLen] = '|';
+        memcpy(pElementBuffer + pathLen + 1, pInterfaceName, interfaceLen + 1);
+
+        if (nullptr != pPathId) {
+            *pPathId = entry.pathId;
+        }
+
+        // Remember when this entry was pushed, for the dispatcher's push-to-signal latency measurement (single
+        // consumer, so a plain field is fine - see `updateQueueLastPoppedPushTimeNS`)
+        lastPoppedPushTimeNS = entry.pushTimeNS;
+
+        if (keep == 0) {
+            // Clear this pair's pending tag so the next push for it enqueues a fresh entry. This happens before the
+            // update is dispatched, so a push racing with the dispatch is still covered (the dispatcher reads current
+            // data.) A CAS failure here just means the slot was claimed by a colliding pair - that's fine.
+            uint32_t tag = entry.pathId >= 0 ? tagForId(entry.pathId) : hashPair(pObjectPath, pInterfaceName);
+            uint32_t expected = tag;
+            pendingTags[tag & (kUpdateQueueCoalescingSlots - 1)].compare_exchange_strong(
+                expected,
+                0,
+                std::memory_order_acq_rel
+            );
+
+            // Release the slot back to the producers (a full lap ahead)
+            entry.sequence.store(pos + kUpdateQueueCapacity, std::memory_order_release);
+            tail.store(pos + 1, std::memory_order_relaxed);
+            totalPopped.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        return 1;
+    }
+
+    // Returns the approximate number of entries in the queue
+    uint32_t size() const {
+        uint32_t headPos = head.load(std::memory_order_relaxed);
+        uint32_t tailPos = tail.load(std::memory_order_relaxed);
+        return headPos >= tailPos ? headPos - tailPos : 0;
+    }
+
+    // Head (producer) position - the next slot to be claimed by a push
+    std::atomic<uint32_t> head;
+
+    // Tail (consumer) position - the next slot to be read by a pop
+    std::atomic<uint32_t> tail;
+
+    // The configured soft bound on pending entries (backpressure)
+    std::atomic<uint32_t> maxSize;
+
+    // Whether per-path coalescing is enabled
+    std::atomic<bool> coalescingEnabled;
+
+    // The push timestamp of the most recently popped entry (consumer thread only)
+    uint64_t lastPoppedPushTimeNS;
+
+    // Statistics (see `GGKUpdateQueueStats`)
+    std::atomic<uint32_t> totalPushed;
+    std::atomic<uint32_t> totalPopped;
+    std::atomic<uint32_t> totalCoalesced;
+    std::atomic<uint32_t> totalDropped;
+
+    // The coalescing table - hash tags of currently-pending (objectPath, interfaceName) pairs
+    std::atomic<uint32_t> pendingTags[kUpdateQueueCoalescingSlots];
+
+    // The ring of fixed-size slots
+    QueueEntry entries[kUpdateQueueCapacity];
+};
+
+// The number of priority lanes (indexed by `GGKUpdatePriority`)
+static const int kUpdateQueueLaneCount = 3;
+
+// The priority lanes, highest priority first (see the discussion above)
+static UpdateQueue updateQueues[kUpdateQueueLaneCount];
+
+// Starvation protection for the bulk lane: after this many consecutive pops from the higher lanes while bulk
+// entries are waiting, the consumer services one bulk entry regardless. Sixteen control/normal dispatches cost well
+// under a connection interval, so this bounds the bulk lane's added latency to a figure the transfer never notices.
+static const uint32_t kUpdateQueueBulkStarvationLimit = 16;
+
+// Consecutive pops from the non-bulk lanes while the bulk lane was non-empty (consumer thread only)
+static uint32_t updateQueueHigherLanePops = 0;
+
+// The push timestamp of the most recently popped entry, across all lanes (consumer thread only)
+static uint64_t updateQueueDispatchedPushTimeNS = 0;
+
+// Pop the next entry across the priority lanes (consumer thread only)
+//
+// Lanes are drained in strict priority order, except that the bulk lane is granted one entry whenever the higher
+// lanes have monopolized `kUpdateQueueBulkStarvationLimit` consecutive pops while bulk entries waited. Parameters
+// and return values are those of `ggkPopUpdateQueue`. Note that with `keep` set, the lane choice is re-evaluated on
+// the next call - a kept entry can be superseded by a higher-priority arrival.
+static int popUpdateQueuePrioritized(char *pElementBuffer, int elementLen, int keep, int *pPathId) {
+    bool bBulkWaiting = updateQueues[GGK_PRIO_BULK].size() != 0;
+
+    int lane = GGK_PRIO_BULK;
+    if (!bBulkWaiting || updateQueueHigherLanePops < kUpdateQueueBulkStarvationLimit) {
+        if (updateQueues[GGK_PRIO_CONTROL].size() != 0) {
+            lane = GGK_PRIO_CONTROL;
+        } else if (updateQueues[GGK_PRIO_NORMAL].size() != 0) {
+            lane = GGK_PRIO_NORMAL;
+        }
+    }
+
+    int result = updateQueues[lane].pop(pElementBuffer, elementLen, keep, pPathId);
+    if (result != 1 || keep != 0) {
+        return result;
+    }
+
+    if (lane == GGK_PRIO_BULK) {
+        updateQueueHigherLanePops = 0;
+    } else if (bBulkWaiting) {
+        updateQueueHigherLanePops += 1;
+    }
+
+    updateQueueDispatchedPushTimeNS = updateQueues[lane].lastPoppedPushTimeNS;
+    return result;
+}
+
+// Returns the approximate number of entries pending across all lanes
+static uint32_t updateQueueTotalSize() {
+    uint32_t total = 0;
+    for (int lane = 0; lane < kUpdateQueueLaneCount; ++lane) {
+        total += updateQueues[lane].size();
+    }
+    return total;
+}
+
+// Returns the push timestamp of the most recently popped queue entry
+//
+// Only meaningful on the consumer (main loop) thread, between a pop and the next one - which is exactly where the
+// update dispatcher measures push-to-signal latency (see Init.cpp.)
+uint64_t updateQueueLastPoppedPushTimeNS() {
+    return updateQueueDispatchedPushTimeNS;
+}
+
+//
+// Our built-in value store
+//
+// Application threads publish values into the store (`ggkDataStorePublish`) and the server thread reads them back
+// (`ggkDataStoreRead`, or `getStoredValue` in the server description) without ever touching an application lock.
+// Each named slot is protected by a seqlock: a publish bumps the slot's sequence to an odd value, copies the bytes,
+// and bumps it even again; a read snapshots the bytes and retries on the (rare) occasion a publish overlapped it.
+// Readers therefore never block, and a busy application state machine can no longer stall the GATT loop.
+//
+// Slots are registered up front (`ggkDataStoreRegister`) with a fixed capacity, so publishes and reads never
+// allocate. Publishes to the same slot are serialized by a mutex - that is writer-vs-writer only and never touches
+// the read path.
+//
+
+// The maximum number of named slots in the store
+static const int kDataStoreMaxSlots = 32;
+
+// Maximum length (including null terminator) for a slot name
+static const size_t kDataStoreMaxNameLength = 64;
+
+// One named slot in the store
+struct DataStoreSlot {
+    char name[kDataStoreMaxNameLength];
+
+    // The value buffer (allocated once, at registration) and its fixed capacity
+    uint8_t *pBuffer;
+    uint32_t capacity;
+
+    // The number of valid bytes in the buffer (guarded by the seqlock)
+    uint32_t count;
+
+    // The seqlock sequence: odd while a publish is copying, even when the slot is stable
+    std::atomic<uint32_t> sequence;
+};
+
+// The store's slots and the count of registered slots. The count is atomic so readers can scan without taking the
+// store lock.
+static DataStoreSlot dataStoreSlots[kDataStoreMaxSlots];
+static std::atomic<int> dataStoreSlotCount(0);
+
+// Serializes registrations and publishes (never taken on the read path)
+static std::mutex dataStoreMutex;
+
+// Returns the slot registered under `pName`, or nullptr if there isn't one
+static DataStoreSlot *findDataStoreSlot(const char *pName) {
+    int count = dataStoreSlotCount.load(std::memory_order_acquire);
+    for (int i = 0; i < count; ++i) {
+        if (strcmp(dataStoreSlots[i].name, pName) == 0) {
+            return &dataStoreSlots[i];
+        }
+    }
+
+    return nullptr;
+}
 
 // Internal method to set the run state of the server
 void setServerRunState(GGKServerRunState newState) {
@@ -136,6 +595,18 @@ void ggkLogRegisterAlways(GGKLogReceiver receiver) {
     Logger::registerAlwaysReceiver(receiver);
 }
 
+void ggkLogEnableAsync() {
+    Logger::enableAsync();
+}
+
+void ggkLogDisableAsync() {
+    Logger::disableAsync();
+}
+
+uint32_t ggkGetLogDroppedMessageCount() {
+    return Logger::droppedMessageCount();
+}
+
 // ---------------------------------------------------------------------------------------------------------------------------------
 //  _   _           _       _ _
 // | | | |_ __   __| | __ _| |_ ___     __ _ _   _  ___ _   _  ___    _ __ ___   __ _ _ __   __ _  __ _  ___ _ __ ___
@@ -150,6 +621,18 @@ void ggkLogRegisterAlways(GGKLogReceiver receiver) {
 // communicate), these methods are thread-safe.
 // ---------------------------------------------------------------------------------------------------------------------------------
 
+// Registers the application's zero-copy data span getter (see `GGKServerDataSpanGetter` in Gobbledegook.h)
+//
+// This may be called before or after `ggkStart()`. Pass NULL to unregister.
+void ggkRegisterDataSpanGetter(GGKServerDataSpanGetter getter) {
+    serverDataSpanGetter = getter;
+
+    // If the server is already up, hand the getter to it directly (otherwise `ggkStart` will)
+    if (nullptr != TheServer) {
+        TheServer->setDataSpanGetter(getter);
+    }
+}
+
 // Adds an update to the front of the queue for a characteristic at the given object path
 //
 // Returns non-zero value on success or 0 on failure.
@@ -164,15 +647,140 @@ int ggkNofifyUpdatedDescriptor(const char *pObjectPath) {
     return ggkPushUpdateQueue(pObjectPath, "org.bluez.GattDescriptor1") != 0;
 }
 
+// Adds updates for several characteristics at once, dispatching them together
+//
+// The entries are queued as a group and the main loop is woken exactly once, so all of the resulting notifications
+// are emitted within a single main-loop dispatch (and flushed to the bus together) rather than one wakeup and flush
+// per path. Use this when related characteristics (say, state and settings) change as a unit.
+//
+// Returns the number of paths successfully queued (which may be less than `count` if the queue fills.)
+int ggkNofifyUpdatedCharacteristics(const char **ppObjectPaths, int count) {
+    if (nullptr == ppObjectPaths || count <= 0) {
+        return 0;
+    }
+
+    int queued = 0;
+    for (int i = 0; i < count; ++i) {
+        if (nullptr == ppObjectPaths[i]) {
+            continue;
+        }
+
+        if (!updateQueues[GGK_PRIO_NORMAL].push(ppObjectPaths[i], "org.bluez.GattCharacteristic1", -1)) {
+            Logger::warn(
+                SSTR << "Update queue rejected an update for path '" << ppObjectPaths[i] << "' (queue full?)"
+            );
+            continue;
+        }
+
+        ++queued;
+    }
+
+    // One wakeup for the whole batch - the dispatcher drains the queue in a single pass
+    if (queued > 0) {
+        triggerUpdateDispatch();
+    }
+
+    return queued;
+}
+
 // Adds a named update to the front of the queue. Generally, this routine should not be used directly. Instead, use the
 // `ggkNofifyUpdatedCharacteristic()` instead.
 //
 // Returns non-zero value on success or 0 on failure.
 int ggkPushUpdateQueue(const char *pObjectPath, const char *pInterfaceName) {
-    QueueEntry t(pObjectPath, pInterfaceName);
+    if (!updateQueues[GGK_PRIO_NORMAL].push(pObjectPath, pInterfaceName, -1)) {
+        Logger::warn(SSTR << "Update queue rejected an update for path '" << pObjectPath << "' (queue full?)");
+        return 0;
+    }
+
+    // Wake the main loop so the update is dispatched immediately
+    triggerUpdateDispatch();
+    return 1;
+}
+
+// Interns the (objectPath, "org.bluez.GattCharacteristic1") pair, returning an ID for use with
+// `ggkNofifyUpdatedCharacteristicById()`
+//
+// Returns the ID (>= 0) on success or -1 on failure (see Gobbledegook.h for details)
+int ggkInternCharacteristicPath(const char *pObjectPath) {
+    return internUpdatePath(pObjectPath, "org.bluez.GattCharacteristic1");
+}
+
+// Interns the (objectPath, "org.bluez.GattDescriptor1") pair, returning an ID for use with
+// `ggkNofifyUpdatedCharacteristicById()`
+//
+// Returns the ID (>= 0) on success or -1 on failure (see Gobbledegook.h for details)
+int ggkInternDescriptorPath(const char *pObjectPath) {
+    return internUpdatePath(pObjectPath, "org.bluez.GattDescriptor1");
+}
+
+// Adds an update to the front of the queue for a previously interned path (characteristic or descriptor)
+//
+// This is the allocation-free fast path for high-rate updates - nothing is copied onto the queue and the dispatcher
+// resolves the target by array index rather than by string.
+//
+// Returns non-zero value on success or 0 on failure.
+int ggkNofifyUpdatedCharacteristicById(int pathId) {
+    // Validate against the published count (the acquire pairs with the release in the interning)
+    if (pathId < 0 || pathId >= internedUpdatePathCount.load(std::memory_order_acquire)) {
+        return 0;
+    }
+
+    if (!updateQueues[GGK_PRIO_NORMAL].push(nullptr, nullptr, pathId)) {
+        Logger::warn(SSTR << "Update queue rejected an update for interned path " << pathId << " (queue full?)");
+        return 0;
+    }
+
+    // Wake the main loop so the update is dispatched immediately
+    triggerUpdateDispatch();
+    return 1;
+}
 
-    std::lock_guard<std::mutex> guard(updateQueueMutex);
-    updateQueue.push_front(t);
+// Adds an update for a characteristic to the given priority lane (see `GGKUpdatePriority` in Gobbledegook.h)
+//
+// Returns non-zero value on success or 0 on failure (including an invalid priority.)
+int ggkNofifyUpdatedCharacteristicWithPriority(const char *pObjectPath, enum GGKUpdatePriority priority) {
+    int lane = static_cast<int>(priority);
+    if (lane < GGK_PRIO_CONTROL || lane > GGK_PRIO_BULK) {
+        return 0;
+    }
+
+    if (!updateQueues[lane].push(pObjectPath, "org.bluez.GattCharacteristic1", -1)) {
+        Logger::warn(SSTR << "Update queue rejected an update for path '" << pObjectPath << "' (queue full?)");
+        return 0;
+    }
+
+    // Wake the main loop so the update is dispatched immediately
+    triggerUpdateDispatch();
+    return 1;
+}
+
+// Adds an update for a previously interned path to the given priority lane (see `GGKUpdatePriority` in
+// Gobbledegook.h)
+//
+// This is what a bulk transfer should use for its data-chunk updates: the interned push copies nothing, and the
+// bulk lane keeps those updates from delaying control traffic.
+//
+// Returns non-zero value on success or 0 on failure (including an invalid priority or an ID that was never
+// interned.)
+int ggkNofifyUpdatedCharacteristicByIdWithPriority(int pathId, enum GGKUpdatePriority priority) {
+    int lane = static_cast<int>(priority);
+    if (lane < GGK_PRIO_CONTROL || lane > GGK_PRIO_BULK) {
+        return 0;
+    }
+
+    // Validate against the published count (the acquire pairs with the release in the interning)
+    if (pathId < 0 || pathId >= internedUpdatePathCount.load(std::memory_order_acquire)) {
+        return 0;
+    }
+
+    if (!updateQueues[lane].push(nullptr, nullptr, pathId)) {
+        Logger::warn(SSTR << "Update queue rejected an update for interned path " << pathId << " (queue full?)");
+        return 0;
+    }
+
+    // Wake the main loop so the update is dispatched immediately
+    triggerUpdateDispatch();
     return 1;
 }
 
@@ -190,54 +798,259 @@ int ggkPushUpdateQueue(const char *pObjectPath, const char *pInterfaceName) {
 //
 // Returns 1 on success, 0 if the queue is empty, -1 on error (such as the length too small to store the element)
 int ggkPopUpdateQueue(char *pElementBuffer, int elementLen, int keep) {
-    std::string result;
+    return popUpdateQueuePrioritized(pElementBuffer, elementLen, keep, nullptr);
+}
 
-    {
-        std::lock_guard<std::mutex> guard(updateQueueMutex);
+// As `ggkPopUpdateQueue`, but additionally returns the entry's interned-path ID in `*pPathId` (or -1 for an entry
+// that was pushed by path string.) The dispatcher uses the ID to resolve the target interface by array index rather
+// than by string lookup.
+int ggkPopUpdateQueueWithId(char *pElementBuffer, int elementLen, int keep, int *pPathId) {
+    return popUpdateQueuePrioritized(pElementBuffer, elementLen, keep, pPathId);
+}
 
-        // Check for an empty queue
-        if (updateQueue.empty()) {
-            return 0;
+// Returns 1 if the queue is empty, otherwise 0
+int ggkUpdateQueueIsEmpty() {
+    return updateQueueTotalSize() == 0 ? 1 : 0;
+}
+
+// Returns the number of entries waiting in the queue (across all priority lanes)
+int ggkUpdateQueueSize() {
+    return static_cast<int>(updateQueueTotalSize());
+}
+
+// Removes all entries from the queue (all priority lanes)
+//
+// Note that this should only be called from the consumer (main loop) thread, as it discards entries via the
+// single-consumer pop path
+void ggkUpdateQueueClear() {
+    char discard[kUpdateQueueMaxPathLength + kUpdateQueueMaxInterfaceLength];
+    for (int lane = 0; lane < kUpdateQueueLaneCount; ++lane) {
+        while (updateQueues[lane].pop(discard, sizeof(discard), 0, nullptr) == 1) {
+            // Keep discarding
+        }
+    }
+}
+
+// Retrieve a snapshot of the update queue statistics, aggregated across the priority lanes (see
+// `GGKUpdateQueueStats`)
+void ggkUpdateQueueStats(GGKUpdateQueueStats *pStats) {
+    if (nullptr == pStats) {
+        return;
+    }
+
+    pStats->capacity = kUpdateQueueCapacity * kUpdateQueueLaneCount;
+    pStats->maxSize = 0;
+    pStats->size = 0;
+    pStats->totalPushed = 0;
+    pStats->totalPopped = 0;
+    pStats->totalCoalesced = 0;
+    pStats->totalDropped = 0;
+    for (int lane = 0; lane < kUpdateQueueLaneCount; ++lane) {
+        pStats->maxSize += updateQueues[lane].maxSize.load(std::memory_order_relaxed);
+        pStats->size += updateQueues[lane].size();
+        pStats->totalPushed += updateQueues[lane].totalPushed.load(std::memory_order_relaxed);
+        pStats->totalPopped += updateQueues[lane].totalPopped.load(std::memory_order_relaxed);
+        pStats->totalCoalesced += updateQueues[lane].totalCoalesced.load(std::memory_order_relaxed);
+        pStats->totalDropped += updateQueues[lane].totalDropped.load(std::memory_order_relaxed);
+    }
+}
+
+// Enable (non-zero) or disable (0) per-path coalescing, in every priority lane (see Gobbledegook.h for details)
+void ggkUpdateQueueSetCoalescing(int enable) {
+    for (int lane = 0; lane < kUpdateQueueLaneCount; ++lane) {
+        updateQueues[lane].coalescingEnabled.store(enable != 0, std::memory_order_relaxed);
+
+        // When disabling, clear the coalescing table so stale tags can't fold away future pushes if coalescing is
+        // re-enabled later
+        if (enable == 0) {
+            for (uint32_t i = 0; i < kUpdateQueueCoalescingSlots; ++i) {
+                updateQueues[lane].pendingTags[i].store(0, std::memory_order_relaxed);
+            }
         }
+    }
+}
 
-        // Get the last element
-        QueueEntry t = updateQueue.back();
+// Set the maximum number of pending entries each priority lane will accept (see Gobbledegook.h for details)
+void ggkUpdateQueueSetMaxSize(int maxSize) {
+    if (maxSize < 1) {
+        return;
+    }
+
+    uint32_t bound = static_cast<uint32_t>(maxSize);
+    if (bound > kUpdateQueueCapacity) {
+        bound = kUpdateQueueCapacity;
+    }
+
+    for (int lane = 0; lane < kUpdateQueueLaneCount; ++lane) {
+        updateQueues[lane].maxSize.store(bound, std::memory_order_relaxed);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  ____        _               _
+// |  _ \  __ _| |_ __ _    ___| |_ ___  _ ___
+// | | | |/ _` | __/ _` |  / __| __/ _ \| '__/ _ )
+// | |_| | (_| | || (_| |  \__ \ || (_) | | |  __/
+// |____/ \__,_|\__\__,_|  |___/\__\___/|_|  \___|
+//
+// A built-in value store shared between the application's threads and the server thread. Publishes never block reads;
+// reads never block anything.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// Registers a named slot in the value store with a fixed capacity in bytes
+//
+// Registration should happen once, at startup, before the name is published or read. Registering an existing name
+// succeeds if the capacity fits the existing slot (the slot is not resized.)
+//
+// Returns non-zero value on success, or 0 if the store is full, the name is too long, or the capacity is 0.
+int ggkDataStoreRegister(const char *pName, uint32_t capacity) {
+    if (nullptr == pName || capacity == 0 || strlen(pName) >= kDataStoreMaxNameLength) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(dataStoreMutex);
+
+    DataStoreSlot *pSlot = findDataStoreSlot(pName);
+    if (nullptr != pSlot) {
+        return capacity <= pSlot->capacity ? 1 : 0;
+    }
+
+    int count = dataStoreSlotCount.load(std::memory_order_relaxed);
+    if (count >= kDataStoreMaxSlots) {
+        return 0;
+    }
+
+    pSlot = &dataStoreSlots[count];
+    snprintf(pSlot->name, kDataStoreMaxNameLength, "%s", pName);
+    pSlot->pBuffer = new uint8_t[capacity];
+    pSlot->capacity = capacity;
+    pSlot->count = 0;
+    pSlot->sequence.store(0, std::memory_order_relaxed);
+
+    // Publish the new slot - the release pairs with the acquire in `findDataStoreSlot`
+    dataStoreSlotCount.store(count + 1, std::memory_order_release);
+    return 1;
+}
+
+// Publishes a new value into a registered slot (any thread)
+//
+// Returns non-zero value on success, or 0 if the name was never registered or the value exceeds the slot's capacity.
+int ggkDataStorePublish(const char *pName, const void *pData, uint32_t count) {
+    DataStoreSlot *pSlot = nullptr == pName ? nullptr : findDataStoreSlot(pName);
+    if (nullptr == pSlot || nullptr == pData || count > pSlot->capacity) {
+        return 0;
+    }
 
-        // Get the result string
-        result = std::get<0>(t) + "|" + std::get<1>(t);
+    std::lock_guard<std::mutex> lock(dataStoreMutex);
 
-        // Ensure there's enough room for it
-        if (result.length() + 1 > static_cast<size_t>(elementLen)) {
+    // Mark the slot unstable (odd), copy, then mark it stable (even.) Readers that overlap the copy will notice the
+    // sequence moved and retry.
+    uint32_t sequence = pSlot->sequence.load(std::memory_order_relaxed);
+    pSlot->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    memcpy(pSlot->pBuffer, pData, count);
+    pSlot->count = count;
+
+    pSlot->sequence.store(sequence + 2, std::memory_order_release);
+    return 1;
+}
+
+// Reads the current value of a registered slot into `pBuffer` (any thread; wait-free with respect to publishers)
+//
+// Returns the number of bytes read, or -1 if the name was never registered or `bufferLen` is smaller than the slot's
+// current value.
+int ggkDataStoreRead(const char *pName, void *pBuffer, uint32_t bufferLen) {
+    DataStoreSlot *pSlot = nullptr == pName ? nullptr : findDataStoreSlot(pName);
+    if (nullptr == pSlot || nullptr == pBuffer) {
+        return -1;
+    }
+
+    for (;;) {
+        uint32_t sequence = pSlot->sequence.load(std::memory_order_acquire);
+        if ((sequence & 1) != 0) {
+            // A publish is mid-copy - it will be done in the time it takes a memcpy to run
+            continue;
+        }
+
+        uint32_t count = pSlot->count;
+        if (count > bufferLen) {
             return -1;
         }
+        memcpy(pBuffer, pSlot->pBuffer, count);
 
-        if (keep == 0) {
-            updateQueue.pop_back();
+        // If the sequence hasn't moved, the snapshot is consistent
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (pSlot->sequence.load(std::memory_order_relaxed) == sequence) {
+            return static_cast<int>(count);
         }
     }
+}
 
-    // Copy the element string
-    memcpy(pElementBuffer, result.c_str(), result.length() + 1);
+// Returns the registered capacity of a slot in bytes, or -1 if the name was never registered
+//
+// Capacities are fixed at registration, so this is a safe upper bound for a read buffer.
+int ggkDataStoreCapacity(const char *pName) {
+    DataStoreSlot *pSlot = nullptr == pName ? nullptr : findDataStoreSlot(pName);
+    return nullptr == pSlot ? -1 : static_cast<int>(pSlot->capacity);
+}
 
-    return 1;
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  ____  _                            _
+// / ___|| |_ _ __ ___  __ _ _ __ ___ (_)_ __   __ _
+// \___ \| __| '__/ _ \/ _` | '_ ` _ \| | '_ \ / _` |
+//  ___) | |_| | |  __/ (_| | | | | | | | | | | (_| |
+// |____/ \__|_|  \___|\__,_|_| |_| |_|_|_| |_|\__, |
+//                                             |___/
+//
+// Thin wrappers around the streaming transfer engine (see StreamEngine.cpp for the wire protocol)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// Begins a streaming transfer of `count` bytes from `pData` (see Gobbledegook.h)
+int ggkStreamSendBuffer(const void *pData, uint32_t count, GGKStreamProgressCallback progress) {
+    return StreamEngine::getInstance().sendBuffer(pData, count, progress) ? 1 : 0;
 }
 
-// Returns 1 if the queue is empty, otherwise 0
-int ggkUpdateQueueIsEmpty() {
-    std::lock_guard<std::mutex> guard(updateQueueMutex);
-    return updateQueue.empty() ? 1 : 0;
+// As `ggkStreamSendBuffer`, but pulling the payload on demand (see Gobbledegook.h)
+int ggkStreamSendPull(GGKStreamPullCallback pull, uint32_t totalBytes, GGKStreamProgressCallback progress) {
+    return StreamEngine::getInstance().sendPull(pull, totalBytes, progress) ? 1 : 0;
 }
 
-// Returns the number of entries waiting in the queue
-int ggkUpdateQueueSize() {
-    std::lock_guard<std::mutex> guard(updateQueueMutex);
-    return updateQueue.size();
+// As `ggkStreamSendBuffer`, but the payload is the file at `pFilePath`, memory-mapped rather than staged
+int ggkStreamSendFile(const char *pFilePath, GGKStreamProgressCallback progress) {
+    return StreamEngine::getInstance().sendFile(pFilePath, progress) ? 1 : 0;
 }
 
-// Removes all entries from the queue
-void ggkUpdateQueueClear() {
-    std::lock_guard<std::mutex> guard(updateQueueMutex);
-    updateQueue.clear();
+// Binds the value of the characteristic at `pObjectPath` to the file at `pFilePath` (see Gobbledegook.h)
+int ggkBindCharacteristicValueFile(const char *pObjectPath, const char *pFilePath) {
+    if (nullptr == pObjectPath || nullptr == TheServer) {
+        return 0;
+    }
+
+    std::shared_ptr<const DBusInterface> pInterface =
+        TheServer->findInterface(DBusObjectPath(pObjectPath), "org.bluez.GattCharacteristic1");
+    if (nullptr == pInterface) {
+        return 0;
+    }
+
+    std::shared_ptr<const GattCharacteristic> pCharacteristic =
+        TRY_GET_CONST_INTERFACE_OF_TYPE(pInterface, GattCharacteristic);
+    if (nullptr == pCharacteristic) {
+        return 0;
+    }
+
+    pCharacteristic->bindValueFile(nullptr == pFilePath ? "" : pFilePath);
+    return 1;
+}
+
+// Aborts the in-flight streaming transfer (if any)
+void ggkStreamCancel() {
+    StreamEngine::getInstance().cancel();
+}
+
+// Returns non-zero while a streaming transfer is in flight
+int ggkStreamIsActive() {
+    return StreamEngine::getInstance().isActive() ? 1 : 0;
 }
 
 // ---------------------------------------------------------------------------------------------------------------------------------
@@ -280,6 +1093,62 @@ int ggkIsServerRunning() {
     return serverRunState <= ERunning ? 1 : 0;
 }
 
+// Returns the ATT MTU negotiated on the current connection, or 0 if it is not yet known
+//
+// The value comes from BlueZ's AcquireNotify/AcquireWrite replies, so it remains 0 until a client has acquired at
+// least one fd channel. See `Server::getNegotiatedMTU`.
+int ggkGetConnectionMTU() {
+    if (nullptr == TheServer) {
+        return 0;
+    }
+
+    return static_cast<int>(TheServer->getNegotiatedMTU());
+}
+
+// Request a connection-parameter profile for the current connection (see `GGKConnectionProfile`)
+//
+// Returns 1 if the update was sent for the current connection, 2 if the request was recorded for later (no device
+// connected yet, or a stream transfer is forcing throughput), or 0 on failure
+int ggkRequestConnectionProfile(enum GGKConnectionProfile profile) {
+    return Mgmt::requestConnectionProfile(profile);
+}
+
+// Retrieve the per-phase startup durations for the current (or most recent) server
+//
+// Returns non-zero on success, or 0 if `pTimings` is NULL
+int ggkGetStartupTimings(GGKStartupTimings *pTimings) {
+    if (nullptr == pTimings) {
+        return 0;
+    }
+
+    getStartupTimings(*pTimings);
+    return 1;
+}
+
+// Retrieve a snapshot of the server's hot-path metrics
+//
+// Returns non-zero on success, or 0 if `pSnapshot` is NULL
+int ggkGetMetricsSnapshot(GGKMetricsSnapshot *pSnapshot) {
+    if (nullptr == pSnapshot) {
+        return 0;
+    }
+
+    Metrics::getSnapshot(*pSnapshot);
+    pSnapshot->updateQueueDepth = updateQueueTotalSize();
+    return 1;
+}
+
+// Dump the server's flight-recorder trace ring to the file at `pPath`
+//
+// Returns the number of records written, or -1 if `pPath` is NULL or the file could not be written
+int ggkDumpTrace(const char *pPath) {
+    if (nullptr == pPath) {
+        return -1;
+    }
+
+    return Trace::dump(pPath);
+}
+
 // ---------------------------------------------------------------------------------------------------------------------------------
 //  ____                              _                _ _   _
 // / ___|  ___ _ ____   _____ _ __   | |__   ___  __ _| | |_| |___
@@ -506,6 +1375,12 @@ int ggkStart(
             setter
         );
 
+        // Attach the span getter if the application registered one before starting us
+        TheServer->setDataSpanGetter(serverDataSpanGetter);
+
+        // Bind the server to its controller (0 unless started via `ggkStartOnAdapter`)
+        TheServer->setControllerIndex(startControllerIndex);
+
         // Start our server thread
         try {
             serverThread = std::thread(runServerThread);
@@ -552,6 +1427,45 @@ int ggkStart(
     }
 }
 
+// Same as `ggkStart`, but binds the server to a specific HCI controller (hci0, hci1, ...)
+//
+// `hciIndex` is the zero-based controller index as recognized by the OS. The controller selection steers both the
+// management (HCI) commands used to configure the adapter and the BlueZ adapter object the GATT application is
+// registered against. `ggkStart` is equivalent to `ggkStartOnAdapter` with an index of 0.
+//
+// Note that a process hosts one server, so serving N controllers means running N processes, each started on its own
+// index. They share nothing but the system bus, so they scale independently.
+int ggkStartOnAdapter(
+    int hciIndex,
+    const char *pServiceName,
+    const char *pAdvertisingName,
+    const char *pAdvertisingShortName,
+    bool enableMultipleConnections,
+    bool externalAdvertising,
+    GGKServerDataGetter getter,
+    GGKServerDataSetter setter,
+    int maxAsyncInitTimeoutMS
+) {
+    if (hciIndex < 0) {
+        Logger::error(SSTR << "Invalid HCI controller index (" << hciIndex << ") passed to ggkStartOnAdapter()");
+        return 0;
+    }
+
+    startControllerIndex = hciIndex;
+    int result = ggkStart(
+        pServiceName,
+        pAdvertisingName,
+        pAdvertisingShortName,
+        enableMultipleConnections,
+        externalAdvertising,
+        getter,
+        setter,
+        maxAsyncInitTimeoutMS
+    );
+    startControllerIndex = 0;
+    return result;
+}
+
 void ggkSetThreadPriority(int priority) {
     runThreadPriority = priority;
 }
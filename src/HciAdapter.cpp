@@ -46,11 +46,14 @@
 #include <future>
 #include <string.h>
 
+#include "BondCache.h"
 #include "HciAdapter.h"
 #include "HciSocket.h"
 #include "Logger.h"
+#include "Metrics.h"
 #include "Mgmt.h"
 #include "Server.h"
+#include "Trace.h"
 #include "Utils.h"
 
 namespace ggk {
@@ -213,9 +216,12 @@ void runEventThread() {
 void HciAdapter::runEventThread() {
     Logger::trace("Entering the HciAdapter event thread");
 
+    // Our frame storage, reused across events - `HciSocket::read` refills it in place, so after the first event this
+    // loop performs no allocations on the event path
+    std::vector<uint8_t> responsePacket;
+
     while (ggkGetServerRunState() <= ERunning && hciSocket.isConnected()) {
         // Read the next event, waiting until one arrives
-        std::vector<uint8_t> responsePacket = std::vector<uint8_t>();
         if (!hciSocket.read(responsePacket)) {
             break;
         }
@@ -229,6 +235,8 @@ void HciAdapter::runEventThread() {
         // Our response, as a usable object type
         uint16_t eventCode = Utils::endianToHost(*reinterpret_cast<uint16_t *>(responsePacket.data()));
 
+        Trace::record(Trace::EHciEventReceived, eventCode);
+
         // Ensure our event code is valid
         if (eventCode < HciAdapter::kMinEventType || eventCode > HciAdapter::kMaxEventType) {
             Logger::error(SSTR << "Invalid command response: event code (" << eventCode << ") out of range");
@@ -256,7 +264,7 @@ void HciAdapter::runEventThread() {
 
                 versionInformation = *reinterpret_cast<VersionInformation *>(data);
                 versionInformation.toHost();
-                Logger::debug(versionInformation.debugText());
+                LOG_DEBUG(versionInformation.debugText());
                 break;
             }
             case Mgmt::EReadControllerInformationCommand: {
@@ -267,7 +275,7 @@ void HciAdapter::runEventThread() {
 
                 controllerInformation = *reinterpret_cast<ControllerInformation *>(data);
                 controllerInformation.toHost();
-                Logger::debug(controllerInformation.debugText());
+                LOG_DEBUG(controllerInformation.debugText());
                 break;
             }
             case Mgmt::ESetLocalNameCommand: {
@@ -277,7 +285,7 @@ void HciAdapter::runEventThread() {
                 }
 
                 localName = *reinterpret_cast<LocalName *>(data);
-                Logger::info(localName.debugText());
+                LOG_INFO(localName.debugText());
                 break;
             }
             case Mgmt::ESetPoweredCommand:
@@ -295,7 +303,7 @@ void HciAdapter::runEventThread() {
                 adapterSettings = *reinterpret_cast<AdapterSettings *>(data);
                 adapterSettings.toHost();
 
-                Logger::debug(adapterSettings.debugText());
+                LOG_DEBUG(adapterSettings.debugText());
                 break;
             }
             }
@@ -303,6 +311,9 @@ void HciAdapter::runEventThread() {
             // Notify anybody waiting that we received a response to their command code
             setCommandResponse(event.commandCode);
 
+            // Settle any pipelined command awaiting this completion (see `sendCommandAsync`)
+            completePendingCommand(event.commandCode, event.status);
+
             break;
         }
         // Command status event
@@ -311,19 +322,41 @@ void HciAdapter::runEventThread() {
 
             // Notify anybody waiting that we received a response to their command code
             setCommandResponse(event.commandCode);
+
+            // Settle any pipelined command awaiting this completion (see `sendCommandAsync`)
+            completePendingCommand(event.commandCode, event.status);
             break;
         }
         // Command status event
         case Mgmt::EDeviceConnectedEvent: {
             DeviceConnectedEvent event(responsePacket);
             activeConnections += 1;
-            Logger::debug(SSTR << "  > Connection count incremented to " << activeConnections);
+            LOG_DEBUG("  > Connection count incremented to " << activeConnections);
+
+            // Remember the peer so connection-parameter updates can target it (see `Mgmt::requestConnectionProfile`),
+            // and time the reconnect if this is the device that most recently left us
+            {
+                std::lock_guard<std::mutex> lock(connectedDeviceMutex);
+                memcpy(connectedAddress, event.address, sizeof(connectedAddress));
+                connectedAddressType = event.addressType;
+                bHaveConnectedDevice = true;
+
+                if (0 != lastDisconnectTimeNS && event.addressType == lastDisconnectedAddressType &&
+                    0 == memcmp(event.address, lastDisconnectedAddress, sizeof(lastDisconnectedAddress))) {
+                    Metrics::recordReconnectTime(Metrics::timestampNS() - lastDisconnectTimeNS);
+                    lastDisconnectTimeNS = 0;
+                }
+            }
+
+            // A profile requested while nobody was connected takes effect now that someone is (the command is
+            // pipelined, so the event thread is not stalled)
+            Mgmt::applyProfileOnConnect();
 
             std::string advertisingShortName = Mgmt::truncateShortName(TheServer->getAdvertisingShortName());
             const uint16_t id = TheServer->getAdvertisingServiceId();
 
             bool enableMultipleConnections = TheServer->getEnableMultipleConnections();
-            Logger::debug(SSTR << "  > enableMultipleConnections " << enableMultipleConnections);
+            LOG_DEBUG("  > enableMultipleConnections " << enableMultipleConnections);
             if (enableMultipleConnections) {
                 Mgmt mgmt;
                 mgmt.addAdvertising(advertisingShortName, &id);
@@ -335,9 +368,35 @@ void HciAdapter::runEventThread() {
             DeviceDisconnectedEvent event(responsePacket);
             if (activeConnections > 0) {
                 activeConnections -= 1;
-                Logger::debug(SSTR << "  > Connection count decremented to " << activeConnections);
+                LOG_DEBUG("  > Connection count decremented to " << activeConnections);
             } else {
-                Logger::debug(SSTR << "  > Connection count already at zero, ignoring non-connected disconnect event");
+                LOG_DEBUG("  > Connection count already at zero, ignoring non-connected disconnect event");
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(connectedDeviceMutex);
+                if (0 == activeConnections) {
+                    bHaveConnectedDevice = false;
+                }
+
+                memcpy(lastDisconnectedAddress, event.address, sizeof(lastDisconnectedAddress));
+                lastDisconnectedAddressType = event.addressType;
+                lastDisconnectTimeNS = Metrics::timestampNS();
+            }
+            break;
+        }
+        // A device finished bonding - cache its keys so it reconnects fast after a restart (see BondCache.cpp)
+        case Mgmt::ENewLongTermKeyEvent: {
+            NewLongTermKeyEvent event(responsePacket);
+            if (0 != event.storeHint) {
+                BondCache::addLongTermKey(event.key);
+            }
+            break;
+        }
+        case Mgmt::ENewIdentityResolvingKeyEvent: {
+            NewIdentityResolvingKeyEvent event(responsePacket);
+            if (0 != event.storeHint) {
+                BondCache::addIdentityKey(event.key);
             }
             break;
         }
@@ -361,6 +420,21 @@ void HciAdapter::runEventThread() {
     Logger::trace("Leaving the HciAdapter event thread");
 }
 
+// Retrieves the address of the most recently connected device
+//
+// Fills `address` and `addressType` and returns true while a device is connected, otherwise returns false (leaving
+// the outputs untouched.) Safe to call from any thread.
+bool HciAdapter::getConnectedDevice(uint8_t address[6], uint8_t &addressType) {
+    std::lock_guard<std::mutex> lock(connectedDeviceMutex);
+    if (!bHaveConnectedDevice) {
+        return false;
+    }
+
+    memcpy(address, connectedAddress, 6);
+    addressType = connectedAddressType;
+    return true;
+}
+
 // Reads current values from the controller
 //
 // This effectively requests data from the controller but that data may not be available instantly, but within a few
@@ -368,6 +442,10 @@ void HciAdapter::runEventThread() {
 void HciAdapter::sync(uint16_t controllerIndex) {
     Logger::debug("Synchronizing version information");
 
+    // Latch the bound controller so commands built outside a bound `Mgmt` instance (the static connection-profile
+    // machinery, say) can target it - see `getBoundControllerIndex`
+    boundControllerIndex = controllerIndex;
+
     HciAdapter::HciHeader request;
     request.code = Mgmt::EReadVersionInformationCommand;
     request.controllerId = HciAdapter::kNonController;
@@ -469,6 +547,8 @@ bool HciAdapter::sendCommand(HciHeader &request) {
     uint16_t code = request.code;
     uint16_t dataSize = request.dataSize;
 
+    Trace::record(Trace::EHciCommandSubmitted, code);
+
     conditionalValue = -1;
     std::future<bool> fut =
         std::async(std::launch::async, [&]() mutable { return waitForCommandResponse(code, kMaxEventWaitTimeMS); });
@@ -485,6 +565,119 @@ bool HciAdapter::sendCommand(HciHeader &request) {
     return fut.get();
 }
 
+// Sends a command over the HCI socket without waiting for its response
+//
+// This is the pipelined counterpart to `sendCommand`: the command is registered as pending and written to the socket,
+// and this method returns immediately so further commands can be issued while the adapter is still processing this
+// one. The event thread matches the completion event by command code (see `completePendingCommand`.)
+//
+// Returns true if the command was sent, otherwise false
+bool HciAdapter::sendCommandAsync(HciHeader &request, CommandCompletionCallback callback) {
+    // Auto-connect
+    if (!eventThread.joinable() && !start()) {
+        Logger::error("HciAdapter failed to start");
+        return false;
+    }
+
+    uint16_t code = request.code;
+    uint16_t dataSize = request.dataSize;
+
+    Trace::record(Trace::EHciCommandSubmitted, code);
+
+    // Register the command as pending before writing it, so the completion event cannot race past us
+    {
+        std::lock_guard<std::mutex> lock(pendingCommandMutex);
+        PendingCommand pending;
+        pending.commandCode = code;
+        pending.callback = callback;
+        pendingCommands.push_back(pending);
+    }
+
+    // Prepare the request to be sent (endianness correction)
+    request.toNetwork();
+    uint8_t *pRequest = reinterpret_cast<uint8_t *>(&request);
+
+    std::vector<uint8_t> requestPacket = std::vector<uint8_t>(pRequest, pRequest + sizeof(request) + dataSize);
+    if (!hciSocket.write(requestPacket)) {
+        // The command never made it out - unregister it so a fence doesn't wait on a completion that will never come
+        std::lock_guard<std::mutex> lock(pendingCommandMutex);
+        for (auto it = pendingCommands.rbegin(); it != pendingCommands.rend(); ++it) {
+            if (it->commandCode == code) {
+                pendingCommands.erase(std::next(it).base());
+                break;
+            }
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
+// Matches a completion event to the oldest pending command with `commandCode`, invoking its callback
+//
+// Called from the event thread for every Command Complete/Status event. Events that match no pending command
+// (responses to blocking `sendCommand` calls, unsolicited events) are ignored here.
+void HciAdapter::completePendingCommand(uint16_t commandCode, uint8_t status) {
+    CommandCompletionCallback callback = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(pendingCommandMutex);
+
+        bool found = false;
+        for (auto it = pendingCommands.begin(); it != pendingCommands.end(); ++it) {
+            if (it->commandCode == commandCode) {
+                callback = it->callback;
+                pendingCommands.erase(it);
+                found = true;
+                break;
+            }
+        }
+
+        if (!found) {
+            return;
+        }
+
+        if (status != 0) {
+            Logger::warn(
+                SSTR << "  + Pipelined command " << Utils::hex(commandCode) << " (" << kCommandCodeNames[commandCode]
+                     << ") completed with status " << Utils::hex(status) << " (" << kStatusCodes[status] << ")"
+            );
+            pendingCommandFailures += 1;
+        }
+
+        cvPendingCommands.notify_all();
+    }
+
+    // Invoke the callback outside the lock so it may issue further async commands
+    if (nullptr != callback) {
+        callback(commandCode, status);
+    }
+}
+
+// Waits for every pipelined command to complete, for up to `timeoutMS` milliseconds
+//
+// Returns true if all pending commands completed successfully within the timeout, or false if the timeout expired or
+// any command since the previous fence completed with a non-zero status.
+bool HciAdapter::waitForPendingCommands(int timeoutMS) {
+    std::unique_lock<std::mutex> lock(pendingCommandMutex);
+
+    bool drained = cvPendingCommands.wait_for(lock, std::chrono::milliseconds(timeoutMS), [&] {
+        return pendingCommands.empty();
+    });
+
+    if (!drained) {
+        Logger::warn(
+            SSTR << "  + Timed out waiting on " << pendingCommands.size() << " pipelined command(s) after " << timeoutMS
+                 << "ms"
+        );
+    }
+
+    bool success = drained && pendingCommandFailures == 0;
+    pendingCommandFailures = 0;
+    return success;
+}
+
 // Uses a std::condition_variable to wait for a response event for the given `commandCode` or `timeoutMS`
 // milliseconds.
 //
@@ -492,21 +685,27 @@ bool HciAdapter::sendCommand(HciHeader &request) {
 //
 // Command responses are set via `setCommandResponse()`
 bool HciAdapter::waitForCommandResponse(uint16_t commandCode, int timeoutMS) {
-    Logger::debug(SSTR << "  + Waiting on command code " << commandCode << " for up to " << timeoutMS << "ms");
+    LOG_DEBUG("  + Waiting on command code " << commandCode << " for up to " << timeoutMS << "ms");
 
+    uint64_t startTimeNS = Metrics::timestampNS();
     bool success = cvCommandResponse.wait_for(commandResponseLock, std::chrono::milliseconds(timeoutMS), [&] {
         return conditionalValue == commandCode;
     });
 
+    if (success) {
+        // Only completed round-trips count - a timeout would just record the timeout value
+        Metrics::recordHciCommandRoundTrip(Metrics::timestampNS() - startTimeNS);
+    }
+
     if (!success) {
         Logger::warn(
             SSTR << "  + Timed out waiting on command code " << Utils::hex(commandCode) << " ("
                  << kCommandCodeNames[commandCode] << ")"
         );
     } else {
-        Logger::debug(
-            SSTR << "  + Recieved the command code we were waiting for: " << Utils::hex(commandCode) << " ("
-                 << kCommandCodeNames[commandCode] << ")"
+        LOG_DEBUG(
+            "  + Recieved the command code we were waiting for: " << Utils::hex(commandCode) << " ("
+                                                                  << kCommandCodeNames[commandCode] << ")"
         );
     }
 
@@ -515,6 +714,8 @@ bool HciAdapter::waitForCommandResponse(uint16_t commandCode, int timeoutMS) {
 
 // Sets the command response and notifies the waiting std::condition_variable (see `waitForCommandResponse`)
 void HciAdapter::setCommandResponse(uint16_t commandCode) {
+    Trace::record(Trace::EHciCommandSettled, commandCode);
+
     std::lock_guard<std::mutex> lk(commandResponseMutex);
     conditionalValue = commandCode;
     cvCommandResponse.notify_one();
@@ -25,11 +25,13 @@
 #pragma once
 
 #include <condition_variable>
+#include <list>
 #include <mutex>
 #include <stdint.h>
 #include <thread>
 #include <vector>
 
+#include "BondCache.h"
 #include "HciSocket.h"
 #include "Logger.h"
 #include "Utils.h"
@@ -122,8 +124,10 @@ public:
             *this = *reinterpret_cast<const CommandCompleteEvent *>(data.data());
             toHost();
 
-            // Log it
-            Logger::debug(debugText());
+            // Log it (gated - `debugText()` builds a multi-line dump we'd rather not pay for when filtered)
+            if (Logger::debugEnabled()) {
+                Logger::debug(debugText());
+            }
         }
 
         void toNetwork() {
@@ -159,8 +163,10 @@ public:
             *this = *reinterpret_cast<const CommandStatusEvent *>(data.data());
             toHost();
 
-            // Log it
-            Logger::debug(debugText());
+            // Log it (gated - `debugText()` builds a multi-line dump we'd rather not pay for when filtered)
+            if (Logger::debugEnabled()) {
+                Logger::debug(debugText());
+            }
         }
 
         void toNetwork() {
@@ -198,8 +204,10 @@ public:
             *this = *reinterpret_cast<const DeviceConnectedEvent *>(data.data());
             toHost();
 
-            // Log it
-            Logger::debug(debugText());
+            // Log it (gated - `debugText()` builds a multi-line dump we'd rather not pay for when filtered)
+            if (Logger::debugEnabled()) {
+                Logger::debug(debugText());
+            }
         }
 
         void toNetwork() {
@@ -244,8 +252,10 @@ public:
             *this = *reinterpret_cast<const DeviceDisconnectedEvent *>(data.data());
             toHost();
 
-            // Log it
-            Logger::debug(debugText());
+            // Log it (gated - `debugText()` builds a multi-line dump we'd rather not pay for when filtered)
+            if (Logger::debugEnabled()) {
+                Logger::debug(debugText());
+            }
         }
 
         void toNetwork() {
@@ -270,6 +280,73 @@ public:
         }
     } __attribute__((packed));
 
+    struct NewLongTermKeyEvent {
+        HciHeader header;
+        uint8_t storeHint;
+        BondLongTermKey key;
+
+        NewLongTermKeyEvent(const std::vector<uint8_t> &data) {
+            *this = *reinterpret_cast<const NewLongTermKeyEvent *>(data.data());
+            toHost();
+
+            // Log it (gated - `debugText()` builds a multi-line dump we'd rather not pay for when filtered)
+            if (Logger::debugEnabled()) {
+                Logger::debug(debugText());
+            }
+        }
+
+        void toHost() {
+            header.toHost();
+        }
+
+        // The key material itself is deliberately not logged
+        std::string debugText() {
+            std::string text = "";
+            text += "> NewLongTermKey event\n";
+            text += "  + Event code         : " + Utils::hex(header.code) + " (" +
+                    HciAdapter::kEventTypeNames[header.code] + ")\n";
+            text += "  + Controller Id      : " + Utils::hex(header.controllerId) + "\n";
+            text += "  + Address            : " + Utils::bluetoothAddressString(key.address) + "\n";
+            text += "  + Address type       : " + Utils::hex(key.addressType) + "\n";
+            text += "  + Store hint         : " + Utils::hex(storeHint);
+            return text;
+        }
+    } __attribute__((packed));
+
+    struct NewIdentityResolvingKeyEvent {
+        HciHeader header;
+        uint8_t storeHint;
+        uint8_t randomAddress[6];
+        BondIdentityKey key;
+
+        NewIdentityResolvingKeyEvent(const std::vector<uint8_t> &data) {
+            *this = *reinterpret_cast<const NewIdentityResolvingKeyEvent *>(data.data());
+            toHost();
+
+            // Log it (gated - `debugText()` builds a multi-line dump we'd rather not pay for when filtered)
+            if (Logger::debugEnabled()) {
+                Logger::debug(debugText());
+            }
+        }
+
+        void toHost() {
+            header.toHost();
+        }
+
+        // The key material itself is deliberately not logged
+        std::string debugText() {
+            std::string text = "";
+            text += "> NewIdentityResolvingKey event\n";
+            text += "  + Event code         : " + Utils::hex(header.code) + " (" +
+                    HciAdapter::kEventTypeNames[header.code] + ")\n";
+            text += "  + Controller Id      : " + Utils::hex(header.controllerId) + "\n";
+            text += "  + Identity address   : " + Utils::bluetoothAddressString(key.address) + "\n";
+            text += "  + Address type       : " + Utils::hex(key.addressType) + "\n";
+            text += "  + Store hint         : " + Utils::hex(storeHint);
+            return text;
+        }
+    } __attribute__((packed));
+
     struct AdapterSettings {
         uint32_t masks;
 
@@ -439,6 +516,18 @@ public:
         return activeConnections;
     }
 
+    // Returns the index of the controller the server is bound to (latched by `sync` - see `Mgmt::Mgmt`.) Commands
+    // built outside a bound `Mgmt` instance should target this index rather than assuming controller 0.
+    uint16_t getBoundControllerIndex() const {
+        return boundControllerIndex;
+    }
+
+    // Retrieves the address of the most recently connected device
+    //
+    // Fills `address` and `addressType` and returns true while a device is connected, otherwise returns false
+    // (leaving the outputs untouched.) Safe to call from any thread.
+    bool getConnectedDevice(uint8_t address[6], uint8_t &addressType);
+
     //
     // Disallow copies of our singleton (c++11)
     //
@@ -475,6 +564,31 @@ public:
     // Returns true on success, otherwise false
     bool sendCommand(HciHeader &request);
 
+    // Completion callback for an asynchronous command (see `sendCommandAsync`)
+    //
+    // `commandCode` is the management command code the completion is for and `status` is the status byte from the
+    // adapter's Command Complete (or Command Status) event - zero means success. Callbacks are invoked on the event
+    // thread, so keep them short and do not send blocking commands from them.
+    typedef void (*CommandCompletionCallback)(uint16_t commandCode, uint8_t status);
+
+    // Sends a command over the HCI socket without waiting for its response
+    //
+    // This is the pipelined counterpart to `sendCommand`: the command is registered as pending and written to the
+    // socket, and this method returns immediately so further commands can be issued while the adapter is still
+    // processing this one. The event thread matches the adapter's Command Complete/Status event to the pending
+    // command by its command code and invokes `callback` (which may be nullptr.)
+    //
+    // Use `waitForPendingCommands` to fence a batch of pipelined commands.
+    //
+    // Returns true if the command was sent, otherwise false
+    bool sendCommandAsync(HciHeader &request, CommandCompletionCallback callback = nullptr);
+
+    // Waits for every pipelined command to complete, for up to `timeoutMS` milliseconds
+    //
+    // Returns true if all pending commands completed successfully within the timeout, or false if the timeout expired
+    // or any command since the previous fence completed with a non-zero status.
+    bool waitForPendingCommands(int timeoutMS);
+
     // Event processor, responsible for receiving events from the HCI socket
     //
     // This mehtod should not be called directly. Rather, it runs continuously on a thread until the server shuts down
@@ -497,6 +611,18 @@ private:
     // Sets the command response and notifies the waiting std::condition_variable (see `waitForCommandResponse`)
     void setCommandResponse(uint16_t commandCode);
 
+    // A pipelined command awaiting its completion event (see `sendCommandAsync`)
+    struct PendingCommand {
+        uint16_t commandCode;
+        CommandCompletionCallback callback;
+    };
+
+    // Matches a completion event to the oldest pending command with `commandCode`, invoking its callback
+    //
+    // Called from the event thread for every Command Complete/Status event. Events that match no pending command
+    // (responses to blocking `sendCommand` calls, unsolicited events) are ignored here.
+    void completePendingCommand(uint16_t commandCode, uint8_t status);
+
     // Our HCI Socket, which allows us to talk directly to the kernel
     HciSocket hciSocket;
 
@@ -514,8 +640,33 @@ private:
     std::unique_lock<std::mutex> commandResponseLock;
     int conditionalValue;
 
+    // Pipelined commands in flight, oldest first (guarded by `pendingCommandMutex`)
+    std::list<PendingCommand> pendingCommands;
+    std::mutex pendingCommandMutex;
+    std::condition_variable cvPendingCommands;
+
+    // Number of pipelined commands that completed with a non-zero status since the last fence (guarded by
+    // `pendingCommandMutex`)
+    int pendingCommandFailures = 0;
+
     // Our active connection count
     int activeConnections;
+
+    // The controller index the server is bound to (latched by `sync`; see `getBoundControllerIndex`)
+    uint16_t boundControllerIndex = 0;
+
+    // The most recently connected device, captured from its DeviceConnected event (guarded by
+    // `connectedDeviceMutex` - see `getConnectedDevice`)
+    std::mutex connectedDeviceMutex;
+    uint8_t connectedAddress[6] = {0, 0, 0, 0, 0, 0};
+    uint8_t connectedAddressType = 0;
+    bool bHaveConnectedDevice = false;
+
+    // The last device to disconnect, and when - so a reconnect of the same device can be timed (guarded by
+    // `connectedDeviceMutex`; `lastDisconnectTimeNS` of 0 means no disconnect is pending a reconnect)
+    uint8_t lastDisconnectedAddress[6] = {0, 0, 0, 0, 0, 0};
+    uint8_t lastDisconnectedAddressType = 0;
+    uint64_t lastDisconnectTimeNS = 0;
 };
 
 }; // namespace ggk
@@ -33,17 +33,21 @@
 #include <bluetooth/bluetooth.h>
 #include <bluetooth/hci.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <sys/epoll.h>
 #include <thread>
 
 #include "HciSocket.h"
 #include "Logger.h"
+#include "Trace.h"
 #include "Utils.h"
 
 namespace ggk {
 
 // Initializes an unconnected socket
 HciSocket::HciSocket() :
-    fdSocket(-1) {}
+    fdSocket(-1),
+    fdEpoll(-1) {}
 
 // Socket destructor
 //
@@ -76,6 +80,28 @@ bool HciSocket::connect() {
         return false;
     }
 
+    // Register the socket with an epoll instance - this is what `waitForDataOrShutdown` blocks on
+    fdEpoll = epoll_create1(EPOLL_CLOEXEC);
+    if (fdEpoll < 0) {
+        logErrno("Connect(epoll_create1)");
+        disconnect();
+        return false;
+    }
+
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = fdSocket;
+
+    if (epoll_ctl(fdEpoll, EPOLL_CTL_ADD, fdSocket, &event) < 0) {
+        logErrno("Connect(epoll_ctl)");
+        disconnect();
+        return false;
+    }
+
+    // Preallocate the receive buffer so the event path never allocates
+    readBuffer.resize(kResponseMaxSize);
+
     Logger::debug(SSTR << "Connected to HCI control socket (fd = " << fdSocket << ")");
 
     return true;
@@ -88,6 +114,14 @@ bool HciSocket::isConnected() const {
 
 // Disconnects from the HCI socket
 void HciSocket::disconnect() {
+    if (fdEpoll >= 0) {
+        if (close(fdEpoll) != 0) {
+            logErrno("close(fdEpoll)");
+        }
+
+        fdEpoll = -1;
+    }
+
     if (isConnected()) {
         Logger::debug("HciSocket disconnecting");
 
@@ -102,44 +136,42 @@ void HciSocket::disconnect() {
 
 // Reads data from the HCI socket
 //
-// Raw data is read and returned in `response`.
+// Raw data is received into our preallocated `readBuffer` and handed to the caller via `response`. The Management API
+// delivers one complete frame per receive, so there is no need to reassemble frames across reads. Callers that reuse
+// the same `response` vector across calls pay no allocations at steady state.
 //
 // Returns true if data was read successfully, otherwise false is returned. A false return code does not necessarily
 // depict an error, as this can arise from expected conditions (such as an interrupt.)
 bool HciSocket::read(std::vector<uint8_t> &response) const {
-    // Fill our response with empty data
-    response.resize(kResponseMaxSize, 0);
+    response.resize(0);
 
     // Wait for data or a cancellation
     if (!waitForDataOrShutdown()) {
         return false;
     }
 
-    // Block until we receive data, a disconnect, or a signal
-    ssize_t bytesRead = ::recv(fdSocket, &response[0], kResponseMaxSize, MSG_WAITALL);
+    // The socket is non-blocking; epoll told us there's a frame waiting, so this shouldn't spin
+    ssize_t bytesRead = ::recv(fdSocket, readBuffer.data(), readBuffer.size(), MSG_DONTWAIT);
 
-    // If there was an error, wipe the data and return an error condition
+    // If there was an error, return an error condition
     if (bytesRead < 0) {
-        if (errno == EINTR) {
+        if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK) {
             Logger::debug("HciSocket receive interrupted");
         } else {
             logErrno("recv");
         }
-        response.resize(0);
         return false;
     } else if (bytesRead == 0) {
         Logger::error("Peer closed the socket");
-        response.resize(0);
         return false;
     }
 
     // We have data
-    response.resize(bytesRead);
+    response.assign(readBuffer.data(), readBuffer.data() + bytesRead);
+    Trace::record(Trace::EHciSocketRead, static_cast<uint64_t>(bytesRead));
 
-    std::string dump = "";
-    dump += "  > Read " + std::to_string(response.size()) + " bytes\n";
-    dump += Utils::hex(response.data(), response.size());
-    Logger::debug(dump);
+    // Level-gated - with no debug receiver registered, no dump is rendered and no allocation takes place
+    LOG_DEBUG("  > Read " << response.size() << " bytes\n" << HexDump(response.data(), response.size()));
 
     return true;
 }
@@ -153,18 +185,56 @@ bool HciSocket::write(std::vector<uint8_t> buffer) const {
 
 // Writes the array of bytes of a given count
 //
+// The socket is non-blocking, so a full kernel buffer (a stalled controller) surfaces as EAGAIN rather than blocking
+// us. When that happens we wait for writability for at most `kWriteTimeoutMS` milliseconds, then give up and fail the
+// write so the caller is never wedged.
+//
 // This method returns true if the bytes were written successfully, otherwise false
 bool HciSocket::write(const uint8_t *pBuffer, size_t count) const {
-    std::string dump = "";
-    dump += "  > Writing " + std::to_string(count) + " bytes\n";
-    dump += Utils::hex(pBuffer, count);
-    Logger::debug(dump);
-
-    size_t len = ::write(fdSocket, pBuffer, count);
+    Trace::record(Trace::EHciSocketWrite, count);
+
+    // Level-gated - with no debug receiver registered, no dump is rendered and no allocation takes place
+    LOG_DEBUG("  > Writing " << count << " bytes\n" << HexDump(pBuffer, count));
+
+    size_t bytesWritten = 0;
+    while (bytesWritten < count) {
+        ssize_t len = ::write(fdSocket, pBuffer + bytesWritten, count - bytesWritten);
+
+        if (len < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                // We poll just our own socket for writability here rather than sharing the epoll instance with the
+                // reader thread - a reader blocked in `waitForDataOrShutdown` must not consume our EPOLLOUT event
+                struct pollfd pfd;
+                pfd.fd = fdSocket;
+                pfd.events = POLLOUT;
+                pfd.revents = 0;
+
+                int retval = poll(&pfd, 1, kWriteTimeoutMS);
+                if (retval > 0) {
+                    continue;
+                }
+
+                if (retval == 0) {
+                    Logger::error(
+                        SSTR << "Timed out after " << kWriteTimeoutMS << "ms waiting to write to a stalled controller"
+                    );
+                    return false;
+                }
+
+                if (errno == EINTR) {
+                    continue;
+                }
+            }
+
+            logErrno("write");
+            return false;
+        }
 
-    if (len != count) {
-        logErrno("write");
-        return false;
+        bytesWritten += len;
     }
 
     return true;
@@ -172,18 +242,13 @@ bool HciSocket::write(const uint8_t *pBuffer, size_t count) const {
 
 // Wait for data to arrive, or for a shutdown event
 //
+// We block in `epoll_wait` with a short timeout (`kDataWaitTimeMS`) so that a server shutdown is noticed promptly
+//
 // Returns true if data is available, false if we are shutting down
 bool HciSocket::waitForDataOrShutdown() const {
     while (ggkIsServerRunning()) {
-        fd_set rfds;
-        FD_ZERO(&rfds);
-        FD_SET(fdSocket, &rfds);
-
-        struct timeval tv;
-        tv.tv_sec = 0;
-        tv.tv_usec = kDataWaitTimeMS * 1000;
-
-        int retval = select(fdSocket + 1, &rfds, NULL, NULL, &tv);
+        struct epoll_event event;
+        int retval = epoll_wait(fdEpoll, &event, 1, kDataWaitTimeMS);
 
         // Do we have data?
         if (retval > 0) {
@@ -191,7 +256,8 @@ bool HciSocket::waitForDataOrShutdown() const {
         }
 
         // We have an error
-        if (retval < 0) {
+        if (retval < 0 && errno != EINTR) {
+            logErrno("epoll_wait");
             return false;
         }
 
@@ -51,10 +51,12 @@ public:
 
     // Reads data from the HCI socket
     //
-    // Raw data is read until no more data is available. If no data is available when this method initially starts to
-    // read, it will retry for a maximum timeout defined by `kMaxRetryTimeMS`.
+    // The socket is non-blocking and driven by epoll; the frame is received into a buffer preallocated at connect
+    // time and handed to the caller via `response`. If the caller reuses the same `response` vector across calls (as
+    // the adapter's event thread does), the read path performs no allocations at steady state.
     //
-    // Returns true if any data was read successfully, otherwise false is returned in the case of an error or a timeout.
+    // Returns true if data was read successfully, otherwise false is returned. A false return code does not
+    // necessarily depict an error, as this can arise from expected conditions (such as an interrupt.)
     bool read(std::vector<uint8_t> &response) const;
 
     // Writes the array of bytes of a given count
@@ -64,6 +66,9 @@ public:
 
     // Writes the array of bytes of a given count
     //
+    // The socket is non-blocking: if the kernel buffer is full (a stalled controller), the write waits for
+    // writability for at most `kWriteTimeoutMS` milliseconds rather than wedging the caller indefinitely.
+    //
     // This method returns true if the bytes were written successfully, otherwise false
     bool write(const uint8_t *pBuffer, size_t count) const;
 
@@ -78,8 +83,15 @@ private:
 
     int fdSocket;
 
+    // Our epoll instance, watching `fdSocket` for incoming frames (see `waitForDataOrShutdown`)
+    int fdEpoll;
+
+    // Our receive buffer, preallocated at connect time so the event path never allocates
+    mutable std::vector<uint8_t> readBuffer;
+
     const size_t kResponseMaxSize = 64 * 1024;
     const int kDataWaitTimeMS = 10;
+    const int kWriteTimeoutMS = 1000;
 };
 
 }; // namespace ggk
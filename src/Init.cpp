@@ -32,11 +32,17 @@
 // Want to become your own boss while working from home? (Just kidding.)
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <fstream>
+#include <future>
 #include <gio/gio.h>
+#include <queue>
+#include <stdio.h>
 #include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include "DBusInterface.h"
@@ -47,8 +53,12 @@
 #include "HciAdapter.h"
 #include "Init.h"
 #include "Logger.h"
+#include "Metrics.h"
+#include "MethodWorker.h"
 #include "Mgmt.h"
 #include "Server.h"
+#include "StreamEngine.h"
+#include "Trace.h"
 
 namespace ggk {
 
@@ -57,14 +67,24 @@ namespace ggk {
 //
 
 static const int kPeriodicTimerFrequencySeconds = 1;
-static const int kRetryDelaySeconds = 2;
-static const int kIdleFrequencyMS = 10;
+
+// Retry delays for failed initialization steps (see `setRetry`.) The delay starts small (the common failure is simply
+// bluetoothd not being up yet - a race we lose by mere milliseconds at boot) and doubles on each consecutive failure
+// up to the maximum.
+static const int kRetryInitialDelayMS = 50;
+static const int kRetryMaxDelayMS = 2000;
 
 //
 // Retries
 //
 
-static time_t retryTimeStart = 0;
+// The source ID of the pending retry timeout (0 = no retry pending.) Retries run on a dedicated one-shot timeout
+// source rather than the periodic timer, so a failed step is retried on a millisecond scale instead of waiting for
+// the next whole-second tick.
+static guint retryTimeoutId = 0;
+
+// The current retry delay, doubled on each consecutive failure and reset whenever initialization makes progress
+static int retryDelayMS = kRetryInitialDelayMS;
 
 //
 // Adapter configuration
@@ -73,6 +93,8 @@ static time_t retryTimeStart = 0;
 GDBusConnection *pBusConnection = nullptr;
 static guint ownedNameId = 0;
 static guint periodicTimeoutId = 0;
+static guint tickTimeoutId = 0;
+static guint bluezWatchId = 0;
 static std::vector<guint> registeredObjectIds;
 static std::atomic<GMainLoop *> pMainLoop(nullptr);
 static GDBusObjectManager *pBluezObjectManager = nullptr;
@@ -94,6 +116,25 @@ static std::string bluezGattManagerInterfaceName = "";
 extern void setServerRunState(enum GGKServerRunState newState);
 extern void setServerHealth(enum GGKServerHealth newHealth);
 extern int runThreadPriority;
+extern uint64_t updateQueueLastPoppedPushTimeNS();
+
+//
+// Startup timings
+//
+// Each value is the elapsed time in milliseconds from the start of the server thread to the completion of that
+// initialization phase (0 = not reached yet.) They are written from the main loop thread as each phase completes and
+// read by whichever thread calls `ggkGetStartupTimings`, hence the atomics.
+//
+
+static std::chrono::steady_clock::time_point startupTimeReference;
+static std::atomic<uint32_t> startupBusAcquiredMS(0);
+static std::atomic<uint32_t> startupNameAcquiredMS(0);
+static std::atomic<uint32_t> startupObjectManagerMS(0);
+static std::atomic<uint32_t> startupAdapterFoundMS(0);
+static std::atomic<uint32_t> startupAdapterConfiguredMS(0);
+static std::atomic<uint32_t> startupObjectsRegisteredMS(0);
+static std::atomic<uint32_t> startupApplicationRegisteredMS(0);
+static std::atomic<uint32_t> startupTotalMS(0);
 
 //
 // Forward declarations
@@ -101,60 +142,109 @@ extern int runThreadPriority;
 
 static void initializationStateProcessor();
 
+// Record the completion time of an initialization phase
+//
+// Completing a phase is progress, so this also resets the retry backoff - a failure in the next phase starts again
+// from the minimum delay rather than inheriting a delay grown by unrelated earlier failures.
+static void markStartupPhase(std::atomic<uint32_t> &phaseMS) {
+    auto elapsed = std::chrono::steady_clock::now() - startupTimeReference;
+    phaseMS = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+    retryDelayMS = kRetryInitialDelayMS;
+}
+
+// Fill `timings` with the current per-phase startup durations (see `ggkGetStartupTimings`)
+void getStartupTimings(GGKStartupTimings &timings) {
+    timings.busAcquiredMS = startupBusAcquiredMS;
+    timings.nameAcquiredMS = startupNameAcquiredMS;
+    timings.objectManagerMS = startupObjectManagerMS;
+    timings.adapterFoundMS = startupAdapterFoundMS;
+    timings.adapterConfiguredMS = startupAdapterConfiguredMS;
+    timings.objectsRegisteredMS = startupObjectsRegisteredMS;
+    timings.applicationRegisteredMS = startupApplicationRegisteredMS;
+    timings.totalMS = startupTotalMS;
+}
+
 // ---------------------------------------------------------------------------------------------------------------------------------
-//  ___    _ _           __      _       _                                             _
-// |_ _|__| | | ___     / /   __| | __ _| |_ __ _    _ __  _ __ ___   ___ ___  ___ ___(_)_ __   __ _
-//  | |/ _` | |/ _ \   / /   / _` |/ _` | __/ _` |  | '_ \| '__/ _ \ / __/ _ \/ __/ __| | '_ \ / _` |
-//  | | (_| | |  __/  / /   | (_| | (_| | || (_| |  | |_) | | | (_) | (_|  __/\__ \__ \ | | | | (_| |
-// |___\__,_|_|\___| /_/     \__,_|\__,_|\__\__,_|  | .__/|_|  \___/ \___\___||___/___/_|_| |_|\__, |
-//                                                  |_|                                        |___/
-//
-// Our idle funciton is what processes data updates. We handle this in a simple way. We update the data directly in our
-// global `TheServer` object, then call `ggkPushUpdateQueue` to trigger that data to be updated (in whatever way the
+//  _   _           _       _              _ _                 _       _
+// | | | |_ __   __| | __ _| |_ ___     __| (_)___ _ __   __ _| |_ ___| |__
+// | | | | '_ \ / _` |/ _` | __/ _ \   / _` | / __| '_ \ / _` | __/ __| '_  |
+// | |_| | |_) | (_| | (_| | ||  __/  | (_| | \__ \ |_) | (_| | || (__| | | |
+//  \___/| .__/ \__,_|\__,_|\__\___|   \__,_|_|___/ .__/ \__,_|\__\___|_| |_|
+//       |_|                                      |_|
+//
+// The update dispatcher is what processes data updates. We handle this in a simple way. We update the data directly in
+// our global `TheServer` object, then call `ggkPushUpdateQueue` to trigger that data to be updated (in whatever way the
 // service responsible for that data() sees fit.
 //
 // This is done using the `ggkPushUpdateQueue` / `ggkPopUpdateQueue` methods to manage the queue of pending update
-// messages. Each entry represents an interface that needs to be updated. The idleFunc calls the interface's
+// messages. Each entry represents an interface that needs to be updated. The dispatcher calls the interface's
 // `onUpdatedValue` method for each update.
 //
-// The idle processor will perform one update per idle tick, however, it will notify that there is more data so the idle
-// ticks do not lag behind.
+// Dispatch is event-driven: `ggkPushUpdateQueue` wakes the main loop (via `triggerUpdateDispatch`) the moment an entry
+// is enqueued, and the dispatcher drains the entire queue within a single main-loop iteration. This keeps notification
+// latency bounded by the D-Bus round-trip rather than an idle timer, even when updates arrive in large bursts.
+//
+// Entries are served in priority-lane order (see `GGKUpdatePriority` in Gobbledegook.h): the pop below always returns
+// pending control-lane updates before normal or bulk ones, so control traffic preempts a bulk transfer's flood of
+// data-chunk updates.
 // ---------------------------------------------------------------------------------------------------------------------------------
 
-// Our idle function
-//
-// This method is used to process data on the same thread as our main loop. This allows us to communicate with our
-// service from the outside.
-//
-// IMPORTANT: This method must return 'true' if any work was performed, otherwise it must return 'false'. Returning
-// 'true' will cause the idle loop to continue to call this method to process data at the maximum rate (which can peg
-// the CPU at 100%.) By returning false when there is no work to do, we are nicer to the system.
-bool idleFunc(void *pUserData) {
+// Set when a dispatch has been scheduled on the main loop but has not yet run. This lets a burst of pushes schedule
+// only a single drain rather than one idle source per push.
+static std::atomic<bool> updateDispatchPending(false);
 
-    // Don't do anything unless we're running
-    if (ggkGetServerRunState() != ERunning) {
-        return false;
-    }
+// Resolved interfaces for interned update paths, indexed by interned-path ID (see `ggkInternCharacteristicPath`)
+//
+// An interned update carries its ID through the queue, so once the ID's interface has been resolved we can dispatch
+// by array index alone - no string parsing, no path allocation, no hash lookup. Resolution happens on the first
+// update for each ID; this is only ever touched from the main loop thread.
+static std::vector<std::shared_ptr<const DBusInterface>> internedInterfaceCache;
 
+// Process a single queued update
+//
+// Returns 'true' if an update was popped from the queue (whether or not it could be delivered), otherwise 'false'.
+static bool processUpdateQueueEntry(void *pUserData) {
     // Try to get an update
     const int kQueueEntryLen = 1024;
     char queueEntry[kQueueEntryLen];
-    if (ggkPopUpdateQueue(queueEntry, kQueueEntryLen, 0) != 1) {
+    int pathId = -1;
+    if (ggkPopUpdateQueueWithId(queueEntry, kQueueEntryLen, 0, &pathId) != 1) {
         return false;
     }
 
-    std::string entryString = queueEntry;
-    auto token = entryString.find('|');
-    if (token == std::string::npos) {
-        Logger::error("Queue entry was not formatted properly - could not find separating token");
-        return false;
+    Trace::record(Trace::EUpdateDequeued, Trace::packString(queueEntry));
+
+    // The fast path: an interned update whose interface has already been resolved
+    std::shared_ptr<const DBusInterface> pInterface;
+    if (pathId >= 0 && static_cast<size_t>(pathId) < internedInterfaceCache.size()) {
+        pInterface = internedInterfaceCache[pathId];
     }
 
-    DBusObjectPath objectPath = DBusObjectPath(entryString.substr(0, token));
-    std::string interfaceName = entryString.substr(token + 1);
+    std::string interfaceName;
+    DBusObjectPath objectPath;
+    if (nullptr == pInterface) {
+        std::string entryString = queueEntry;
+        auto token = entryString.find('|');
+        if (token == std::string::npos) {
+            Logger::error("Queue entry was not formatted properly - could not find separating token");
+            return true;
+        }
+
+        objectPath = DBusObjectPath(entryString.substr(0, token));
+        interfaceName = entryString.substr(token + 1);
+
+        pInterface = TheServer->findInterface(objectPath, interfaceName);
+
+        // Remember the resolution so future updates for this ID skip the lookup
+        if (nullptr != pInterface && pathId >= 0) {
+            if (static_cast<size_t>(pathId) >= internedInterfaceCache.size()) {
+                internedInterfaceCache.resize(pathId + 1);
+            }
+            internedInterfaceCache[pathId] = pInterface;
+        }
+    }
 
     // We have an update - call the onUpdatedValue method on the interface
-    std::shared_ptr<const DBusInterface> pInterface = TheServer->findInterface(objectPath, interfaceName);
     if (nullptr == pInterface) {
         Logger::warn(
             SSTR << "Unable to find interface for update: path[" << objectPath << "], name[" << interfaceName << "]"
@@ -163,16 +253,168 @@ bool idleFunc(void *pUserData) {
         // Is it a characteristic?
         if (std::shared_ptr<const GattCharacteristic> pCharacteristic =
                 TRY_GET_CONST_INTERFACE_OF_TYPE(pInterface, GattCharacteristic)) {
-            Logger::debug(
-                SSTR << "Processing updated value for interface '" << interfaceName << "' at path '" << objectPath
-                     << "'"
+            // Nobody is subscribed to this characteristic - skip the update work entirely (see
+            // `GattCharacteristic::enableNotifySubscriptions`)
+            if (!pCharacteristic->hasSubscribers()) {
+                LOG_DEBUG(
+                    "Skipping update for unsubscribed characteristic at path '" << pCharacteristic->getPath() << "'"
+                );
+                return true;
+            }
+
+            LOG_DEBUG(
+                "Processing updated value for interface '" << pInterface->getName() << "' at path '"
+                                                           << pCharacteristic->getPath() << "'"
             );
             pCharacteristic->callOnUpdatedValue(pBusConnection, pUserData);
-            return true;
+
+            // The signal (or notification fd write) is out - record the full push-to-signal latency
+            Metrics::recordNotificationLatency(Metrics::timestampNS() - updateQueueLastPoppedPushTimeNS());
+        }
+    }
+
+    return true;
+}
+
+// Drain the entire update queue
+//
+// This method runs on the main loop thread (it is scheduled there by `triggerUpdateDispatch`.) It processes every
+// pending update in a single pass so that a burst of pushes results in a burst of notifications rather than a trickle.
+static gboolean onUpdateDispatch(gpointer pUserData) {
+    // Allow a new dispatch to be scheduled for anything pushed from here on. Anything pushed before this point will be
+    // picked up by the drain loop below.
+    updateDispatchPending = false;
+
+    // Don't do anything unless we're running - the periodic timer will kick us once we are
+    if (ggkGetServerRunState() != ERunning) {
+        return FALSE;
+    }
+
+    while (processUpdateQueueEntry(pUserData)) {
+        // Keep draining
+    }
+
+    // One-shot source - we'll be rescheduled by the next push
+    return FALSE;
+}
+
+// Wake the main loop to drain the update queue
+//
+// This method is thread-safe (it is called by `ggkPushUpdateQueue` from whichever thread produced the update.) If a
+// dispatch is already scheduled but hasn't run yet, this method does nothing - the scheduled dispatch will pick up the
+// new entry when it drains the queue.
+void triggerUpdateDispatch() {
+    // Nothing to wake once we've begun shutting down
+    if (ggkGetServerRunState() > ERunning) {
+        return;
+    }
+
+    bool expected = false;
+    if (updateDispatchPending.compare_exchange_strong(expected, true)) {
+        g_idle_add(onUpdateDispatch, nullptr);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  _____ _      _      _   _
+// |_   _(_) ___| | __ | |_(_)_ __ ___   ___ _ __
+//   | | | |/ __| |/ / | __| | '_ ` _ \ / _ \ '__|
+//   | | | | (__|   <  | |_| | | | | | |  __/ |
+//   |_| |_|\___|_|\_\  \__|_|_| |_| |_|\___|_|
+//
+// Tick events used to ride the one-second periodic timer: every tick walked the entire object tree and every event
+// compared its own elapsed time, capping resolution at one second and costing a full-tree scan even when nothing was
+// due. Now events are collected once (after the application registers) into a min-heap keyed on each event's next due
+// time, and a one-shot GLib timeout is armed for exactly the earliest due time. Sub-second periods (see `onEventMS`)
+// cost nothing extra, and an idle tree costs nothing at all.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// One entry in the tick schedule: an event, the interface it belongs to (which knows how to fire it - see
+// `fireTickEvent`), and the next time it is due
+struct ScheduledTick {
+    uint64_t dueTimeMS;
+    const DBusInterface *pInterface;
+    const TickEvent *pEvent;
+
+    // Ordering for the min-heap (std::priority_queue keeps the *largest* element on top, so we use std::greater to
+    // flip it and keep the earliest due time on top)
+    bool operator>(const ScheduledTick &other) const {
+        return dueTimeMS > other.dueTimeMS;
+    }
+};
+
+typedef std::priority_queue<ScheduledTick, std::vector<ScheduledTick>, std::greater<ScheduledTick>> TickSchedule;
+static TickSchedule tickSchedule;
+
+static gboolean onTickTimer(gpointer pUserData);
+
+// Returns the monotonic clock in milliseconds (the timebase for the tick schedule)
+static uint64_t tickNowMS() {
+    auto elapsed = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+}
+
+// Arms a one-shot timeout for the earliest due event (or none at all if the schedule is empty)
+static void armTickTimer() {
+    if (tickSchedule.empty()) {
+        return;
+    }
+
+    uint64_t nowMS = tickNowMS();
+    uint64_t dueTimeMS = tickSchedule.top().dueTimeMS;
+    tickTimeoutId = g_timeout_add(dueTimeMS > nowMS ? static_cast<guint>(dueTimeMS - nowMS) : 0, onTickTimer, nullptr);
+}
+
+// Builds the tick schedule from the server description and arms the timer
+//
+// Called once the application is registered with BlueZ (firing events any earlier would emit signals nobody can
+// receive.) A server description without any tick events produces an empty schedule and no timer at all.
+static void buildTickSchedule() {
+    uint64_t nowMS = tickNowMS();
+
+    std::vector<std::pair<const DBusInterface *, const TickEvent *>> eventList;
+    for (const DBusObject &object : TheServer->getObjects()) {
+        if (object.isPublished()) {
+            object.collectTickEvents(eventList);
         }
     }
 
-    return false;
+    for (const std::pair<const DBusInterface *, const TickEvent *> &entry : eventList) {
+        ScheduledTick tick = {nowMS + entry.second->getPeriodMS(), entry.first, entry.second};
+        tickSchedule.push(tick);
+    }
+
+    Logger::debug(SSTR << "Tick schedule built with " << eventList.size() << " event(s)");
+    armTickTimer();
+}
+
+// Tick timer handler
+//
+// Fires every event that has come due, reschedules each one period into the future, and re-arms the timer for the new
+// earliest due time. This is a one-shot source - `armTickTimer` creates a fresh timeout on every pass.
+static gboolean onTickTimer(gpointer /*pUserData*/) {
+    tickTimeoutId = 0;
+
+    // If we're shutting down, let the schedule die quietly
+    if (ggkGetServerRunState() > ERunning) {
+        return FALSE;
+    }
+
+    uint64_t nowMS = tickNowMS();
+    while (!tickSchedule.empty() && tickSchedule.top().dueTimeMS <= nowMS) {
+        ScheduledTick tick = tickSchedule.top();
+        tickSchedule.pop();
+
+        tick.pInterface->fireTickEvent(*tick.pEvent, pBusConnection, pBusConnection);
+
+        // Reschedule from now rather than from the old due time, so a stalled main loop yields a late tick instead of
+        // a burst of catch-up ticks
+        tick.dueTimeMS = tickNowMS() + tick.pEvent->getPeriodMS();
+        tickSchedule.push(tick);
+    }
+
+    armTickTimer();
+    return FALSE;
 }
 
 // ---------------------------------------------------------------------------------------------------------------------------------
@@ -237,6 +479,27 @@ void uninit() {
         periodicTimeoutId = 0;
     }
 
+    if (0 != tickTimeoutId) {
+        g_source_remove(tickTimeoutId);
+        tickTimeoutId = 0;
+    }
+
+    // The tick schedule holds pointers into the server description, so drop it before the server goes away
+    tickSchedule = TickSchedule();
+
+    // Join the deferred-invocation workers before the server description (which their jobs reference) goes away
+    MethodWorker::stop();
+
+    if (0 != retryTimeoutId) {
+        g_source_remove(retryTimeoutId);
+        retryTimeoutId = 0;
+    }
+
+    if (0 != bluezWatchId) {
+        g_bus_unwatch_name(bluezWatchId);
+        bluezWatchId = 0;
+    }
+
     if (ownedNameId > 0) {
         g_bus_unown_name(ownedNameId);
     }
@@ -294,36 +557,21 @@ void shutdown() {
 
 // Periodic timer handler
 //
-// A periodic timer is a timer fires every so often (see kPeriodicTimerFrequencySeconds.) This is used for our
-// initialization failure retries, but custom code can also be added to a server description (see `onEvent()`)
-gboolean onPeriodicTimer(gpointer pUserData) {
+// A periodic timer is a timer fires every so often (see kPeriodicTimerFrequencySeconds.) Tick events no longer run
+// here - they have their own scheduler (see the tick scheduler above) which fires exactly when the earliest event is
+// due. What remains is low-rate housekeeping. Note that initialization retries don't run here either - they have
+// their own millisecond-scale timeout source (see `setRetry`.)
+gboolean onPeriodicTimer(gpointer /*pUserData*/) {
     // If we're shutting down, don't do anything and stop the periodic timer
     if (ggkGetServerRunState() > ERunning) {
         return FALSE;
     }
 
-    // Deal with retry timers
-    if (0 != retryTimeStart) {
-        Logger::debug(SSTR << "Ticking retry timer");
-
-        // Has the retry time expired?
-        int secondsRemaining = time(nullptr) - retryTimeStart - kRetryDelaySeconds;
-        if (secondsRemaining >= 0) {
-            retryTimeStart = 0;
-            initializationStateProcessor();
-        }
-    }
-
-    // If we're registered, then go ahead and emit signals
     if (bApplicationRegistered) {
-        // Tick the object hierarchy
-        //
-        // The real goal here is to have the objects tick their interfaces (see `onEvent()` method when adding
-        // interfaces inside 'Server::Server()'
-        for (const DBusObject &object : TheServer->getObjects()) {
-            if (object.isPublished()) {
-                object.tickEvents(pBusConnection, pUserData);
-            }
+        // Catch-all: if anything was pushed onto the update queue before we reached the running state (when dispatches
+        // are ignored), make sure it gets drained now
+        if (ggkUpdateQueueIsEmpty() == 0) {
+            triggerUpdateDispatch();
         }
     }
 
@@ -502,17 +750,44 @@ gboolean onSetProperty(
 //
 // ---------------------------------------------------------------------------------------------------------------------------------
 
+// One-shot retry timeout handler
+//
+// Fires once when the current backoff delay has elapsed, then hands control back to the state processor to retry the
+// failed step
+static gboolean onRetryTimer(gpointer /*pUserData*/) {
+    retryTimeoutId = 0;
+
+    // If we're shutting down, there's nothing left to retry
+    if (ggkGetServerRunState() > ERunning) {
+        return FALSE;
+    }
+
+    initializationStateProcessor();
+    return FALSE;
+}
+
 // Convenience method for setting a retry timer so that operations can be continuously retried until we eventually
 // succeed
+//
+// The retry is scheduled on a dedicated one-shot timeout source with exponential backoff: the first retry comes after
+// `kRetryInitialDelayMS` milliseconds, and each consecutive failure doubles the delay up to `kRetryMaxDelayMS`. The
+// backoff resets whenever initialization makes progress (see `markStartupPhase`.)
 void setRetry() {
-    retryTimeStart = time(nullptr);
+    // If a retry is already scheduled, leave it be
+    if (0 != retryTimeoutId) {
+        return;
+    }
+
+    retryTimeoutId = g_timeout_add(retryDelayMS, onRetryTimer, nullptr);
+    retryDelayMS = std::min(retryDelayMS * 2, kRetryMaxDelayMS);
 }
 
 // Convenience method for setting a retry timer so that failures (related to initialization) can be continuously retried
 // until we eventually succeed.
 void setRetryFailure() {
+    int delayMS = retryDelayMS;
     setRetry();
-    Logger::warn(SSTR << "  + Will retry the failed operation in about " << kRetryDelaySeconds << " seconds");
+    Logger::warn(SSTR << "  + Will retry the failed operation in about " << delayMS << "ms");
 }
 
 // ---------------------------------------------------------------------------------------------------------------------------------
@@ -552,6 +827,10 @@ void doRegisterApplication() {
                 g_variant_unref(pVariant);
                 Logger::debug(SSTR << "GATT application registered with BlueZ");
                 bApplicationRegistered = true;
+                markStartupPhase(startupApplicationRegisteredMS);
+
+                // Now that somebody can hear our signals, start the tick events
+                buildTickSchedule();
             }
 
             // Keep going...
@@ -603,8 +882,7 @@ void registerNodeHierarchy(GDBusNodeInfo *pNode, const DBusObjectPath &basePath
         if (0 == registeredObjectId) {
             Logger::error(SSTR << "Failed to register object: " << (nullptr == pError ? "Unknown" : pError->message));
 
-            // Cleanup and pretend like we were never here
-            g_dbus_node_info_unref(pNode);
+            // Cleanup and pretend like we were never here (the node itself is owned - and released - by our caller)
             registeredObjectIds.clear();
 
             // Try again later
@@ -627,26 +905,79 @@ void registerNodeHierarchy(GDBusNodeInfo *pNode, const DBusObjectPath &basePath
 }
 
 void registerObjects() {
-    // Parse each object into an XML interface tree
+    auto phaseStart = std::chrono::steady_clock::now();
+    auto phaseMS = [&phaseStart]() {
+        auto now = std::chrono::steady_clock::now();
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - phaseStart).count();
+        phaseStart = now;
+        return ms;
+    };
+
+    // Generate and parse the introspection XML for every object in parallel worker threads
+    //
+    // `generateIntrospectionXML` is a pure walk of our immutable object tree and `g_dbus_node_info_new_for_xml` just
+    // builds a standalone structure, so both are safe to run concurrently. With a full GATT tree this is the bulk of
+    // the registration cost, so spreading it across cores (and overlapping the parses) is a visible startup win.
+    std::vector<std::future<GDBusNodeInfo *>> parseTasks;
     for (const DBusObject &object : TheServer->getObjects()) {
-        GError *pError = nullptr;
-        std::string xmlString = object.generateIntrospectionXML();
-        GDBusNodeInfo *pNode = g_dbus_node_info_new_for_xml(xmlString.c_str(), &pError);
-        if (nullptr == pNode) {
-            Logger::error(SSTR << "Failed to introspect XML: " << (nullptr == pError ? "Unknown" : pError->message));
-            setRetryFailure();
-            return;
+        parseTasks.push_back(std::async(std::launch::async, [&object]() -> GDBusNodeInfo * {
+            GError *pError = nullptr;
+            std::string xmlString = object.generateIntrospectionXML();
+            GDBusNodeInfo *pNode = g_dbus_node_info_new_for_xml(xmlString.c_str(), &pError);
+            if (nullptr == pNode) {
+                Logger::error(
+                    SSTR << "Failed to introspect XML: " << (nullptr == pError ? "Unknown" : pError->message)
+                );
+            }
+            return pNode;
+        }));
+    }
+
+    // Collect every result before acting on any of them, so a failed worker can't leak its siblings' nodes
+    std::vector<GDBusNodeInfo *> parsedNodes;
+    bool parseFailed = false;
+    for (std::future<GDBusNodeInfo *> &task : parseTasks) {
+        GDBusNodeInfo *pNode = task.get();
+        parsedNodes.push_back(pNode);
+        parseFailed = parseFailed || nullptr == pNode;
+    }
+
+    Logger::debug(
+        SSTR << "Introspection XML for " << parsedNodes.size() << " object(s) generated and parsed in " << phaseMS()
+             << "ms"
+    );
+
+    if (parseFailed) {
+        for (GDBusNodeInfo *pNode : parsedNodes) {
+            if (nullptr != pNode) {
+                g_dbus_node_info_unref(pNode);
+            }
         }
 
-        Logger::debug(SSTR << "Registering object hierarchy with D-Bus hierarchy");
+        setRetryFailure();
+        return;
+    }
 
-        // Register the node hierarchy
-        registerNodeHierarchy(pNode, DBusObjectPath(pNode->path));
+    // Submit the registrations in one tight pass
+    Logger::debug(SSTR << "Registering object hierarchy with D-Bus hierarchy");
+    for (GDBusNodeInfo *pNode : parsedNodes) {
+        // Register the node hierarchy, unless an earlier node already failed and scheduled a retry
+        if (0 == retryTimeoutId) {
+            registerNodeHierarchy(pNode, DBusObjectPath(pNode->path));
+        }
 
         // Cleanup the node
         g_dbus_node_info_unref(pNode);
     }
 
+    if (0 != retryTimeoutId) {
+        return;
+    }
+
+    Logger::debug(SSTR << "D-Bus objects registered in " << phaseMS() << "ms");
+
+    markStartupPhase(startupObjectsRegisteredMS);
+
     // Keep going
     initializationStateProcessor();
 }
@@ -661,14 +992,74 @@ void registerObjects() {
 //
 // ---------------------------------------------------------------------------------------------------------------------------------
 
+//
+// Adapter configuration cache
+//
+// After a successful configuration we persist a signature of the applied config (flags, names, advertising id) to a
+// small file. On the next start, if the target config matches the cached one, we know the controller's settings are
+// our own leftovers from the previous run - so a warm restart (our watchdog restarting the service after an OTA,
+// say) can apply just the actual deltas without the conservative remove-advertising/power-cycle dance, shaving
+// several blocking HCI round trips off the time back to advertising.
+//
+// The cache lives in /tmp on purpose: controller settings don't survive a host reboot either, so the cache's
+// lifetime matches the state it describes. The cache is purely an optimization - if it can't be read or written we
+// just take the cold path.
+//
+
+// The cache file for the controller this server is bound to
+static std::string adapterConfigCachePath() {
+    return "/tmp/ggk-adapter" + std::to_string(TheServer->getControllerIndex()) + ".cache";
+}
+
+// A one-line signature of the target adapter configuration
+static std::string adapterConfigSignature(const std::string &advertisingName, const std::string &advertisingShortName) {
+    std::ostringstream signature;
+    signature << "1|" << TheServer->getEnableBREDR() << TheServer->getEnableSecureConnection()
+              << TheServer->getEnableBondable() << TheServer->getEnableConnectable()
+              << TheServer->getEnableDiscoverable() << TheServer->getEnableAdvertising() << "|"
+              << TheServer->getAdvertisingServiceId() << "|" << advertisingName << "|" << advertisingShortName;
+    return signature.str();
+}
+
+// Returns true if the cache holds `signature` (the previous run applied exactly this configuration)
+//
+// The cache is consumed by the check: a successful configuration writes it afresh, so if a warm attempt fails, the
+// retry takes the cold (power-cycle) path instead of failing warm forever.
+static bool adapterConfigCacheMatches(const std::string &signature) {
+    const std::string path = adapterConfigCachePath();
+
+    std::string cachedSignature;
+    {
+        std::ifstream cacheFile(path);
+        if (!cacheFile || !std::getline(cacheFile, cachedSignature)) {
+            return false;
+        }
+    }
+
+    ::remove(path.c_str());
+    return cachedSignature == signature;
+}
+
+// Records `signature` as the configuration now on the controller
+static void writeAdapterConfigCache(const std::string &signature) {
+    std::ofstream cacheFile(adapterConfigCachePath(), std::ios::trunc);
+    if (!cacheFile) {
+        Logger::debug(SSTR << "Unable to write adapter config cache '" << adapterConfigCachePath() << "'");
+        return;
+    }
+
+    cacheFile << signature << "\n";
+}
+
 // Configure an adapter to ensure it is setup the way we need. We turn things on that we need and turn everything else
 // off (to maximize security.)
 //
-// Note that this only works for the first adapter (index 0). Search for kControllerIndex for information.
+// The adapter configured is the one the server was bound to at start (index 0 unless started via
+// `ggkStartOnAdapter`.)
 //
 // See also: https://git.kernel.org/pub/scm/bluetooth/bluez.git/tree/doc/mgmt-api.txt
 void configureAdapter() {
-    Mgmt mgmt;
+    Mgmt mgmt(static_cast<uint16_t>(TheServer->getControllerIndex()));
 
     // Get our properly truncated advertising names
     std::string advertisingName = Mgmt::truncateName(TheServer->getAdvertisingName());
@@ -690,10 +1081,21 @@ void configureAdapter() {
     bool anFlag = (advertisingName.length() == 0 || advertisingName == info.name) &&
                   (advertisingShortName.length() == 0 || advertisingShortName == info.shortName);
 
+    // A warm restart is one where the previous run applied exactly this configuration (see the adapter config cache
+    // above) and the structural settings (LE, BR/EDR) are already right - then whatever is on the controller is our
+    // own leftovers, including any advertising instance, and the deltas below can be applied without the
+    // conservative remove-advertising/power-cycle sequence.
+    const std::string configSignature = adapterConfigSignature(advertisingName, advertisingShortName);
+    const bool bWarmRestart = leFlag && brFlag && adapterConfigCacheMatches(configSignature);
+
+    // Whether we took the adapter down (so we know to bring it back up)
+    bool bPoweredDown = false;
+
     // If everything is setup already, we're done
     if (!pwFlag || !leFlag || !brFlag || !scFlag || !bnFlag || !cnFlag || !diFlag || !adFlag || !anFlag) {
-        // We need it off to start with
-        if (pwFlag) {
+        // We need it off to start with (unless this is a warm restart, where the remaining deltas apply fine with
+        // the adapter up)
+        if (pwFlag && !bWarmRestart) {
 
             // Remove a pre existing advertising instance in case app was restarted or crashed and couldn't cleanup.
             Logger::debug("Removing possible advertising instance");
@@ -704,6 +1106,8 @@ void configureAdapter() {
                 setRetry();
                 return;
             }
+
+            bPoweredDown = true;
         }
 
         // Enable the LE state (we always set this state if it's not set)
@@ -726,42 +1130,47 @@ void configureAdapter() {
             }
         }
 
+        // The four settings below are independent of one another (unlike LE/BR-EDR above, which the adapter requires
+        // in order), so pipeline them: issue every needed command back-to-back and fence once for the whole batch,
+        // paying a single adapter round-trip instead of one per setting.
+        bool batchSent = true;
+
         // Change the Secure Connectinos state?
         if (!scFlag) {
             Logger::debug(
                 SSTR << (TheServer->getEnableSecureConnection() ? "Enabling" : "Disabling") << " Secure Connections"
             );
-            if (!mgmt.setSecureConnections(TheServer->getEnableSecureConnection() ? 1 : 0)) {
-                setRetry();
-                return;
-            }
+            batchSent = mgmt.setStateAsync(
+                            Mgmt::ESetSecureConnectionsCommand,
+                            TheServer->getEnableSecureConnection() ? 1 : 0
+                        ) &&
+                        batchSent;
         }
 
         // Change the Bondable state?
         if (!bnFlag) {
             Logger::debug(SSTR << (TheServer->getEnableBondable() ? "Enabling" : "Disabling") << " Bondable");
-            if (!mgmt.setBondable(TheServer->getEnableBondable())) {
-                setRetry();
-                return;
-            }
+            batchSent =
+                mgmt.setStateAsync(Mgmt::ESetBondableCommand, TheServer->getEnableBondable() ? 1 : 0) && batchSent;
         }
 
         // Change the Connectable state?
         if (!cnFlag) {
             Logger::debug(SSTR << (TheServer->getEnableConnectable() ? "Enabling" : "Disabling") << " Connectable");
-            if (!mgmt.setConnectable(TheServer->getEnableConnectable())) {
-                setRetry();
-                return;
-            }
+            batchSent = mgmt.setStateAsync(Mgmt::ESetConnectableCommand, TheServer->getEnableConnectable() ? 1 : 0) &&
+                        batchSent;
         }
 
         // Change the Discoverable state?
         if (!diFlag) {
             Logger::debug(SSTR << (TheServer->getEnableDiscoverable() ? "Enabling" : "Disabling") << " Discoverable");
-            if (!mgmt.setDiscoverable(TheServer->getEnableDiscoverable() ? 1 : 0, 0)) {
-                setRetry();
-                return;
-            }
+            batchSent = mgmt.setDiscoverableAsync(TheServer->getEnableDiscoverable() ? 1 : 0, 0) && batchSent;
+        }
+
+        // Wait for the whole batch to complete before moving on to advertising
+        if (!batchSent || !HciAdapter::getInstance().waitForPendingCommands(HciAdapter::kMaxEventWaitTimeMS)) {
+            setRetry();
+            return;
         }
 
         if (!adFlag) {
@@ -796,20 +1205,32 @@ void configureAdapter() {
             }
         }
 
-        // Turn it back on
-        Logger::debug("Powering on");
-        if (!mgmt.setPowered(true)) {
-            setRetry();
-            return;
+        // Turn it back on (if it was down - a warm restart never took it down)
+        if (bPoweredDown || !pwFlag) {
+            Logger::debug("Powering on");
+            if (!mgmt.setPowered(true)) {
+                setRetry();
+                return;
+            }
         }
     } else {
         Logger::debug("We are done arelady");
     }
 
+    // Program the controller's resolving and accept lists from the bond cache, so known devices reconnect without
+    // the full rediscovery dance. Purely an optimization - on failure, devices simply pair the slow way.
+    if (!mgmt.loadBondedDevices()) {
+        Logger::warn("Unable to load bonded devices into the controller - known devices will pair the slow way");
+    }
+
     Logger::info("The Bluetooth adapter is fully configured");
 
+    // Remember what we applied, so the next restart can take the warm path
+    writeAdapterConfigCache(configSignature);
+
     // We're all set, nothing to do!
     bAdapterConfigured = true;
+    markStartupPhase(startupAdapterConfiguredMS);
     initializationStateProcessor();
 }
 
@@ -823,8 +1244,8 @@ void configureAdapter() {
 //
 // ---------------------------------------------------------------------------------------------------------------------------------
 
-// Find the BlueZ's GATT Manager interface for the *first* Bluetooth adapter provided by BlueZ. We'll need this to
-// register our GATT server with BlueZ.
+// Find the BlueZ's GATT Manager interface for the Bluetooth adapter this server is bound to (hci0 unless started via
+// `ggkStartOnAdapter`.) We'll need this to register our GATT server with BlueZ.
 void findAdapterInterface() {
     // Get a list of the BlueZ's D-Bus objects
     GList *pObjects = g_dbus_object_manager_get_objects(pBluezObjectManager);
@@ -834,9 +1255,10 @@ void findAdapterInterface() {
         return;
     }
 
-    // Scan the list of objects we find one with a GATT manager interface
-    //
-    // Note that if there are multiple interfaces, we will only find the first
+    // BlueZ exposes each controller as an object named for its index ("/org/bluez/hci0", "/org/bluez/hci1", ...)
+    std::string adapterPathSuffix = "/hci" + std::to_string(TheServer->getControllerIndex());
+
+    // Scan the list of objects for our adapter's object with a GATT manager interface
     for (guint i = 0; i < g_list_length(pObjects) && bluezGattManagerInterfaceName.empty(); ++i) {
         // Current object in question
         pBluezAdapterObject = static_cast<GDBusObject *>(g_list_nth_data(pObjects, i));
@@ -844,6 +1266,15 @@ void findAdapterInterface() {
             continue;
         }
 
+        // Is this the adapter we were bound to?
+        std::string objectPath = g_dbus_object_get_object_path(pBluezAdapterObject);
+        if (objectPath.length() < adapterPathSuffix.length() ||
+            0 != objectPath.compare(
+                     objectPath.length() - adapterPathSuffix.length(), adapterPathSuffix.length(), adapterPathSuffix
+                 )) {
+            continue;
+        }
+
         // See if it has a GATT manager interface
         pBluezGattManagerProxy =
             reinterpret_cast<GDBusProxy *>(g_dbus_object_get_interface(pBluezAdapterObject, "org.bluez.GattManager1"));
@@ -903,6 +1334,8 @@ void findAdapterInterface() {
         return;
     }
 
+    markStartupPhase(startupAdapterFoundMS);
+
     // Keep going
     initializationStateProcessor();
 }
@@ -917,6 +1350,39 @@ void findAdapterInterface() {
 //
 // ---------------------------------------------------------------------------------------------------------------------------------
 
+// Watches BlueZ's Device1 objects for connection-state changes (see the signal connection in `getBluezObjectManager`)
+//
+// BlueZ sends StopNotify to our characteristics on clean notify-session teardowns, but not every disconnect is clean
+// (out-of-range, battery death, etc.) When a device's `Connected` property drops to false and no connections remain,
+// we clear any notification subscriptions the departed clients left behind so the update path doesn't keep doing work
+// for nobody (see `GattCharacteristic::enableNotifySubscriptions`.)
+static void onBluezInterfaceProxyPropertiesChanged(
+    GDBusObjectManagerClient * /*pManager*/,
+    GDBusObjectProxy * /*pObjectProxy*/,
+    GDBusProxy *pInterfaceProxy,
+    GVariant *pChangedProperties,
+    const gchar *const * /*ppInvalidatedProperties*/,
+    gpointer /*pUserData*/
+) {
+    // We only care about Device1 connection state
+    if (0 != g_strcmp0(g_dbus_proxy_get_interface_name(pInterfaceProxy), "org.bluez.Device1")) {
+        return;
+    }
+
+    gboolean connected = TRUE;
+    if (!g_variant_lookup(pChangedProperties, "Connected", "b", &connected) || TRUE == connected) {
+        return;
+    }
+
+    if (nullptr != TheServer && 0 == HciAdapter::getInstance().getActiveConnectionCount()) {
+        Logger::debug("Last client disconnected - clearing notification subscriptions");
+        TheServer->clearNotifySubscriptions();
+
+        // A streaming transfer can't outlive its receiver
+        StreamEngine::getInstance().cancel();
+    }
+}
+
 // Get the D-Bus Object Manager client to the BlueZ ObjectManager object
 //
 // An ObjectManager allows us to find out what objects (and from those, interfaces, etc.) are available from an owned
@@ -947,6 +1413,17 @@ void getBluezObjectManager() {
                 return;
             }
 
+            // Watch Device1 connection state so an unclean disconnect can't leave stale notification subscriptions
+            // behind (see `onBluezInterfaceProxyPropertiesChanged`)
+            g_signal_connect(
+                pBluezObjectManager,
+                "interface-proxy-properties-changed",
+                G_CALLBACK(onBluezInterfaceProxyPropertiesChanged),
+                nullptr
+            );
+
+            markStartupPhase(startupObjectManagerMS);
+
             // Keep going
             initializationStateProcessor();
         },
@@ -990,6 +1467,7 @@ void doOwnedNameAcquire() {
 
             // Bus name acquired
             bOwnedNameAcquired = true;
+            markStartupPhase(startupNameAcquiredMS);
 
             // Keep going...
             initializationStateProcessor();
@@ -1031,6 +1509,41 @@ void doOwnedNameAcquire() {
 //
 // ---------------------------------------------------------------------------------------------------------------------------------
 
+// Watch for BlueZ's well-known name on the bus
+//
+// At boot we race bluetoothd onto the bus, and losing that race is the most common reason an initialization step
+// fails. Rather than waiting out a retry delay, we watch for the name: the moment bluetoothd appears, any pending
+// retry is cancelled and the failed step is retried immediately.
+static void watchBluezName() {
+    bluezWatchId = g_bus_watch_name_on_connection(
+        pBusConnection,              // GDBusConnection *connection
+        "org.bluez",                 // const gchar *name
+        G_BUS_NAME_WATCHER_FLAGS_NONE, // GBusNameWatcherFlags flags
+
+        // GBusNameAppearedCallback name_appeared_handler
+        [](GDBusConnection *, const gchar *, const gchar *, gpointer) {
+            Logger::debug("BlueZ appeared on the bus");
+
+            // If a failed step is waiting out its backoff (almost certainly because bluetoothd wasn't up yet), retry
+            // it right now rather than letting the delay run its course
+            if (0 != retryTimeoutId) {
+                g_source_remove(retryTimeoutId);
+                retryTimeoutId = 0;
+                retryDelayMS = kRetryInitialDelayMS;
+                initializationStateProcessor();
+            }
+        },
+
+        // GBusNameVanishedCallback name_vanished_handler
+        [](GDBusConnection *, const gchar *, gpointer) {
+            Logger::warn("BlueZ is not (or is no longer) on the bus");
+        },
+
+        nullptr, // gpointer user_data
+        nullptr  // GDestroyNotify user_data_free_func
+    );
+}
+
 // Acquire a connection to the SYSTEM bus so we can communicate with BlueZ.
 //
 // Note about error management: We don't yet hwave a timeout callback running for retries; errors are considered fatal
@@ -1051,6 +1564,11 @@ void doBusAcquire() {
                 );
                 setServerHealth(EFailedInit);
                 shutdown();
+            } else {
+                markStartupPhase(startupBusAcquiredMS);
+
+                // Keep an eye out for bluetoothd - at boot we may well beat it onto the bus
+                watchBluezName();
             }
 
             // Continue
@@ -1076,7 +1594,7 @@ void doBusAcquire() {
 // out-of-order sort of way, we can still handle it and recover nicely.
 void initializationStateProcessor() {
     // If we're in our end-of-life or waiting for a retry, don't process states
-    if (ggkGetServerRunState() > ERunning || 0 != retryTimeStart) {
+    if (ggkGetServerRunState() > ERunning || 0 != retryTimeoutId) {
         return;
     }
 
@@ -1153,6 +1671,8 @@ void initializationStateProcessor() {
     }
 
     // Successful initialization - switch to running state
+    markStartupPhase(startupTotalMS);
+    Logger::info(SSTR << "Server initialized in " << startupTotalMS << "ms");
     setServerRunState(ERunning);
 }
 
@@ -1181,6 +1701,7 @@ void runServerThread() {
         }
     }
     // Set the initialization state
+    startupTimeReference = std::chrono::steady_clock::now();
     setServerRunState(EInitializing);
 
     // Start our state processor, which is really just a simplified state machine that steps us through an asynchronous
@@ -1199,26 +1720,9 @@ void runServerThread() {
     Logger::debug(SSTR << "Creating GLib main loop");
     pMainLoop = g_main_loop_new(NULL, FALSE);
 
-    // Add the idle function
-    //
-    // Note that we actually run the idle function from a lambda. This allows us to manage the inter-idle sleep so we
-    // don't soak up 100% of our CPU.
-    guint res = g_idle_add(
-        [](gpointer pUserData) -> gboolean {
-            // Try to process some data and if no data is processed, sleep for the requested frequency
-            if (!idleFunc(pUserData)) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(kIdleFrequencyMS));
-            }
-
-            // Always return TRUE so our idle remains in tact
-            return TRUE;
-        },
-        nullptr
-    );
-
-    if (res == 0) {
-        Logger::error(SSTR << "Unable to add idle to main loop");
-    }
+    // Note that there is no idle function here. Update dispatch is event-driven: `ggkPushUpdateQueue` wakes the main
+    // loop (see `triggerUpdateDispatch`) and the queue is drained in a single main-loop iteration. This keeps the loop
+    // fully asleep when there is no work to do, rather than polling on a timer.
 
     Logger::trace(SSTR << "Starting GLib main loop");
     g_main_loop_run(pMainLoop);
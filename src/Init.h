@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include "../include/Gobbledegook.h"
+
 namespace ggk {
 
 // Trigger a graceful, asynchronous shutdown of the server
@@ -29,6 +31,17 @@ namespace ggk {
 // This method is non-blocking and as such, will only trigger the shutdown process but not wait for it
 void shutdown();
 
+// Fill `timings` with the current per-phase startup durations (see `ggkGetStartupTimings`)
+//
+// This method is thread-safe
+void getStartupTimings(GGKStartupTimings &timings);
+
+// Wake the main loop so that it drains the update queue
+//
+// This method is thread-safe; it is called by `ggkPushUpdateQueue` whenever an entry is enqueued so that updates are
+// dispatched immediately rather than on the next poll
+void triggerUpdateDispatch();
+
 // Entry point for the asynchronous server thread
 //
 // This method should not be called directly, instead, direct your attention over to `ggkStart()`
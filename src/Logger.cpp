@@ -46,12 +46,141 @@
 // There is an additional macro (SSTR) which can simplify sending dynamic data to the logger via a string stream:
 //
 //    Logger::info(SSTR << "There were " << count << " entries in the list");
+//
+// By default, receivers are invoked synchronously on the calling thread. For latency-sensitive callers (the HCI event
+// thread, the D-Bus dispatch path) an asynchronous mode is available (see `ggkLogEnableAsync`): messages are deposited
+// into a preallocated lock-free ring and a background drain thread invokes the receivers, prefixing each message with
+// a monotonic timestamp. FATAL logs always remain synchronous, and messages dropped on ring overflow are counted (see
+// `ggkGetLogDroppedMessageCount`.)
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+
 #include "Logger.h"
 
 namespace ggk {
 
+//
+// Asynchronous mode internals
+//
+// The ring is a bounded multi-producer/single-consumer queue of fixed-size slots. Each slot carries a per-slot
+// sequence number (the standard bounded-queue protocol: a slot is free for producer `n` when its sequence equals `n`,
+// and ready for the consumer when it equals `n + 1`.) Producers claim a slot with a single compare-and-swap, copy
+// their formatted message into the slot's preallocated text buffer (truncating if necessary) along with a monotonic
+// timestamp, and publish it by advancing the slot's sequence. The drain thread is the only consumer.
+//
+// When the ring is full the message is dropped and counted rather than blocking the caller - the entire point of
+// asynchronous mode is that the logging hot path never waits.
+//
+
+// Number of slots in the ring (must be a power of two)
+static const size_t kAsyncRingSlotCount = 1024;
+
+// Maximum message length stored per slot - longer messages are truncated
+static const size_t kAsyncMessageMaxLength = 511;
+
+// How long the drain thread naps when the ring is empty
+static const int kAsyncDrainIdleSleepMS = 1;
+
+// One entry in the ring
+struct AsyncLogSlot {
+    std::atomic<uint64_t> sequence;
+    GGKLogReceiver receiver;
+    uint64_t timestampNS;
+    char text[kAsyncMessageMaxLength + 1];
+};
+
+// The preallocated ring itself
+static AsyncLogSlot asyncRing[kAsyncRingSlotCount];
+
+// Producer cursor - the next slot index to claim
+static std::atomic<uint64_t> asyncHead(0);
+
+// Whether asynchronous mode is currently enabled (checked on every dispatch)
+static std::atomic<bool> asyncEnabled(false);
+
+// Whether the drain thread should keep running (cleared by `disableAsync`)
+static std::atomic<bool> asyncDrainRunning(false);
+
+// Messages dropped because the ring was full
+static std::atomic<uint32_t> asyncDroppedMessages(0);
+
+// The background drain thread
+static std::thread asyncDrainThread;
+
+// Returns the monotonic clock in nanoseconds
+static uint64_t monotonicTimestampNS() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Deposit a message into the ring, returning false (and counting a drop) if the ring is full
+static bool asyncEnqueue(GGKLogReceiver receiver, const char *pText) {
+    uint64_t head = asyncHead.load(std::memory_order_relaxed);
+    for (;;) {
+        AsyncLogSlot &slot = asyncRing[head & (kAsyncRingSlotCount - 1)];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        int64_t difference = static_cast<int64_t>(sequence) - static_cast<int64_t>(head);
+
+        if (0 == difference) {
+            // The slot is free - try to claim it
+            if (asyncHead.compare_exchange_weak(head, head + 1, std::memory_order_relaxed)) {
+                slot.receiver = receiver;
+                slot.timestampNS = monotonicTimestampNS();
+                strncpy(slot.text, pText, kAsyncMessageMaxLength);
+                slot.text[kAsyncMessageMaxLength] = 0;
+                slot.sequence.store(head + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (difference < 0) {
+            // The consumer hasn't released this slot yet - the ring is full
+            asyncDroppedMessages.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            // Another producer claimed the slot first - re-read the cursor and try again
+            head = asyncHead.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+// The drain thread - invokes receivers for queued messages until asked to stop, then drains the remainder
+static void asyncDrainProc() {
+    uint64_t tail = 0;
+    char line[kAsyncMessageMaxLength + 32];
+
+    for (;;) {
+        AsyncLogSlot &slot = asyncRing[tail & (kAsyncRingSlotCount - 1)];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+        if (sequence == tail + 1) {
+            // Prefix the message with its monotonic [seconds.microseconds] timestamp
+            unsigned long long seconds = slot.timestampNS / 1000000000ULL;
+            unsigned long long microseconds = (slot.timestampNS % 1000000000ULL) / 1000ULL;
+            snprintf(line, sizeof(line), "[%5llu.%06llu] %s", seconds, microseconds, slot.text);
+
+            GGKLogReceiver receiver = slot.receiver;
+
+            // Release the slot for the producer one lap ahead
+            slot.sequence.store(tail + kAsyncRingSlotCount, std::memory_order_release);
+            tail += 1;
+
+            if (nullptr != receiver) {
+                receiver(line);
+            }
+        } else if (!asyncDrainRunning.load(std::memory_order_relaxed)) {
+            // Stopped and fully drained
+            return;
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(kAsyncDrainIdleSleepMS));
+        }
+    }
+}
+
 //
 // Log receiver delegates
 //
@@ -132,15 +261,68 @@ void Logger::registerTraceReceiver(GGKLogReceiver receiver) {
     Logger::logReceiverTrace = receiver;
 }
 
+//
+// Asynchronous mode
+//
+
+// Enable asynchronous logging (see the header for details)
+void Logger::enableAsync() {
+    if (asyncEnabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    // Reset the ring to its initial state (slot `n` is free for producer `n` when its sequence equals `n`)
+    asyncHead.store(0, std::memory_order_relaxed);
+    for (size_t slotIndex = 0; slotIndex < kAsyncRingSlotCount; ++slotIndex) {
+        asyncRing[slotIndex].sequence.store(slotIndex, std::memory_order_relaxed);
+    }
+
+    asyncDrainRunning.store(true, std::memory_order_relaxed);
+    asyncDrainThread = std::thread(asyncDrainProc);
+    asyncEnabled.store(true, std::memory_order_release);
+}
+
+// Disable asynchronous logging, draining any queued messages before returning
+void Logger::disableAsync() {
+    if (!asyncEnabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    // Stop accepting new messages first so the drain thread can actually finish
+    asyncEnabled.store(false, std::memory_order_relaxed);
+    asyncDrainRunning.store(false, std::memory_order_relaxed);
+    if (asyncDrainThread.joinable()) {
+        asyncDrainThread.join();
+    }
+}
+
+// Returns the number of messages dropped due to ring overflow since asynchronous mode was first enabled
+uint32_t Logger::droppedMessageCount() {
+    return asyncDroppedMessages.load(std::memory_order_relaxed);
+}
+
+// Deliver `pText` to `receiver` - through the ring when asynchronous mode is enabled, synchronously otherwise
+void Logger::dispatch(GGKLogReceiver receiver, const char *pText, bool forceSync) {
+    if (nullptr == receiver) {
+        return;
+    }
+
+    if (!forceSync && asyncEnabled.load(std::memory_order_acquire)) {
+        // A full ring drops the message (counted in `asyncEnqueue`) - the hot path never waits
+        asyncEnqueue(receiver, pText);
+        return;
+    }
+
+    receiver(pText);
+}
+
 //
 // Logging actions
 //
 
 // Log a DEBUG entry with a C string
 void Logger::debug(const char *pText) {
-    if (nullptr != Logger::logReceiverDebug) {
-        Logger::logReceiverDebug(pText);
-    }
+    dispatch(Logger::logReceiverDebug, pText, false);
 }
 
 // Log a DEBUG entry with a string
@@ -159,9 +341,7 @@ void Logger::debug(const std::ostream &text) {
 
 // Log a INFO entry with a C string
 void Logger::info(const char *pText) {
-    if (nullptr != Logger::logReceiverInfo) {
-        Logger::logReceiverInfo(pText);
-    }
+    dispatch(Logger::logReceiverInfo, pText, false);
 }
 
 // Log a INFO entry with a string
@@ -180,9 +360,7 @@ void Logger::info(const std::ostream &text) {
 
 // Log a STATUS entry with a C string
 void Logger::status(const char *pText) {
-    if (nullptr != Logger::logReceiverStatus) {
-        Logger::logReceiverStatus(pText);
-    }
+    dispatch(Logger::logReceiverStatus, pText, false);
 }
 
 // Log a STATUS entry with a string
@@ -201,9 +379,7 @@ void Logger::status(const std::ostream &text) {
 
 // Log a WARN entry with a C string
 void Logger::warn(const char *pText) {
-    if (nullptr != Logger::logReceiverWarn) {
-        Logger::logReceiverWarn(pText);
-    }
+    dispatch(Logger::logReceiverWarn, pText, false);
 }
 
 // Log a WARN entry with a string
@@ -222,9 +398,7 @@ void Logger::warn(const std::ostream &text) {
 
 // Log a ERROR entry with a C string
 void Logger::error(const char *pText) {
-    if (nullptr != Logger::logReceiverError) {
-        Logger::logReceiverError(pText);
-    }
+    dispatch(Logger::logReceiverError, pText, false);
 }
 
 // Log a ERROR entry with a string
@@ -243,9 +417,8 @@ void Logger::error(const std::ostream &text) {
 
 // Log a FATAL entry with a C string
 void Logger::fatal(const char *pText) {
-    if (nullptr != Logger::logReceiverFatal) {
-        Logger::logReceiverFatal(pText);
-    }
+    // FATAL logs are always delivered synchronously - the process may be about to terminate
+    dispatch(Logger::logReceiverFatal, pText, true);
 }
 
 // Log a FATAL entry with a string
@@ -264,9 +437,7 @@ void Logger::fatal(const std::ostream &text) {
 
 // Log a ALWAYS entry with a C string
 void Logger::always(const char *pText) {
-    if (nullptr != Logger::logReceiverAlways) {
-        Logger::logReceiverAlways(pText);
-    }
+    dispatch(Logger::logReceiverAlways, pText, false);
 }
 
 // Log a ALWAYS entry with a string
@@ -285,9 +456,7 @@ void Logger::always(const std::ostream &text) {
 
 // Log a TRACE entry with a C string
 void Logger::trace(const char *pText) {
-    if (nullptr != Logger::logReceiverTrace) {
-        Logger::logReceiverTrace(pText);
-    }
+    dispatch(Logger::logReceiverTrace, pText, false);
 }
 
 // Log a TRACE entry with a string
@@ -34,6 +34,54 @@ namespace ggk {
 
 class Logger {
 public:
+    //
+    // Level gating
+    //
+    // Each predicate returns true only if a receiver is registered for that level. Call sites with expensive arguments
+    // (hex dumps, string building) should gate on these - or use the `LOG_*` macros below, which do it for them - so
+    // that nothing is formatted when the level is filtered out.
+    //
+
+    // Returns true if a receiver is registered for DEBUG logging
+    static bool debugEnabled() {
+        return nullptr != logReceiverDebug;
+    }
+
+    // Returns true if a receiver is registered for INFO logging
+    static bool infoEnabled() {
+        return nullptr != logReceiverInfo;
+    }
+
+    // Returns true if a receiver is registered for STATUS logging
+    static bool statusEnabled() {
+        return nullptr != logReceiverStatus;
+    }
+
+    // Returns true if a receiver is registered for WARN logging
+    static bool warnEnabled() {
+        return nullptr != logReceiverWarn;
+    }
+
+    // Returns true if a receiver is registered for ERROR logging
+    static bool errorEnabled() {
+        return nullptr != logReceiverError;
+    }
+
+    // Returns true if a receiver is registered for FATAL logging
+    static bool fatalEnabled() {
+        return nullptr != logReceiverFatal;
+    }
+
+    // Returns true if a receiver is registered for ALWAYS logging
+    static bool alwaysEnabled() {
+        return nullptr != logReceiverAlways;
+    }
+
+    // Returns true if a receiver is registered for TRACE logging
+    static bool traceEnabled() {
+        return nullptr != logReceiverTrace;
+    }
+
     //
     // Registration
     //
@@ -70,6 +118,29 @@ public:
     // performs the appropriate logging action. To unregister, call with `nullptr`
     static void registerTraceReceiver(GGKLogReceiver receiver);
 
+    //
+    // Asynchronous mode
+    //
+
+    // Enable asynchronous logging
+    //
+    // In asynchronous mode, callers deposit their formatted message into a preallocated lock-free ring and return
+    // immediately; a background drain thread invokes the registered receivers. Each drained message is prefixed with a
+    // monotonic `[seconds.microseconds]` timestamp captured at the moment it was logged. FATAL logs bypass the ring
+    // and remain synchronous (the process may be about to terminate.)
+    //
+    // If the ring overflows, the message is dropped and counted (see `droppedMessageCount`.)
+    static void enableAsync();
+
+    // Disable asynchronous logging, draining any queued messages before returning
+    //
+    // Logging reverts to synchronous delivery on the calling thread. Safe to call when asynchronous mode was never
+    // enabled.
+    static void disableAsync();
+
+    // Returns the number of messages dropped due to ring overflow since asynchronous mode was first enabled
+    static uint32_t droppedMessageCount();
+
     //
     // Logging actions
     //
@@ -147,6 +218,11 @@ public:
     static void trace(const std::ostream &text);
 
 private:
+    // Deliver `pText` to `receiver` - through the ring when asynchronous mode is enabled, synchronously otherwise
+    //
+    // `forceSync` bypasses the ring regardless of mode (used for FATAL logs)
+    static void dispatch(GGKLogReceiver receiver, const char *pText, bool forceSync);
+
     // The registered log receiver for DEBUG logs - a nullptr will cause the logging for that receiver to be ignored
     static GGKLogReceiver logReceiverDebug;
 
@@ -172,4 +248,70 @@ private:
     static GGKLogReceiver logReceiverTrace;
 };
 
+// Level-gated lazy logging macros
+//
+// Each macro checks whether a receiver is registered for its level BEFORE evaluating the stream expression, so
+// expensive arguments cost nothing when the level is filtered out:
+//
+//    LOG_DEBUG("+ Got chunk of size: " << bytesRead);
+//    LOG_DEBUG("  > Read " << response.size() << " bytes\n" << HexDump(response.data(), response.size()));
+//
+// Compare with `Logger::debug(SSTR << ...)`, which builds the full string (including any hex dumps) before the logger
+// looks at the receiver. With a level's receiver unregistered, a gated call site performs no allocation at all.
+#define LOG_DEBUG(expression)                           \
+    do {                                                \
+        if (ggk::Logger::debugEnabled()) {              \
+            ggk::Logger::debug(SSTR << expression);     \
+        }                                               \
+    } while (0)
+
+#define LOG_INFO(expression)                            \
+    do {                                                \
+        if (ggk::Logger::infoEnabled()) {               \
+            ggk::Logger::info(SSTR << expression);      \
+        }                                               \
+    } while (0)
+
+#define LOG_STATUS(expression)                          \
+    do {                                                \
+        if (ggk::Logger::statusEnabled()) {             \
+            ggk::Logger::status(SSTR << expression);    \
+        }                                               \
+    } while (0)
+
+#define LOG_WARN(expression)                            \
+    do {                                                \
+        if (ggk::Logger::warnEnabled()) {               \
+            ggk::Logger::warn(SSTR << expression);      \
+        }                                               \
+    } while (0)
+
+#define LOG_ERROR(expression)                           \
+    do {                                                \
+        if (ggk::Logger::errorEnabled()) {              \
+            ggk::Logger::error(SSTR << expression);     \
+        }                                               \
+    } while (0)
+
+#define LOG_FATAL(expression)                           \
+    do {                                                \
+        if (ggk::Logger::fatalEnabled()) {              \
+            ggk::Logger::fatal(SSTR << expression);     \
+        }                                               \
+    } while (0)
+
+#define LOG_ALWAYS(expression)                          \
+    do {                                                \
+        if (ggk::Logger::alwaysEnabled()) {             \
+            ggk::Logger::always(SSTR << expression);    \
+        }                                               \
+    } while (0)
+
+#define LOG_TRACE(expression)                           \
+    do {                                                \
+        if (ggk::Logger::traceEnabled()) {              \
+            ggk::Logger::trace(SSTR << expression);     \
+        }                                               \
+    } while (0)
+
 }; // namespace ggk
@@ -0,0 +1,129 @@
+// Copyright 2017-2019 Paul Nettle
+//
+// This file is part of Gobbledegook.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file in the root of the source tree.
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// >>
+// >>>  INSIDE THIS FILE
+// >>
+//
+// A read-only memory-mapped file, with generation checks so a replaced file is picked up on the next use
+//
+// >>
+// >>>  DISCUSSION
+// >>
+//
+// Serving a large payload (an 8MB firmware image, say) from a heap buffer costs its full size in resident memory on
+// top of the page cache's copy - painful on a small device. Mapping the file instead serves the same bytes straight
+// out of the page cache: nothing is resident beyond the pages actually touched, and the kernel reclaims them under
+// pressure.
+//
+// Mappings are handed out as shared_ptrs to immutable `FileMapping` objects, which is what makes file replacement
+// safe: each `acquire()` re-stats the bound path, and if the file was swapped out underneath us (a firmware update
+// dropping a new image in place - new inode, size or mtime), a fresh mapping is created for new consumers while
+// anyone still holding the old one (a reply being serialized, a streaming transfer in flight) keeps reading the old
+// contents to the end. The old pages unmap when the last holder lets go.
+//
+// Mappings are advised MADV_SEQUENTIAL - the consumers here (long reads, streaming-engine chunks) walk the file
+// front to back, so aggressive readahead is the right call.
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Logger.h"
+#include "MappedFile.h"
+
+namespace ggk {
+
+FileMapping::~FileMapping() {
+    if (nullptr != pData) {
+        munmap(const_cast<uint8_t *>(pData), count);
+    }
+}
+
+// Maps the file at `path` read-only, returning nullptr on any failure (`fileStat` returns the mapped file's identity)
+static std::shared_ptr<const FileMapping> mapFile(const std::string &path, struct stat &fileStat) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        Logger::warn(SSTR << "Unable to open value file '" << path << "'");
+        return nullptr;
+    }
+
+    if (0 != fstat(fd, &fileStat) || fileStat.st_size <= 0) {
+        Logger::warn(SSTR << "Unable to stat value file '" << path << "' (or it is empty)");
+        close(fd);
+        return nullptr;
+    }
+
+    void *pMapped = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // The mapping holds its own reference to the file - the descriptor's job is done either way
+    close(fd);
+
+    if (MAP_FAILED == pMapped) {
+        Logger::warn(SSTR << "Unable to map value file '" << path << "'");
+        return nullptr;
+    }
+
+    // Our consumers walk the file front to back - ask for aggressive readahead
+    madvise(pMapped, fileStat.st_size, MADV_SEQUENTIAL);
+
+    std::shared_ptr<FileMapping> pMapping = std::make_shared<FileMapping>();
+    pMapping->pData = static_cast<const uint8_t *>(pMapped);
+    pMapping->count = static_cast<size_t>(fileStat.st_size);
+    return pMapping;
+}
+
+// Binds to the file at `path` (an empty path unbinds)
+void MappedFile::bind(const std::string &path) {
+    std::lock_guard<std::mutex> lock(mapMutex);
+    boundPath = path;
+    mapping = nullptr;
+}
+
+// Returns the current mapping of the bound file (see MappedFile.h)
+std::shared_ptr<const FileMapping> MappedFile::acquire() const {
+    std::lock_guard<std::mutex> lock(mapMutex);
+    if (boundPath.empty()) {
+        return nullptr;
+    }
+
+    // Still serving the same file? A stat is cheap (no I/O for a cached inode) - this is the generation check that
+    // picks up an in-place file replacement on the next use
+    if (nullptr != mapping) {
+        struct stat pathStat;
+        if (0 == stat(boundPath.c_str(), &pathStat) && pathStat.st_dev == mappedDevice &&
+            pathStat.st_ino == mappedInode && pathStat.st_size == mappedSize && pathStat.st_mtime == mappedMTime) {
+            return mapping;
+        }
+
+        Logger::info(SSTR << "Value file '" << boundPath << "' was replaced - remapping");
+        mapping = nullptr;
+    }
+
+    struct stat fileStat;
+    mapping = mapFile(boundPath, fileStat);
+    if (nullptr != mapping) {
+        mappedDevice = fileStat.st_dev;
+        mappedInode = fileStat.st_ino;
+        mappedSize = fileStat.st_size;
+        mappedMTime = fileStat.st_mtime;
+    }
+
+    return mapping;
+}
+
+// Returns true if a path is bound (whether or not it currently maps)
+bool MappedFile::isBound() const {
+    std::lock_guard<std::mutex> lock(mapMutex);
+    return !boundPath.empty();
+}
+
+}; // namespace ggk
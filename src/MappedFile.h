@@ -0,0 +1,80 @@
+// Copyright 2017-2019 Paul Nettle
+//
+// This file is part of Gobbledegook.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file in the root of the source tree.
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// >>
+// >>>  INSIDE THIS FILE
+// >>
+//
+// A read-only memory-mapped file, with generation checks so a replaced file is picked up on the next use
+//
+// >>
+// >>>  DISCUSSION
+// >>
+//
+// See the discussion at the top of MappedFile.cpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <sys/types.h>
+
+namespace ggk {
+
+// One immutable read-only mapping of a file's contents
+//
+// Consumers hold these by shared_ptr: the pages stay mapped for as long as anyone (a reply in flight, a streaming
+// transfer) still references them, even after the source file is replaced and `MappedFile` has moved on to a fresh
+// mapping.
+struct FileMapping {
+    ~FileMapping();
+
+    const uint8_t *pData = nullptr;
+    size_t count = 0;
+};
+
+// A file-backed value source
+//
+// Bind it to a path, then `acquire()` the current mapping whenever the contents are needed. Each acquire re-stats
+// the path and remaps if the file was replaced (new inode, size or mtime), so an updated firmware image is served
+// on the very next read with no rebind - while consumers still holding the old mapping keep a consistent view of
+// the old contents.
+class MappedFile {
+public:
+    // Binds to the file at `path` (an empty path unbinds.) The mapping itself happens lazily, on first acquire.
+    void bind(const std::string &path);
+
+    // Returns the current mapping of the bound file, or nullptr if nothing is bound or the file cannot be mapped
+    //
+    // Safe to call from any thread; the returned mapping is immutable and remains valid for the shared_ptr's
+    // lifetime.
+    std::shared_ptr<const FileMapping> acquire() const;
+
+    // Returns true if a path is bound (whether or not it currently maps)
+    bool isBound() const;
+
+private:
+    // Guards everything below (binding happens on application threads; acquires happen on the main loop)
+    mutable std::mutex mapMutex;
+
+    std::string boundPath;
+    mutable std::shared_ptr<const FileMapping> mapping;
+
+    // The identity of the file behind `mapping` - when the path's identity no longer matches, the file was
+    // replaced and we remap
+    mutable dev_t mappedDevice = 0;
+    mutable ino_t mappedInode = 0;
+    mutable off_t mappedSize = 0;
+    mutable time_t mappedMTime = 0;
+};
+
+}; // namespace ggk
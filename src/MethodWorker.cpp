@@ -0,0 +1,162 @@
+// Copyright 2017-2019 Paul Nettle
+//
+// This file is part of Gobbledegook.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file in the root of the source tree.
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// >>
+// >>>  INSIDE THIS FILE
+// >>
+//
+// The worker pool behind deferred (asynchronous) method invocation
+//
+// >>
+// >>>  DISCUSSION
+// >>
+//
+// Every D-Bus method we serve runs its callback on the GLib main loop (see `DBusMethod::call`.) That's normally what
+// we want - the whole server is single-threaded by design - but it means a read callback that blocks in the
+// application's data getter stalls everything behind it: other characteristics' reads, pending notifications, the
+// lot. One slow read becomes a head-of-line latency spike for every connected client.
+//
+// The fix is deferred invocation: a method callback captures its `GDBusMethodInvocation` (GDBus is perfectly happy
+// for an invocation to be completed after the handler returns - the client just waits) and hands the slow part to
+// this pool. A worker thread runs the application delegate off-loop, then the completion - the `methodReturn*` call
+// that answers the invocation - is marshaled back to the main loop via `postToMainLoop`, so everything that touches
+// server state still runs single-threaded. The only code that runs off-loop is the application's own delegate,
+// which must therefore be safe to call from a worker thread (the built-in data store already is - see
+// `ggkDataStorePublish`.)
+//
+// The pool is deliberately small (see `kWorkerCount`): it exists to absorb occasional slow delegates, not to make
+// the server concurrent. It starts lazily on the first `post` and is joined at server teardown (see `uninit` in
+// Init.cpp.)
+//
+// See `GattCharacteristic::methodReturnReadAsync` for the ready-made read path built on top of this.
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include <condition_variable>
+#include <glib.h>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "Logger.h"
+#include "MethodWorker.h"
+
+namespace ggk {
+
+// The number of worker threads. Two is enough to keep one slow delegate from delaying the next without turning the
+// server into a threaded one.
+static const int kWorkerCount = 2;
+
+// One queued piece of work
+struct WorkItem {
+    MethodWorker::WorkCallback work;
+    void *pUserData;
+};
+
+// The queue and the lock/condition pair the workers sleep on
+static std::mutex workMutex;
+static std::condition_variable workCondition;
+static std::queue<WorkItem> workQueue;
+
+// The worker threads (empty until the first `post`)
+static std::vector<std::thread> workerThreads;
+
+// Pool state. While a `stop` is in progress, `bStopping` makes `post` refuse work (rather than spin up fresh
+// threads mid-teardown); once the stop completes the pool may start again (the server supports restart.)
+static bool bRunning = false;
+static bool bStopping = false;
+
+// The worker thread body - run queued work until told to stop
+static void workerLoop() {
+    while (true) {
+        WorkItem item;
+
+        {
+            std::unique_lock<std::mutex> lock(workMutex);
+            workCondition.wait(lock, [] { return !bRunning || !workQueue.empty(); });
+
+            if (!bRunning) {
+                return;
+            }
+
+            item = workQueue.front();
+            workQueue.pop();
+        }
+
+        item.work(item.pUserData);
+    }
+}
+
+// Posts work to the pool, starting the worker threads on first use
+bool MethodWorker::post(WorkCallback work, void *pUserData) {
+    std::lock_guard<std::mutex> lock(workMutex);
+
+    if (bStopping) {
+        return false;
+    }
+
+    if (!bRunning) {
+        bRunning = true;
+        for (int i = 0; i < kWorkerCount; ++i) {
+            workerThreads.push_back(std::thread(workerLoop));
+        }
+    }
+
+    workQueue.push({work, pUserData});
+    workCondition.notify_one();
+    return true;
+}
+
+// The main-loop trampoline for `postToMainLoop`
+static gboolean onMainLoopWork(gpointer pUserData) {
+    WorkItem *pItem = static_cast<WorkItem *>(pUserData);
+    pItem->work(pItem->pUserData);
+    delete pItem;
+    return FALSE;
+}
+
+// Marshals work back to the GLib main loop
+void MethodWorker::postToMainLoop(WorkCallback work, void *pUserData) {
+    g_idle_add(onMainLoopWork, new WorkItem{work, pUserData});
+}
+
+// Stops the pool, joining the worker threads
+void MethodWorker::stop() {
+    {
+        std::lock_guard<std::mutex> lock(workMutex);
+        bStopping = true;
+
+        if (!bRunning) {
+            bStopping = false;
+            return;
+        }
+
+        bRunning = false;
+
+        if (!workQueue.empty()) {
+            Logger::warn(SSTR << "Method worker pool stopping with " << workQueue.size() << " jobs still queued");
+            while (!workQueue.empty()) {
+                workQueue.pop();
+            }
+        }
+    }
+
+    workCondition.notify_all();
+
+    for (std::thread &worker : workerThreads) {
+        worker.join();
+    }
+
+    workerThreads.clear();
+
+    std::lock_guard<std::mutex> lock(workMutex);
+    bStopping = false;
+}
+
+}; // namespace ggk
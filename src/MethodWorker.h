@@ -0,0 +1,51 @@
+// Copyright 2017-2019 Paul Nettle
+//
+// This file is part of Gobbledegook.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file in the root of the source tree.
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// >>
+// >>>  INSIDE THIS FILE
+// >>
+//
+// A small worker pool for deferred method completion, so slow application delegates don't stall the GLib main loop
+//
+// >>
+// >>>  DISCUSSION
+// >>
+//
+// See the discussion at the top of MethodWorker.cpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+namespace ggk {
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// The worker pool (see the discussion in MethodWorker.cpp)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class MethodWorker {
+public:
+    // A work delegate. Work posted via `post` runs on a worker thread; work posted via `postToMainLoop` runs on the
+    // GLib main loop.
+    typedef void (*WorkCallback)(void *pUserData);
+
+    // Posts work to the pool, starting the worker threads on first use
+    //
+    // Returns true if the work was queued. Returns false after `stop` has been called (shutdown is in progress and
+    // the work would never run) - the caller should then do the work inline or fail its invocation.
+    static bool post(WorkCallback work, void *pUserData);
+
+    // Marshals work back to the GLib main loop (typically the completion half of a job begun with `post`)
+    static void postToMainLoop(WorkCallback work, void *pUserData);
+
+    // Stops the pool, joining the worker threads. Work still queued is abandoned (with a warning.) Safe to call when
+    // the pool was never started.
+    static void stop();
+};
+
+}; // namespace ggk
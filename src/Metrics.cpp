@@ -0,0 +1,171 @@
+// Copyright 2017-2019 Paul Nettle
+//
+// This file is part of Gobbledegook.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file in the root of the source tree.
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// >>
+// >>>  INSIDE THIS FILE
+// >>
+//
+// Hot-path metrics: counters and latency histograms for the paths where BLE latency actually goes
+//
+// >>
+// >>>  DISCUSSION
+// >>
+//
+// Until now the only visibility into a running server was the coarse `GGKServerHealth` enum - fine for "is it up",
+// useless for "where did that 40ms go". This module instruments the three paths that dominate BLE latency in
+// practice:
+//
+//     - Notification dispatch (application push -> PropertiesChanged signal or notification fd write)
+//     - D-Bus method service time (`Server::callMethod` - every ReadValue/WriteValue lands here)
+//     - HCI command round-trip (`HciAdapter::waitForCommandResponse`)
+//
+// plus the update queue's depth high-water mark, which tells you whether the main loop is keeping up with the
+// application's publish rate.
+//
+// Recording is wait-free (relaxed atomics only) so the instrumentation itself cannot become the bottleneck it is
+// trying to find. Applications read everything back with `ggkGetMetricsSnapshot()` - typically shipped home in the
+// fleet's telemetry - and the histograms answer order-of-magnitude questions (see `LatencyHistogram::snapshot`.)
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include <chrono>
+
+#include "Metrics.h"
+
+namespace ggk {
+
+//
+// LatencyHistogram
+//
+
+// Start out empty, with min primed so the first record always wins
+LatencyHistogram::LatencyHistogram() : totalCount(0), totalNS(0), minNS(UINT64_MAX), maxNS(0) {
+    for (int bucket = 0; bucket < kBucketCount; ++bucket) {
+        buckets[bucket].store(0, std::memory_order_relaxed);
+    }
+}
+
+// Returns the bucket index for a duration - the position of its highest set bit, clamped to the last bucket
+static int bucketForDuration(uint64_t durationNS) {
+    int bucket = 0;
+    while (durationNS > 1 && bucket < LatencyHistogram::kBucketCount - 1) {
+        durationNS >>= 1;
+        bucket += 1;
+    }
+    return bucket;
+}
+
+// Record a duration (any thread, wait-free)
+void LatencyHistogram::record(uint64_t durationNS) {
+    buckets[bucketForDuration(durationNS)].fetch_add(1, std::memory_order_relaxed);
+    totalCount.fetch_add(1, std::memory_order_relaxed);
+    totalNS.fetch_add(durationNS, std::memory_order_relaxed);
+
+    uint64_t seen = minNS.load(std::memory_order_relaxed);
+    while (durationNS < seen && !minNS.compare_exchange_weak(seen, durationNS, std::memory_order_relaxed)) {
+        // `seen` was refreshed by the failed exchange - try again
+    }
+
+    seen = maxNS.load(std::memory_order_relaxed);
+    while (durationNS > seen && !maxNS.compare_exchange_weak(seen, durationNS, std::memory_order_relaxed)) {
+        // `seen` was refreshed by the failed exchange - try again
+    }
+}
+
+// Fill `snapshot` with the current count, min/max/mean, and bucket-resolution percentiles
+void LatencyHistogram::snapshot(GGKLatencySnapshot &snapshot) const {
+    uint64_t count = totalCount.load(std::memory_order_relaxed);
+    snapshot.count = count;
+    snapshot.minNS = 0 == count ? 0 : minNS.load(std::memory_order_relaxed);
+    snapshot.maxNS = maxNS.load(std::memory_order_relaxed);
+    snapshot.meanNS = 0 == count ? 0 : totalNS.load(std::memory_order_relaxed) / count;
+    snapshot.p50NS = 0;
+    snapshot.p95NS = 0;
+    snapshot.p99NS = 0;
+
+    if (0 == count) {
+        return;
+    }
+
+    // Walk the buckets once, resolving each percentile as its threshold is crossed. A percentile is reported as the
+    // upper bound of its bucket (2^(bucket+1) ns.)
+    uint64_t cumulative = 0;
+    for (int bucket = 0; bucket < kBucketCount; ++bucket) {
+        cumulative += buckets[bucket].load(std::memory_order_relaxed);
+        uint64_t bound = 2ULL << bucket;
+
+        if (0 == snapshot.p50NS && cumulative * 100 >= count * 50) {
+            snapshot.p50NS = bound;
+        }
+        if (0 == snapshot.p95NS && cumulative * 100 >= count * 95) {
+            snapshot.p95NS = bound;
+        }
+        if (0 == snapshot.p99NS && cumulative * 100 >= count * 99) {
+            snapshot.p99NS = bound;
+            break;
+        }
+    }
+}
+
+//
+// Metrics registry
+//
+
+LatencyHistogram Metrics::notificationLatency;
+LatencyHistogram Metrics::methodServiceTime;
+LatencyHistogram Metrics::hciCommandRoundTrip;
+LatencyHistogram Metrics::reconnectTime;
+std::atomic<uint32_t> Metrics::updateQueueHighWater(0);
+
+// Returns the monotonic clock in nanoseconds (the timebase for every duration recorded here)
+uint64_t Metrics::timestampNS() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Record one notification dispatch latency - from the application's push to the signal/fd write completing
+void Metrics::recordNotificationLatency(uint64_t durationNS) {
+    notificationLatency.record(durationNS);
+}
+
+// Record one D-Bus method service time (see `Server::callMethod`)
+void Metrics::recordMethodServiceTime(uint64_t durationNS) {
+    methodServiceTime.record(durationNS);
+}
+
+// Record one HCI command round-trip time (see `HciAdapter::waitForCommandResponse`)
+void Metrics::recordHciCommandRoundTrip(uint64_t durationNS) {
+    hciCommandRoundTrip.record(durationNS);
+}
+
+// Record one reconnect gap - from a device's disconnect to the same device reconnecting
+void Metrics::recordReconnectTime(uint64_t durationNS) {
+    reconnectTime.record(durationNS);
+}
+
+// Record the update queue depth observed after a push (tracks the high-water mark)
+void Metrics::recordUpdateQueueDepth(uint32_t depth) {
+    uint32_t seen = updateQueueHighWater.load(std::memory_order_relaxed);
+    while (depth > seen && !updateQueueHighWater.compare_exchange_weak(seen, depth, std::memory_order_relaxed)) {
+        // `seen` was refreshed by the failed exchange - try again
+    }
+}
+
+// Fill `snapshot` with everything except the live queue depth (which the queue itself provides - see
+// `ggkGetMetricsSnapshot`)
+void Metrics::getSnapshot(GGKMetricsSnapshot &snapshot) {
+    snapshot.updateQueueDepth = 0;
+    snapshot.updateQueueHighWater = updateQueueHighWater.load(std::memory_order_relaxed);
+    notificationLatency.snapshot(snapshot.notificationLatency);
+    methodServiceTime.snapshot(snapshot.methodServiceTime);
+    hciCommandRoundTrip.snapshot(snapshot.hciCommandRoundTrip);
+    reconnectTime.snapshot(snapshot.reconnectTime);
+}
+
+}; // namespace ggk
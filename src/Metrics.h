@@ -0,0 +1,98 @@
+// Copyright 2017-2019 Paul Nettle
+//
+// This file is part of Gobbledegook.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file in the root of the source tree.
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// >>
+// >>>  INSIDE THIS FILE
+// >>
+//
+// Hot-path metrics: counters and latency histograms for the paths where BLE latency actually goes
+//
+// >>
+// >>>  DISCUSSION
+// >>
+//
+// See the discussion at the top of Metrics.cpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+#include "../include/Gobbledegook.h"
+
+namespace ggk {
+
+// A fixed-bucket latency histogram
+//
+// Durations land in power-of-two nanosecond buckets (bucket N holds durations in [2^N, 2^(N+1)) ns), in the spirit of
+// an HDR histogram but with a fixed footprint and a single atomic increment per record. Recording is wait-free and
+// safe from any thread; a snapshot reads the buckets without stopping recorders, so it is a consistent-enough view
+// for diagnostics rather than an exact one.
+struct LatencyHistogram {
+    // Power-of-two buckets from 1ns up to ~9 minutes; anything longer lands in the last bucket
+    static const int kBucketCount = 40;
+
+    LatencyHistogram();
+
+    // Record a duration (any thread, wait-free)
+    void record(uint64_t durationNS);
+
+    // Fill `snapshot` with the current count, min/max/mean, and bucket-resolution percentiles
+    //
+    // Percentiles are reported as the upper bound of the bucket containing that percentile, so they are accurate to
+    // within a factor of two - plenty to tell 100us from 10ms, which is the question these histograms answer.
+    void snapshot(GGKLatencySnapshot &snapshot) const;
+
+private:
+    std::atomic<uint64_t> buckets[kBucketCount];
+    std::atomic<uint64_t> totalCount;
+    std::atomic<uint64_t> totalNS;
+    std::atomic<uint64_t> minNS;
+    std::atomic<uint64_t> maxNS;
+};
+
+// Our metrics registry
+//
+// One histogram per instrumented hot path, plus gauges the instrumentation points feed. Everything here is atomic and
+// recording never takes a lock, so the instrumented paths pay a handful of relaxed atomic operations at most. Read it
+// all back with `ggkGetMetricsSnapshot()`.
+struct Metrics {
+    // Returns the monotonic clock in nanoseconds (the timebase for every duration recorded here)
+    static uint64_t timestampNS();
+
+    // Record one notification dispatch latency - from the application's push to the signal/fd write completing
+    static void recordNotificationLatency(uint64_t durationNS);
+
+    // Record one D-Bus method service time (see `Server::callMethod`)
+    static void recordMethodServiceTime(uint64_t durationNS);
+
+    // Record one HCI command round-trip time (see `HciAdapter::waitForCommandResponse`)
+    static void recordHciCommandRoundTrip(uint64_t durationNS);
+
+    // Record one reconnect gap - from a device's disconnect to the same device reconnecting (see the connection
+    // events in `HciAdapter::runEventThread`)
+    static void recordReconnectTime(uint64_t durationNS);
+
+    // Record the update queue depth observed after a push (tracks the high-water mark)
+    static void recordUpdateQueueDepth(uint32_t depth);
+
+    // Fill `snapshot` with everything except the live queue depth (which the queue itself provides - see
+    // `ggkGetMetricsSnapshot`)
+    static void getSnapshot(GGKMetricsSnapshot &snapshot);
+
+private:
+    static LatencyHistogram notificationLatency;
+    static LatencyHistogram methodServiceTime;
+    static LatencyHistogram hciCommandRoundTrip;
+    static LatencyHistogram reconnectTime;
+    static std::atomic<uint32_t> updateQueueHighWater;
+};
+
+}; // namespace ggk
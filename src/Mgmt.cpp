@@ -24,6 +24,7 @@
 // Note that this class relies on the `HciAdapter`, which is a very primitive implementation. Use with caution.
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
+#include <mutex>
 #include <string.h>
 
 #include "Logger.h"
@@ -131,6 +132,58 @@ bool Mgmt::setState(uint16_t commandCode, uint16_t controllerId, uint8_t newStat
     return true;
 }
 
+// Set a setting state to 'newState' on our bound controller, without waiting for the adapter's response
+//
+// This is the pipelined counterpart to `setState` (see `HciAdapter::sendCommandAsync`.) Fence a batch of these with
+// `HciAdapter::waitForPendingCommands`.
+//
+// Returns true if the command was sent, otherwise false
+bool Mgmt::setStateAsync(uint16_t commandCode, uint8_t newState) {
+    struct SRequest : HciAdapter::HciHeader {
+        uint8_t state;
+    } __attribute__((packed));
+
+    SRequest request;
+    request.code = commandCode;
+    request.controllerId = controllerIndex;
+    request.dataSize = sizeof(SRequest) - sizeof(HciAdapter::HciHeader);
+    request.state = newState;
+
+    if (!HciAdapter::getInstance().sendCommandAsync(request)) {
+        Logger::warn(
+            SSTR << "  + Failed to send " << HciAdapter::kCommandCodeNames[commandCode]
+                 << " state: " << static_cast<int>(newState)
+        );
+        return false;
+    }
+
+    return true;
+}
+
+// Sets discoverable mode without waiting for the adapter's response (see `setDiscoverable` and `setStateAsync`)
+//
+// Returns true if the command was sent, otherwise false
+bool Mgmt::setDiscoverableAsync(uint8_t disc, uint16_t timeout) {
+    struct SRequest : HciAdapter::HciHeader {
+        uint8_t disc;
+        uint16_t timeout;
+    } __attribute__((packed));
+
+    SRequest request;
+    request.code = Mgmt::ESetDiscoverableCommand;
+    request.controllerId = controllerIndex;
+    request.dataSize = sizeof(SRequest) - sizeof(HciAdapter::HciHeader);
+    request.disc = disc;
+    request.timeout = timeout;
+
+    if (!HciAdapter::getInstance().sendCommandAsync(request)) {
+        Logger::warn(SSTR << "  + Failed to send set discoverable");
+        return false;
+    }
+
+    return true;
+}
+
 // Set the powered state to `newState` (true = powered on, false = powered off)
 //
 // Returns true on success, otherwise false
@@ -254,6 +307,237 @@ bool Mgmt::addAdvertising(std::string shortName, const uint16_t *uuid) {
     return true;
 }
 
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Bonded devices
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// Sends the Load Long Term Keys command for `keys` (see Mgmt.h)
+//
+// The key list is variable length, so the request is staged in a byte buffer with the header at the front (the
+// adapter write takes its length from the header's `dataSize` - see `HciAdapter::sendCommand`.)
+bool Mgmt::loadLongTermKeys(const std::vector<BondLongTermKey> &keys) {
+    struct SRequest : HciAdapter::HciHeader {
+        uint16_t keyCount;
+    } __attribute__((packed));
+
+    std::vector<uint8_t> buffer(sizeof(SRequest) + keys.size() * sizeof(BondLongTermKey));
+    SRequest &request = *reinterpret_cast<SRequest *>(buffer.data());
+    request.code = Mgmt::ELoadLongTermKeysCommand;
+    request.controllerId = controllerIndex;
+    request.dataSize = static_cast<uint16_t>(buffer.size() - sizeof(HciAdapter::HciHeader));
+    request.keyCount = static_cast<uint16_t>(keys.size());
+    memcpy(buffer.data() + sizeof(SRequest), keys.data(), keys.size() * sizeof(BondLongTermKey));
+
+    if (!HciAdapter::getInstance().sendCommandAsync(request)) {
+        Logger::warn(SSTR << "  + Failed to send " << keys.size() << " long term key(s)");
+        return false;
+    }
+
+    return true;
+}
+
+// Sends the Load Identity Resolving Keys command for `keys` (see Mgmt.h)
+bool Mgmt::loadIdentityResolvingKeys(const std::vector<BondIdentityKey> &keys) {
+    struct SRequest : HciAdapter::HciHeader {
+        uint16_t keyCount;
+    } __attribute__((packed));
+
+    std::vector<uint8_t> buffer(sizeof(SRequest) + keys.size() * sizeof(BondIdentityKey));
+    SRequest &request = *reinterpret_cast<SRequest *>(buffer.data());
+    request.code = Mgmt::ELoadIdentityResolvingKeysCommand;
+    request.controllerId = controllerIndex;
+    request.dataSize = static_cast<uint16_t>(buffer.size() - sizeof(HciAdapter::HciHeader));
+    request.keyCount = static_cast<uint16_t>(keys.size());
+    memcpy(buffer.data() + sizeof(SRequest), keys.data(), keys.size() * sizeof(BondIdentityKey));
+
+    if (!HciAdapter::getInstance().sendCommandAsync(request)) {
+        Logger::warn(SSTR << "  + Failed to send " << keys.size() << " identity resolving key(s)");
+        return false;
+    }
+
+    return true;
+}
+
+// Sends the Add Device command for one bonded device, placing it on the controller's accept list (see Mgmt.h)
+bool Mgmt::addBondedDevice(const uint8_t address[6], uint8_t addressType) {
+    struct SRequest : HciAdapter::HciHeader {
+        uint8_t address[6];
+        uint8_t addressType;
+        uint8_t action;
+    } __attribute__((packed));
+
+    SRequest request;
+    request.code = Mgmt::EAddDeviceCommand;
+    request.controllerId = controllerIndex;
+    request.dataSize = sizeof(SRequest) - sizeof(HciAdapter::HciHeader);
+    memcpy(request.address, address, 6);
+    request.addressType = addressType;
+    request.action = 1; // Allow incoming connections from this device
+
+    if (!HciAdapter::getInstance().sendCommandAsync(request)) {
+        Logger::warn(SSTR << "  + Failed to add bonded device " << Utils::bluetoothAddressString(request.address));
+        return false;
+    }
+
+    return true;
+}
+
+// Load the bond cache into the controller's resolving and accept lists (see Mgmt.h)
+bool Mgmt::loadBondedDevices() {
+    std::vector<BondLongTermKey> longTermKeys;
+    std::vector<BondIdentityKey> identityKeys;
+    BondCache::getLongTermKeys(longTermKeys);
+    BondCache::getIdentityKeys(identityKeys);
+
+    if (longTermKeys.empty() && identityKeys.empty()) {
+        Logger::debug("  + Bond cache is empty - nothing to load");
+        return true;
+    }
+
+    Logger::info(
+        SSTR << "Loading " << BondCache::deviceCount() << " bonded device(s) into the controller ("
+             << longTermKeys.size() << " LTK(s), " << identityKeys.size() << " IRK(s))"
+    );
+
+    bool sent = loadLongTermKeys(longTermKeys) && loadIdentityResolvingKeys(identityKeys);
+
+    // The accept list takes identity addresses - every device with an identity key, plus any device whose long term
+    // key arrived without one (its address was already an identity address)
+    for (const BondIdentityKey &irk : identityKeys) {
+        sent = addBondedDevice(irk.address, irk.addressType) && sent;
+    }
+
+    for (const BondLongTermKey &ltk : longTermKeys) {
+        bool bHasIdentityKey = false;
+        for (const BondIdentityKey &irk : identityKeys) {
+            if (irk.addressType == ltk.addressType && 0 == memcmp(irk.address, ltk.address, 6)) {
+                bHasIdentityKey = true;
+                break;
+            }
+        }
+
+        if (!bHasIdentityKey) {
+            sent = addBondedDevice(ltk.address, ltk.addressType) && sent;
+        }
+    }
+
+    return sent && HciAdapter::getInstance().waitForPendingCommands(HciAdapter::kMaxEventWaitTimeMS);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Connection-parameter profiles
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// The interval/latency recipe behind each profile, indexed by `Mgmt::ConnectionProfile`
+//
+// Intervals are in 1.25ms units and supervision timeouts in 10ms units, per the management API.
+struct ConnectionProfileParams {
+    uint16_t minInterval;
+    uint16_t maxInterval;
+    uint16_t latency;
+    uint16_t supervisionTimeout;
+};
+
+static const ConnectionProfileParams kProfileParams[] = {
+    {24, 40, 0, 500},  // EProfileBalanced - 30-50ms interval, no slave latency
+    {12, 24, 0, 500},  // EProfileThroughput - 15-30ms interval, no slave latency
+    {160, 320, 4, 600} // EProfileLowPower - 200-400ms interval, 4 skippable connection events
+};
+
+// The profile the application asked for, whether it has ever asked for one, and whether the streaming engine is
+// currently forcing the throughput profile on top of it (guarded by `profileMutex`)
+//
+// `bProfileRequested` keeps `applyProfileOnConnect` from touching the connection parameters of applications that
+// never opted in - absent a request, the central's own parameters are left alone.
+static std::mutex profileMutex;
+static int requestedProfile = Mgmt::EProfileBalanced;
+static bool bProfileRequested = false;
+static bool bStreamForcingThroughput = false;
+
+// Sends the Load Connection Parameters command for `profile`, targeting the currently connected device (see Mgmt.h)
+int Mgmt::applyConnectionProfile(int profile) {
+    struct SRequest : HciAdapter::HciHeader {
+        uint16_t paramCount;
+        uint8_t address[6];
+        uint8_t addressType;
+        uint16_t minInterval;
+        uint16_t maxInterval;
+        uint16_t latency;
+        uint16_t supervisionTimeout;
+    } __attribute__((packed));
+
+    SRequest request;
+    request.code = Mgmt::ELoadConnectionParametersCommand;
+    request.controllerId = HciAdapter::getInstance().getBoundControllerIndex();
+    request.dataSize = sizeof(SRequest) - sizeof(HciAdapter::HciHeader);
+
+    if (!HciAdapter::getInstance().getConnectedDevice(request.address, request.addressType)) {
+        Logger::debug("  + No connected device - connection profile deferred until one connects");
+        return EProfileRequestDeferred;
+    }
+
+    const ConnectionProfileParams &params = kProfileParams[profile];
+    request.paramCount = 1;
+    request.minInterval = params.minInterval;
+    request.maxInterval = params.maxInterval;
+    request.latency = params.latency;
+    request.supervisionTimeout = params.supervisionTimeout;
+
+    if (!HciAdapter::getInstance().sendCommandAsync(request)) {
+        Logger::warn(SSTR << "  + Failed to send connection parameters for profile " << profile);
+        return EProfileRequestFailed;
+    }
+
+    Logger::info(
+        SSTR << "Requested connection profile " << profile << " (interval " << params.minInterval * 1.25 << "-"
+             << params.maxInterval * 1.25 << "ms, latency " << params.latency << ")"
+    );
+    return EProfileRequestApplied;
+}
+
+// Request a connection-parameter profile for the current connection (see Mgmt.h)
+int Mgmt::requestConnectionProfile(int profile) {
+    if (profile < EProfileBalanced || profile > EProfileLowPower) {
+        Logger::warn(SSTR << "Ignoring request for unknown connection profile " << profile);
+        return EProfileRequestFailed;
+    }
+
+    std::lock_guard<std::mutex> lock(profileMutex);
+    requestedProfile = profile;
+    bProfileRequested = true;
+
+    // While a stream transfer is forcing throughput, just remember the request - it is applied when the transfer
+    // ends
+    if (bStreamForcingThroughput) {
+        return EProfileRequestDeferred;
+    }
+
+    return applyConnectionProfile(profile);
+}
+
+// Applies the in-effect profile to a freshly connected device (see Mgmt.h)
+void Mgmt::applyProfileOnConnect() {
+    std::lock_guard<std::mutex> lock(profileMutex);
+
+    // Nothing was ever requested - leave the central's own parameters alone
+    if (!bProfileRequested && !bStreamForcingThroughput) {
+        return;
+    }
+
+    applyConnectionProfile(bStreamForcingThroughput ? EProfileThroughput : requestedProfile);
+}
+
+// Tells the profile machinery whether the streaming engine has a transfer in flight (see Mgmt.h)
+void Mgmt::setStreamActive(bool active) {
+    std::lock_guard<std::mutex> lock(profileMutex);
+    if (active == bStreamForcingThroughput) {
+        return;
+    }
+
+    bStreamForcingThroughput = active;
+    applyConnectionProfile(active ? EProfileThroughput : requestedProfile);
+}
+
 // ---------------------------------------------------------------------------------------------------------------------------------
 // Utilitarian
 // ---------------------------------------------------------------------------------------------------------------------------------
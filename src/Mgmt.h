@@ -28,7 +28,9 @@
 
 #include <stdint.h>
 #include <string>
+#include <vector>
 
+#include "BondCache.h"
 #include "HciAdapter.h"
 #include "Utils.h"
 
@@ -49,6 +51,24 @@ struct Mgmt {
     // Types
     //
 
+    // Connection-parameter profiles (see `requestConnectionProfile`)
+    //
+    // These values match `GGKConnectionProfile` in Gobbledegook.h.
+    enum ConnectionProfile {
+        EProfileBalanced = 0,   // Moderate interval - the default trade between latency and radio time
+        EProfileThroughput = 1, // Short interval, no slave latency - for bulk transfers
+        EProfileLowPower = 2    // Long interval with slave latency - for idle, battery-sensitive periods
+    };
+
+    // Results of a profile request (see `requestConnectionProfile`)
+    //
+    // These values match the `ggkRequestConnectionProfile` return contract in Gobbledegook.h.
+    enum ProfileRequestResult {
+        EProfileRequestFailed = 0,  // The profile is invalid or the command could not be sent
+        EProfileRequestApplied = 1, // The parameter update was sent for the current connection
+        EProfileRequestDeferred = 2 // Recorded - it is applied when a device connects (or the transfer ends)
+    };
+
     // These indices should match those in HciAdapter::kEventTypeNames
     enum EventTypes {
         EInvalidEvent = 0x0000,
@@ -193,6 +213,20 @@ struct Mgmt {
     // Returns true on success, otherwise false
     bool setState(uint16_t commandCode, uint16_t controllerId, uint8_t newState);
 
+    // Set a setting state to 'newState' on our bound controller, without waiting for the adapter's response
+    //
+    // This is the pipelined counterpart to `setState` (see `HciAdapter::sendCommandAsync`.) Settings that are
+    // independent of one another can be issued back-to-back this way and fenced once with
+    // `HciAdapter::waitForPendingCommands`, paying a single adapter round-trip for the whole batch.
+    //
+    // Returns true if the command was sent, otherwise false
+    bool setStateAsync(uint16_t commandCode, uint8_t newState);
+
+    // Sets discoverable mode without waiting for the adapter's response (see `setDiscoverable` and `setStateAsync`)
+    //
+    // Returns true if the command was sent, otherwise false
+    bool setDiscoverableAsync(uint8_t disc, uint16_t timeout);
+
     // Set the powered state to `newState` (true = powered on, false = powered off)
     //
     // Returns true on success, otherwise false
@@ -232,6 +266,40 @@ struct Mgmt {
     bool removeAdvertising();
     bool addAdvertising(std::string shortName, const uint16_t *uuid);
 
+    // Load the bond cache into the controller's resolving and accept lists (see BondCache.cpp)
+    //
+    // This is what lets a known device reconnect without rediscovery: its Long Term and Identity Resolving Keys go
+    // back into the kernel and its identity address onto the accept list. The commands are pipelined and fenced once
+    // for the whole cache, so a populated cache costs a single adapter round trip at startup.
+    //
+    // Returns true if everything the cache held was loaded (an empty cache counts), otherwise false
+    bool loadBondedDevices();
+
+    // Request a connection-parameter profile (one of `ConnectionProfile`) for the current connection
+    //
+    // The profile's interval/latency recipe is loaded into the kernel via the management API's Load Connection
+    //  Parameters command, targeting the currently connected device; as a peripheral, the kernel then negotiates the
+    // new interval with the central. The request is remembered, so it survives the streaming engine temporarily
+    // forcing the throughput profile (see `setStreamActive`) - and a request made while no device is connected is
+    // applied when one connects (see `applyProfileOnConnect`.)
+    //
+    // Returns one of `ProfileRequestResult`
+    static int requestConnectionProfile(int profile);
+
+    // Applies the in-effect profile to a freshly connected device
+    //
+    // Called by `HciAdapter`'s event thread when a central connects (after the peer address has been latched.) If a
+    // profile was requested while no device was connected - or the streaming engine is mid-transfer - this is where
+    // it takes effect. Does nothing if no profile was ever requested, leaving the central's own parameters alone.
+    static void applyProfileOnConnect();
+
+    // Tells the profile machinery whether the streaming engine has a transfer in flight
+    //
+    // While active, the throughput profile is forced (a 15ms interval is worth a ~3x wall-clock improvement on a
+    // firmware transfer); when the transfer ends, the application's requested profile is restored. Called by the
+    // `StreamEngine` - applications should use `requestConnectionProfile`.
+    static void setStreamActive(bool active);
+
     //
     // Utilitarian
     //
@@ -245,6 +313,24 @@ struct Mgmt {
     static std::string truncateShortName(const std::string &name);
 
 private:
+    // Sends the Load Long Term Keys command for `keys` (pipelined - see `loadBondedDevices`)
+    bool loadLongTermKeys(const std::vector<BondLongTermKey> &keys);
+
+    // Sends the Load Identity Resolving Keys command for `keys` (pipelined - see `loadBondedDevices`)
+    bool loadIdentityResolvingKeys(const std::vector<BondIdentityKey> &keys);
+
+    // Sends the Add Device command for one bonded device, placing it on the controller's accept list (pipelined)
+    bool addBondedDevice(const uint8_t address[6], uint8_t addressType);
+
+    // Sends the Load Connection Parameters command for `profile`, targeting the currently connected device
+    //
+    // The command is pipelined (see `HciAdapter::sendCommandAsync`) - profile switches come from application threads
+    // and from the streaming engine on the main loop, and neither should stall for the adapter round trip.
+    //
+    // Returns `EProfileRequestApplied` if the command was sent, `EProfileRequestDeferred` if no device is connected
+    // (the profile is applied when one connects), or `EProfileRequestFailed` if the send failed
+    static int applyConnectionProfile(int profile);
+
     //
     // Data members
     //
@@ -168,11 +168,15 @@
 #include "GattDescriptor.h"
 #include "GattProperty.h"
 #include "GattService.h"
+#include "GattTable.h"
 #include "GattUuid.h"
 #include "Globals.h"
 #include "Logger.h"
+#include "Metrics.h"
 #include "Server.h"
 #include "ServerUtils.h"
+#include "StreamEngine.h"
+#include "Trace.h"
 #include "Utils.h"
 
 namespace ggk {
@@ -194,6 +198,279 @@ namespace ggk {
 // Our one and only server. It's global.
 std::shared_ptr<Server> TheServer = nullptr;
 
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Huupe service description
+//
+// The service layout is declared as static tables (see GattTable.h): path elements, UUIDs and flag sets are resolved
+// and validated at compile time, and the runtime tree is constructed by a single pass over the tables in the Server
+// constructor (see `buildGattTree`.) The callbacks below are the same ones the old method-chaining description used,
+// just named rather than written as inline lambdas so that the tables are fully static.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// State
+static void onReadStateGet(
+    const GattCharacteristic &self,
+    GDBusConnection *pConnection,
+    const std::string &methodName,
+    GVariant *pParameters,
+    GDBusMethodInvocation *pInvocation,
+    void *pUserData
+) {
+    // The state blob is large and read often - serve it zero-copy from the span getter when the application provides
+    // one (the only copy is GVariant's own, into the reply.) Long-read segments slice the span directly rather than
+    // going through the snapshot cache, keeping every segment zero-copy.
+    const GGKDataSpan span = self.getDataSpan("Huupe/state/get");
+    if (nullptr != span.pData) {
+        guint16 offset = GattCharacteristic::readValueOffset(pParameters);
+        if (offset > span.count) {
+            offset = static_cast<guint16>(span.count);
+        }
+
+        self.methodReturnVariant(
+            pInvocation,
+            Utils::gvariantFromByteArray(span.pData + offset, static_cast<int>(span.count - offset)),
+            true
+        );
+        return;
+    }
+
+    if (self.methodReturnCachedReadSegment(pInvocation, pParameters)) {
+        return;
+    }
+
+    const std::vector<guint8> bytes = self.getDataValue("Huupe/state/get", std::vector<guint8>());
+    self.methodReturnReadSegment(pInvocation, pParameters, bytes.data(), bytes.size());
+}
+
+static bool onUpdatedStateGet(const GattCharacteristic &self, GDBusConnection *pConnection, void *pUserData) {
+    const GGKDataSpan span = self.getDataSpan("Huupe/state/get");
+    if (nullptr != span.pData) {
+        self.sendChangeNotificationValue(pConnection, span.pData, static_cast<size_t>(span.count));
+        return true;
+    }
+
+    const std::vector<guint8> bytes = self.getDataValue("Huupe/state/get", std::vector<guint8>());
+    self.sendChangeNotificationValue(pConnection, bytes);
+    return true;
+}
+
+// StateCmd
+static void onWriteStateSet(
+    const GattCharacteristic &self,
+    GDBusConnection *pConnection,
+    const std::string &methodName,
+    GVariant *pParameters,
+    GDBusMethodInvocation *pInvocation,
+    void *pUserData
+) {
+    // Segmented (long) writes are reassembled across calls; an ordinary write passes straight through. Completion
+    // routes write-without-response commands down the reply-free path (see `methodCompleteWrite`.)
+    const std::vector<guint8> &assembled = self.assembleWriteSegment(pParameters);
+    self.setDataPointer("Huupe/state/set", new std::vector<guint8>(assembled));
+    self.methodCompleteWrite(pConnection, pParameters, pInvocation, pUserData);
+}
+
+static bool onUpdatedStateSet(const GattCharacteristic &self, GDBusConnection *pConnection, void *pUserData) {
+    const std::vector<guint8> bytes = self.getDataValue("Huupe/state/set", std::vector<guint8>());
+    self.sendChangeNotificationValue(pConnection, bytes);
+    return true;
+}
+
+// StreamState
+static void onReadStreamGet(
+    const GattCharacteristic &self,
+    GDBusConnection *pConnection,
+    const std::string &methodName,
+    GVariant *pParameters,
+    GDBusMethodInvocation *pInvocation,
+    void *pUserData
+) {
+    // A file-bound value (a staged firmware image, say) is served zero-copy from the page cache
+    if (self.methodReturnMappedReadSegment(pInvocation, pParameters)) {
+        return;
+    }
+
+    if (self.methodReturnCachedReadSegment(pInvocation, pParameters)) {
+        return;
+    }
+
+    const std::vector<guint8> bytes = self.getDataValue("Huupe/stream/get", std::vector<guint8>());
+    self.methodReturnReadSegment(pInvocation, pParameters, bytes.data(), bytes.size());
+}
+
+static bool onUpdatedStreamGet(const GattCharacteristic &self, GDBusConnection *pConnection, void *pUserData) {
+    const std::vector<guint8> bytes = self.getDataValue("Huupe/stream/get", std::vector<guint8>());
+    self.sendChangeNotificationValue(pConnection, bytes);
+    return true;
+}
+
+// StreamCmd
+static void
+onAcquiredWriteStreamSet(const GattCharacteristic &self, GDBusConnection *pConnection, const guint8 *pData, size_t count) {
+    // Stream-engine control packets (acks and credit grants) ride this channel - give the engine first shot
+    if (StreamEngine::getInstance().handleControlPacket(pData, count)) {
+        return;
+    }
+
+    self.setDataPointer("Huupe/stream/set", new std::vector<guint8>(pData, pData + count));
+    self.callOnUpdatedValue(pConnection, nullptr);
+}
+
+static void onWriteStreamSet(
+    const GattCharacteristic &self,
+    GDBusConnection *pConnection,
+    const std::string &methodName,
+    GVariant *pParameters,
+    GDBusMethodInvocation *pInvocation,
+    void *pUserData
+) {
+    const std::vector<guint8> &assembled = self.assembleWriteSegment(pParameters);
+
+    // Stream-engine control packets may also arrive as plain writes (a client without an acquired write fd)
+    if (StreamEngine::getInstance().handleControlPacket(assembled.data(), assembled.size())) {
+        self.methodReturnVariant(pInvocation, NULL);
+        return;
+    }
+
+    self.setDataPointer("Huupe/stream/set", new std::vector<guint8>(assembled));
+    self.methodCompleteWrite(pConnection, pParameters, pInvocation, pUserData);
+}
+
+static bool onUpdatedStreamSet(const GattCharacteristic &self, GDBusConnection *pConnection, void *pUserData) {
+    const std::vector<guint8> bytes = self.getDataValue("Huupe/stream/set", std::vector<guint8>());
+    self.sendChangeNotificationValue(pConnection, bytes);
+    return true;
+}
+
+// settings: Settings
+static void onReadSettingsGet(
+    const GattCharacteristic &self,
+    GDBusConnection *pConnection,
+    const std::string &methodName,
+    GVariant *pParameters,
+    GDBusMethodInvocation *pInvocation,
+    void *pUserData
+) {
+    if (self.methodReturnCachedReadSegment(pInvocation, pParameters)) {
+        return;
+    }
+
+    // The settings blob can run to several KB - the snapshot cache means this getter runs once per logical read, no
+    // matter how many MTU-sized segments the read takes
+    const std::vector<guint8> bytes = self.getDataValue("Huupe/settings/get", std::vector<guint8>());
+    self.methodReturnReadSegment(pInvocation, pParameters, bytes.data(), bytes.size());
+}
+
+static bool onUpdatedSettingsGet(const GattCharacteristic &self, GDBusConnection *pConnection, void *pUserData) {
+    const std::vector<guint8> bytes = self.getDataValue("Huupe/settings/get", std::vector<guint8>());
+    self.sendChangeNotificationValue(pConnection, bytes);
+    return true;
+}
+
+// settings: SettingsCmd
+static void onWriteSettingsSet(
+    const GattCharacteristic &self,
+    GDBusConnection *pConnection,
+    const std::string &methodName,
+    GVariant *pParameters,
+    GDBusMethodInvocation *pInvocation,
+    void *pUserData
+) {
+    // A 4KB settings blob arrives as a series of offset-carrying segments; the setter sees the reassembled whole
+    const std::vector<guint8> &assembled = self.assembleWriteSegment(pParameters);
+    self.setDataPointer("Huupe/settings/set", new std::vector<guint8>(assembled));
+    self.methodCompleteWrite(pConnection, pParameters, pInvocation, pUserData);
+}
+
+static bool onUpdatedSettingsSet(const GattCharacteristic &self, GDBusConnection *pConnection, void *pUserData) {
+    const std::vector<guint8> bytes = self.getDataValue("Huupe/settings/set", std::vector<guint8>());
+    self.sendChangeNotificationValue(pConnection, bytes);
+    return true;
+}
+
+// settings: WiFiNetwork
+static void onReadWifiGet(
+    const GattCharacteristic &self,
+    GDBusConnection *pConnection,
+    const std::string &methodName,
+    GVariant *pParameters,
+    GDBusMethodInvocation *pInvocation,
+    void *pUserData
+) {
+    if (self.methodReturnCachedReadSegment(pInvocation, pParameters)) {
+        return;
+    }
+
+    // The wifi getter can block behind a scan - serve this read asynchronously so it can't stall every other
+    // characteristic's methods and notifications (see `methodReturnReadAsync`)
+    self.methodReturnReadAsync(
+        pInvocation,
+        pParameters,
+        [](const GattCharacteristic &self, void *pUserData) -> std::vector<guint8> {
+            return self.getDataValue("Huupe/settings/wifi/get", std::vector<guint8>());
+        },
+        pUserData
+    );
+}
+
+static bool onUpdatedWifiGet(const GattCharacteristic &self, GDBusConnection *pConnection, void *pUserData) {
+    const std::vector<guint8> bytes = self.getDataValue("Huupe/settings/wifi/get", std::vector<guint8>());
+    self.sendChangeNotificationValue(pConnection, bytes);
+    return true;
+}
+
+// settings: WiFiNetworkCmd
+static void onWriteWifiSet(
+    const GattCharacteristic &self,
+    GDBusConnection *pConnection,
+    const std::string &methodName,
+    GVariant *pParameters,
+    GDBusMethodInvocation *pInvocation,
+    void *pUserData
+) {
+    const std::vector<guint8> &assembled = self.assembleWriteSegment(pParameters);
+    self.setDataPointer("Huupe/settings/wifi/set", new std::vector<guint8>(assembled));
+    self.methodCompleteWrite(pConnection, pParameters, pInvocation, pUserData);
+}
+
+static bool onUpdatedWifiSet(const GattCharacteristic &self, GDBusConnection *pConnection, void *pUserData) {
+    const std::vector<guint8> bytes = self.getDataValue("Huupe/settings/wifi/set", std::vector<guint8>());
+    self.sendChangeNotificationValue(pConnection, bytes);
+    return true;
+}
+
+// The Huupe service characteristic set
+//
+// "stream/get" enables BlueZ's fd-based notification path (AcquireNotify) - it is our high-rate characteristic, so
+// updates are written straight to a socket instead of being marshaled through a D-Bus signal per update. "stream/set"
+// enables the fd-based write path (AcquireWrite, which requires "write-without-response") so streamed commands bypass
+// D-Bus entirely.
+static const GattCharacteristicTableEntry kHuupeCharacteristics[] = {
+    {"state/get", "b380"_uuid, EGattRead | EGattNotify, onReadStateGet, nullptr, onUpdatedStateGet, false, false, nullptr, nullptr, 0},
+    {"state/set", "b381"_uuid, EGattWrite | EGattNotify, nullptr, onWriteStateSet, onUpdatedStateSet, false, false, nullptr, nullptr, 0},
+    {"stream/get", "b382"_uuid, EGattRead | EGattNotify, onReadStreamGet, nullptr, onUpdatedStreamGet, true, true, nullptr, nullptr, 0},
+    {"stream/set", "b383"_uuid, EGattWrite | EGattWriteWithoutResponse | EGattNotify, nullptr, onWriteStreamSet, onUpdatedStreamSet, false, false, onAcquiredWriteStreamSet, nullptr, 0},
+    {"settings/get", "b390"_uuid, EGattRead | EGattNotify, onReadSettingsGet, nullptr, onUpdatedSettingsGet, false, false, nullptr, nullptr, 0},
+    {"settings/set", "b391"_uuid, EGattWrite | EGattNotify, nullptr, onWriteSettingsSet, onUpdatedSettingsSet, false, false, nullptr, nullptr, 0},
+    {"settings/wifi/get", "b392"_uuid, EGattRead | EGattNotify, onReadWifiGet, nullptr, onUpdatedWifiGet, false, false, nullptr, nullptr, 0},
+    {"settings/wifi/set", "b393"_uuid, EGattWrite | EGattNotify, nullptr, onWriteWifiSet, onUpdatedWifiSet, false, false, nullptr, nullptr, 0},
+};
+
+// The Huupe service set
+static const GattServiceTableEntry kHuupeServices[] = {
+    {"Huupe", "b370"_uuid, kHuupeCharacteristics, TABLE_ROWS(kHuupeCharacteristics)},
+};
+
+// Malformed path literals fail the build rather than producing a broken service at runtime (malformed UUIDs fail
+// the build at their `_uuid` literal - see GattUuid.h)
+static_assert(
+    isValidPathElement("Huupe") && isValidPathElement("state/get") && isValidPathElement("state/set") &&
+        isValidPathElement("stream/get") && isValidPathElement("stream/set") && isValidPathElement("settings/get") &&
+        isValidPathElement("settings/set") && isValidPathElement("settings/wifi/get") &&
+        isValidPathElement("settings/wifi/set"),
+    "Malformed path element in the Huupe service tables"
+);
+
 // ---------------------------------------------------------------------------------------------------------------------------------
 // Object implementation
 // ---------------------------------------------------------------------------------------------------------------------------------
@@ -262,128 +539,16 @@ Server::Server(
     //
 
     // Create the root D-Bus object and push it into the list
-    objects.push_back(DBusObject(DBusObjectPath() + "com" + getServiceName()));
-
-    // We're going to build off of this object, so we need to get a reference to the instance of the object as it
-    // resides in the list (and not the object that would be added to the list.)
-    objects
-        .back()
-
-        .gattServiceBegin("Huupe", "b370")
-
-        // State
-        .gattCharacteristicBegin("state/get", "b380", {"read", "notify"})
-        .onReadValue(CHARACTERISTIC_METHOD_CALLBACK_LAMBDA {
-            const std::vector<guint8> bytes = self.getDataValue("Huupe/state/get", std::vector<guint8>());
-            self.methodReturnValue(pInvocation, bytes, true);
-        })
-        .onUpdatedValue(CHARACTERISTIC_UPDATED_VALUE_CALLBACK_LAMBDA {
-            const std::vector<guint8> bytes = self.getDataValue("Huupe/state/get", std::vector<guint8>());
-            self.sendChangeNotificationValue(pConnection, bytes);
-            return true;
-        })
-        .gattCharacteristicEnd()
-
-        // StateCmd
-        .gattCharacteristicBegin("state/set", "b381", {"write", "notify"})
-        .onWriteValue(CHARACTERISTIC_METHOD_CALLBACK_LAMBDA {
-            GVariant *pAyBuffer = g_variant_get_child_value(pParameters, 0);
-            self.setDataPointer("Huupe/state/set", Utils::bytesVectorFromGVariantByteArray(pAyBuffer));
-            self.callOnUpdatedValue(pConnection, pUserData);
-            self.methodReturnVariant(pInvocation, NULL);
-        })
-        .onUpdatedValue(CHARACTERISTIC_UPDATED_VALUE_CALLBACK_LAMBDA {
-            const std::vector<guint8> bytes = self.getDataValue("Huupe/state/set", std::vector<guint8>());
-            self.sendChangeNotificationValue(pConnection, bytes);
-            return true;
-        })
-        .gattCharacteristicEnd()
-
-        // StreamState
-        .gattCharacteristicBegin("stream/get", "b382", {"read", "notify"})
-        .onReadValue(CHARACTERISTIC_METHOD_CALLBACK_LAMBDA {
-            const std::vector<guint8> bytes = self.getDataValue("Huupe/stream/get", std::vector<guint8>());
-            self.methodReturnValue(pInvocation, bytes, true);
-        })
-        .onUpdatedValue(CHARACTERISTIC_UPDATED_VALUE_CALLBACK_LAMBDA {
-            const std::vector<guint8> bytes = self.getDataValue("Huupe/stream/get", std::vector<guint8>());
-            self.sendChangeNotificationValue(pConnection, bytes);
-            return true;
-        })
-        .gattCharacteristicEnd()
-
-        // StreamCmd
-        .gattCharacteristicBegin("stream/set", "b383", {"write", "notify"})
-        .onWriteValue(CHARACTERISTIC_METHOD_CALLBACK_LAMBDA {
-            GVariant *pAyBuffer = g_variant_get_child_value(pParameters, 0);
-            self.setDataPointer("Huupe/stream/set", Utils::bytesVectorFromGVariantByteArray(pAyBuffer));
-            self.callOnUpdatedValue(pConnection, pUserData);
-            self.methodReturnVariant(pInvocation, NULL);
-        })
-        .onUpdatedValue(CHARACTERISTIC_UPDATED_VALUE_CALLBACK_LAMBDA {
-            const std::vector<guint8> bytes = self.getDataValue("Huupe/stream/set", std::vector<guint8>());
-            self.sendChangeNotificationValue(pConnection, bytes);
-            return true;
-        })
-        .gattCharacteristicEnd()
-
-        // settings: Settings
-        .gattCharacteristicBegin("settings/get", "b390", {"read", "notify"})
-        .onReadValue(CHARACTERISTIC_METHOD_CALLBACK_LAMBDA {
-            const std::vector<guint8> bytes = self.getDataValue("Huupe/settings/get", std::vector<guint8>());
-            self.methodReturnValue(pInvocation, bytes, true);
-        })
-        .onUpdatedValue(CHARACTERISTIC_UPDATED_VALUE_CALLBACK_LAMBDA {
-            const std::vector<guint8> bytes = self.getDataValue("Huupe/settings/get", std::vector<guint8>());
-            self.sendChangeNotificationValue(pConnection, bytes);
-            return true;
-        })
-        .gattCharacteristicEnd()
-
-        // settings: SettingsCmd
-        .gattCharacteristicBegin("settings/set", "b391", {"write", "notify"})
-        .onWriteValue(CHARACTERISTIC_METHOD_CALLBACK_LAMBDA {
-            GVariant *pAyBuffer = g_variant_get_child_value(pParameters, 0);
-            self.setDataPointer("Huupe/settings/set", Utils::bytesVectorFromGVariantByteArray(pAyBuffer));
-            self.callOnUpdatedValue(pConnection, pUserData);
-            self.methodReturnVariant(pInvocation, NULL);
-        })
-        .onUpdatedValue(CHARACTERISTIC_UPDATED_VALUE_CALLBACK_LAMBDA {
-            const std::vector<guint8> bytes = self.getDataValue("Huupe/settings/set", std::vector<guint8>());
-            self.sendChangeNotificationValue(pConnection, bytes);
-            return true;
-        })
-        .gattCharacteristicEnd()
-
-        // settings: WiFiNetwork
-        .gattCharacteristicBegin("settings/wifi/get", "b392", {"read", "notify"})
-        .onReadValue(CHARACTERISTIC_METHOD_CALLBACK_LAMBDA {
-            const std::vector<guint8> bytes = self.getDataValue("Huupe/settings/wifi/get", std::vector<guint8>());
-            self.methodReturnValue(pInvocation, bytes, true);
-        })
-        .onUpdatedValue(CHARACTERISTIC_UPDATED_VALUE_CALLBACK_LAMBDA {
-            const std::vector<guint8> bytes = self.getDataValue("Huupe/settings/wifi/get", std::vector<guint8>());
-            self.sendChangeNotificationValue(pConnection, bytes);
-            return true;
-        })
-        .gattCharacteristicEnd()
-
-        // settings: WiFiNetworkCmd
-        .gattCharacteristicBegin("settings/wifi/set", "b393", {"write", "notify"})
-        .onWriteValue(CHARACTERISTIC_METHOD_CALLBACK_LAMBDA {
-            GVariant *pAyBuffer = g_variant_get_child_value(pParameters, 0);
-            self.setDataPointer("Huupe/settings/wifi/set", Utils::bytesVectorFromGVariantByteArray(pAyBuffer));
-            self.callOnUpdatedValue(pConnection, pUserData);
-            self.methodReturnVariant(pInvocation, NULL);
-        })
-        .onUpdatedValue(CHARACTERISTIC_UPDATED_VALUE_CALLBACK_LAMBDA {
-            const std::vector<guint8> bytes = self.getDataValue("Huupe/settings/wifi/set", std::vector<guint8>());
-            self.sendChangeNotificationValue(pConnection, bytes);
-            return true;
-        })
-        .gattCharacteristicEnd()
-
-        .gattServiceEnd();
+    objects.emplace_back(DBusObjectPath() + "com" + getServiceName());
+
+    // Build the GATT tree in a single pass over the static service tables (see the Huupe service description above
+    // and the discussion in GattTable.h.) Note that we build off of the object as it resides in the list (and not an
+    // object that would be added to the list.)
+    buildGattTree(objects.back(), kHuupeServices, TABLE_ROWS(kHuupeServices));
+
+    // Bind the streaming transfer engine to the stream pair: chunks go out on stream/get, control packets come back
+    // on stream/set (see the handlers above and the discussion in StreamEngine.cpp)
+    StreamEngine::getInstance().bindDataChannel(objects.back().getPath() + "Huupe" + "stream/get");
 
     //  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
     //  -  -  -  -
@@ -424,7 +589,7 @@ Server::Server(
     // This is a non-published object (as specified by the 'false' parameter in the DBusObject constructor.) This way,
     // we can include this within our server hieararchy (i.e., within the `objects` list) but it won't be exposed by
     // BlueZ as a Bluetooth service to clietns.
-    objects.push_back(DBusObject(DBusObjectPath(), false));
+    objects.emplace_back(DBusObjectPath(), false);
 
     // Get a reference to the new object as it resides in the list
     DBusObject &objectManager = objects.back();
@@ -447,6 +612,27 @@ Server::Server(
         pOutArgs,
         INTERFACE_METHOD_CALLBACK_LAMBDA { ServerUtils::getManagedObjects(pInvocation); }
     );
+
+    // The object tree is now final, so build the flat dispatch index over it (see `InterfaceIndex` in Server.h)
+    for (const DBusObject &object : objects) {
+        indexInterfaces(object);
+    }
+}
+
+// Adds every interface in `object` (and, recursively, its children) to the interface index
+//
+// Called from the constructor once the object tree is complete. See `InterfaceIndex`. Since the method set of each
+// interface is also final at this point, this doubles as the place where each interface's flat method-dispatch table
+// is built (see `DBusInterface::finalizeMethodDispatch`.)
+void Server::indexInterfaces(const DBusObject &object) {
+    for (const std::shared_ptr<DBusInterface> &interface : object.getInterfaces()) {
+        interfaceIndex[object.getPath().toString() + "|" + interface->getName()] = interface;
+        interface->finalizeMethodDispatch();
+    }
+
+    for (const DBusObject &child : object.getChildren()) {
+        indexInterfaces(child);
+    }
 }
 
 // ---------------------------------------------------------------------------------------------------------------------------------
@@ -458,11 +644,10 @@ Server::Server(
 // If the interface was found, it is returned, otherwise nullptr is returned
 std::shared_ptr<const DBusInterface>
 Server::findInterface(const DBusObjectPath &objectPath, const std::string &interfaceName) const {
-    for (const DBusObject &object : objects) {
-        std::shared_ptr<const DBusInterface> pInterface = object.findInterface(objectPath, interfaceName);
-        if (pInterface != nullptr) {
-            return pInterface;
-        }
+    // One hash lookup - no tree walk (see `InterfaceIndex` in Server.h)
+    InterfaceIndex::const_iterator found = interfaceIndex.find(objectPath.toString() + "|" + interfaceName);
+    if (found != interfaceIndex.end()) {
+        return found->second;
     }
 
     return nullptr;
@@ -480,11 +665,18 @@ bool Server::callMethod(
     GDBusMethodInvocation *pInvocation,
     gpointer pUserData
 ) const {
-    for (const DBusObject &object : objects) {
-        if (object
-                .callMethod(objectPath, interfaceName, methodName, pConnection, pParameters, pInvocation, pUserData)) {
-            return true;
-        }
+    // Resolve the interface through the index, then hand the call straight to it
+    std::shared_ptr<const DBusInterface> pInterface = findInterface(objectPath, interfaceName);
+    if (pInterface != nullptr) {
+        Trace::record(Trace::EMethodEntry, Trace::packString(methodName.c_str()));
+
+        // Time the handler itself - lookup failures aren't service time
+        uint64_t startTimeNS = Metrics::timestampNS();
+        bool result = pInterface->callMethod(methodName, pConnection, pParameters, pInvocation, pUserData);
+        Metrics::recordMethodServiceTime(Metrics::timestampNS() - startTimeNS);
+
+        Trace::record(Trace::EMethodExit, Trace::packString(methodName.c_str()));
+        return result;
     }
 
     return false;
@@ -513,4 +705,34 @@ const GattProperty *Server::findProperty(
     return nullptr;
 }
 
+// Clear the notification-subscription state of every characteristic in the server
+//
+// Called when the last client disconnects (see the Device1 watch in Init.cpp) so subscriptions left behind by an
+// unclean teardown can't keep the notification path doing work for nobody.
+void Server::clearNotifySubscriptions() const {
+    for (const auto &entry : interfaceIndex) {
+        if (std::shared_ptr<const GattCharacteristic> pCharacteristic =
+                TRY_GET_CONST_INTERFACE_OF_TYPE(entry.second, GattCharacteristic)) {
+            pCharacteristic->clearNotifySubscriptions();
+        }
+    }
+}
+
+// Returns the MTU negotiated on the current connection, or 0 if no fd channel has been acquired
+//
+// BlueZ reports the negotiated MTU in its AcquireNotify/AcquireWrite replies, so this scans every characteristic
+// for an acquired channel and takes the largest value seen (all channels on one connection share the same MTU,
+// so "largest" just skips the zeroes of characteristics with no channel).
+uint16_t Server::getNegotiatedMTU() const {
+    uint16_t mtu = 0;
+    for (const auto &entry : interfaceIndex) {
+        if (std::shared_ptr<const GattCharacteristic> pCharacteristic =
+                TRY_GET_CONST_INTERFACE_OF_TYPE(entry.second, GattCharacteristic)) {
+            mtu = std::max(mtu, pCharacteristic->getNegotiatedMTU());
+        }
+    }
+
+    return mtu;
+}
+
 }; // namespace ggk
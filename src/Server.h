@@ -29,6 +29,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "../include/Gobbledegook.h"
@@ -57,6 +58,13 @@ struct Server {
     // Our server is a collection of D-Bus objects
     typedef std::list<DBusObject> Objects;
 
+    // A flat index from "objectPath|interfaceName" to the interface registered at that location
+    //
+    // Every incoming read/write/notify resolves an interface, and a recursive walk of the object tree (with a string
+    // compare at each node) is too expensive for that hot path. The index is built exactly once, at the end of the
+    // constructor when the object tree is final, and makes each resolution a single hash lookup.
+    typedef std::unordered_map<std::string, std::shared_ptr<const DBusInterface>> InterfaceIndex;
+
     //
     // Accessors
     //
@@ -107,6 +115,29 @@ struct Server {
         return dataSetter;
     }
 
+    // Returns our registered data span getter (may be nullptr - see `GGKServerDataSpanGetter` in Gobbledegook.h)
+    GGKServerDataSpanGetter getDataSpanGetter() const {
+        return dataSpanGetter;
+    }
+
+    // Sets our data span getter (see `ggkRegisterDataSpanGetter`)
+    void setDataSpanGetter(GGKServerDataSpanGetter getter) {
+        dataSpanGetter = getter;
+    }
+
+    // Returns the zero-based index of the HCI controller this server binds to (hci0, hci1, ...)
+    int getControllerIndex() const {
+        return controllerIndex;
+    }
+
+    // Sets the HCI controller this server binds to (see `ggkStartOnAdapter`)
+    //
+    // This must be set before initialization begins - the index is consumed when the adapter is located and
+    // configured, and changing it on a running server has no effect.
+    void setControllerIndex(int index) {
+        controllerIndex = index;
+    }
+
     // advertisingName: The name for this controller, as advertised over LE
     //
     // This is set from the constructor.
@@ -237,10 +268,30 @@ struct Server {
     findProperty(const DBusObjectPath &objectPath, const std::string &interfaceName, const std::string &propertyName)
         const;
 
+    // Clear the notification-subscription state of every characteristic in the server
+    //
+    // Called when the last client disconnects (see the Device1 watch in Init.cpp) so subscriptions left behind by an
+    // unclean teardown can't keep the notification path doing work for nobody.
+    void clearNotifySubscriptions() const;
+
+    // Returns the MTU negotiated on the current connection, or 0 if no fd channel has been acquired
+    //
+    // The value comes from BlueZ's AcquireNotify/AcquireWrite replies, so it is only known once a client has
+    // acquired at least one fd channel. See `ggkGetConnectionMTU` for the public wrapper.
+    uint16_t getNegotiatedMTU() const;
+
 private:
+    // Adds every interface in `object` (and, recursively, its children) to the interface index
+    //
+    // Called from the constructor once the object tree is complete. See `InterfaceIndex`.
+    void indexInterfaces(const DBusObject &object);
+
     // Our server's objects
     Objects objects;
 
+    // Our flat (path, interface) -> interface lookup index (see `InterfaceIndex`)
+    InterfaceIndex interfaceIndex;
+
     // BR/EDR requested state
     bool enableBREDR;
 
@@ -265,6 +316,9 @@ private:
     // The setter callback that is responsible for storing current server data that is shared over Bluetooth
     GGKServerDataSetter dataSetter;
 
+    // The optional zero-copy getter for large values (see `GGKServerDataSpanGetter` in Gobbledegook.h)
+    GGKServerDataSpanGetter dataSpanGetter = nullptr;
+
     // advertisingName: The name for this controller, as advertised over LE
     //
     // This is set from the constructor.
@@ -298,6 +352,9 @@ private:
 
     bool enableMultipleConnections = false;
     bool externalAdvertising = false;
+
+    // The zero-based HCI controller index this server binds to (see `ggkStartOnAdapter`)
+    int controllerIndex = 0;
 };
 
 // Our one and only server. It's a global.
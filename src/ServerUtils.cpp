@@ -126,18 +126,40 @@ addManagedObjectsNode(const DBusObject &object, const DBusObjectPath &basePath,
     }
 }
 
+// The cached `GetManagedObjects` response (nullptr = not built yet.) We hold a full (sunk) reference; responses hand
+// out additional references, so serving a cached response costs a refcount bump rather than a tree walk. Only ever
+// touched from the main loop thread, which serves the D-Bus requests.
+static GVariant *pCachedManagedObjects = nullptr;
+
 // Builds the response to the method call `GetManagedObjects` from the D-Bus interface
 // `org.freedesktop.DBus.ObjectManager`
+//
+// The serialized response is built on the first request and cached - the GATT tree is immutable once the server is
+// constructed, and BlueZ requests it on every registration
 void ServerUtils::getManagedObjects(GDBusMethodInvocation *pInvocation) {
-    Logger::debug(SSTR << "Reporting managed objects");
+    if (nullptr == pCachedManagedObjects) {
+        Logger::debug(SSTR << "Reporting managed objects");
+
+        GVariantBuilder *pObjectArray = g_variant_builder_new(G_VARIANT_TYPE_ARRAY);
+        for (const DBusObject &object : TheServer->getObjects()) {
+            addManagedObjectsNode(object, DBusObjectPath(""), pObjectArray);
+        }
 
-    GVariantBuilder *pObjectArray = g_variant_builder_new(G_VARIANT_TYPE_ARRAY);
-    for (const DBusObject &object : TheServer->getObjects()) {
-        addManagedObjectsNode(object, DBusObjectPath(""), pObjectArray);
+        GVariant *pParams = g_variant_new("(a{oa{sa{sv}}})", pObjectArray);
+        pCachedManagedObjects = g_variant_ref_sink(pParams);
     }
 
-    GVariant *pParams = g_variant_new("(a{oa{sa{sv}}})", pObjectArray);
-    g_dbus_method_invocation_return_value(pInvocation, pParams);
+    // `g_dbus_method_invocation_return_value` sinks the variant, which takes a new reference on our (already sunk)
+    // cached copy - the cache itself stays alive for the next request
+    g_dbus_method_invocation_return_value(pInvocation, pCachedManagedObjects);
+}
+
+// Discard the cached `GetManagedObjects` response so it is rebuilt on the next request
+void ServerUtils::invalidateManagedObjectsCache() {
+    if (nullptr != pCachedManagedObjects) {
+        g_variant_unref(pCachedManagedObjects);
+        pCachedManagedObjects = nullptr;
+    }
 }
 
 // WARNING: Hacky code - don't count on this working properly on all systems
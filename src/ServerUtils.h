@@ -32,8 +32,17 @@ namespace ggk {
 struct ServerUtils {
     // Builds the response to the method call `GetManagedObjects` from the D-Bus interface
     // `org.freedesktop.DBus.ObjectManager`
+    //
+    // The serialized response is built once and cached - the GATT tree is immutable once the server is constructed,
+    // and BlueZ requests it on every registration. See `invalidateManagedObjectsCache`.
     static void getManagedObjects(GDBusMethodInvocation *pInvocation);
 
+    // Discard the cached `GetManagedObjects` response so it is rebuilt on the next request
+    //
+    // Only needed if the object tree is ever changed after construction. This must be called from the main loop
+    // thread (the same thread that serves the D-Bus requests.)
+    static void invalidateManagedObjectsCache();
+
     // WARNING: Hacky code - don't count on this working properly on all systems
     //
     // This routine will attempt to parse /proc/cpuinfo to return the CPU count/model. Results are cached on the first
@@ -0,0 +1,475 @@
+// Copyright 2017-2019 Paul Nettle
+//
+// This file is part of Gobbledegook.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file in the root of the source tree.
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// >>
+// >>>  INSIDE THIS FILE
+// >>
+//
+// The streaming transfer engine - fragmentation, sequencing and credit-based flow control for large payloads
+//
+// >>
+// >>>  DISCUSSION
+// >>
+//
+// Shipping a large payload (a firmware image, say) over GATT with an application-level ack per chunk means every
+// chunk costs a full round trip, which halves throughput on high-latency links. This engine replaces that stop-and-
+// wait scheme with a pipelined one: the payload is fragmented to the negotiated MTU and multiple chunks are kept in
+// flight, bounded by a credit window the receiver controls.
+//
+// The engine rides on an ordinary characteristic pair (see the Huupe stream pair in Server.cpp):
+//
+//     * Data chunks go out as notifications on the acquired notification fd of the data channel (see
+//       `enableAcquireNotify`.) Each chunk is one packet:
+//
+//           [0x5A] [seq lo] [seq hi] [flags] [payload...]
+//
+//       Sequence numbers start at 0 and do not wrap (bounding a transfer at 65536 chunks - over 30MB at a 517-byte
+//       MTU.) The first chunk carries flag 0x01 and its payload is prefixed with the total transfer size (4 bytes,
+//       little endian) so the receiver can pre-allocate; the final chunk carries flag 0x02.
+//
+//     * Control packets come back as writes on the paired write characteristic, offered to the engine via
+//       `handleControlPacket`. Each is exactly 5 bytes:
+//
+//           [0xA5] [opcode] [count lo] [count hi] [credits]
+//
+//       Opcode 0x01 is the cumulative ack: `count` is the number of chunks received in order so far, and `credits`
+//       grants that many further chunks on top of the window. Opcode 0x02 aborts the transfer.
+//
+// Flow control is credit-based: the engine starts with a small initial window (see `kInitialCredits`) and transmits
+// one chunk per credit, so a receiver that is busy flashing a page simply withholds credits and the pipe drains to
+// a stop - no timers, no watermarks. Recovery is go-back-N: notifications ride a reliable, ordered transport, but
+// the engine intentionally drops chunks when the socket buffer fills (see `writeNotifyFd`) rather than blocking the
+// main loop, so a receiver that sees a sequence gap re-sends its last cumulative ack; the engine treats the
+// duplicate as a rewind request and retransmits from the first unacked chunk.
+//
+// Everything here runs on the GLib main loop (transfers started from application threads just schedule an idle
+// pump), so the engine never touches a characteristic from off-loop.
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include <algorithm>
+#include <string.h>
+
+#include "DBusInterface.h"
+#include "GattCharacteristic.h"
+#include "Logger.h"
+#include "Mgmt.h"
+#include "Server.h"
+#include "StreamEngine.h"
+
+namespace ggk {
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Wire protocol constants (see the discussion above)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// Packet magics - first byte of every data chunk and control packet
+static const guint8 kDataMagic = 0x5A;
+static const guint8 kControlMagic = 0xA5;
+
+// Data chunk header: [magic][seq lo][seq hi][flags]
+static const uint32_t kDataHeaderSize = 4;
+static const guint8 kFlagFirst = 0x01;
+static const guint8 kFlagLast = 0x02;
+
+// The first chunk's payload is prefixed with the total transfer size (4 bytes, little endian)
+static const uint32_t kSizePrefixSize = 4;
+
+// Control packet: [magic][opcode][count lo][count hi][credits]
+static const size_t kControlPacketSize = 5;
+static const guint8 kOpcodeAck = 0x01;
+static const guint8 kOpcodeAbort = 0x02;
+
+// The window the engine starts with, before the receiver has granted anything
+static const int kInitialCredits = 8;
+
+// The ATT MTU and notification header fallbacks (see the same constants in GattCharacteristic.cpp)
+static const uint16_t kFallbackMtu = 23;
+static const uint16_t kAttHeaderSize = 3;
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Transfer control
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// Binds the engine to the characteristic whose acquired notification fd carries the data chunks
+void StreamEngine::bindDataChannel(const DBusObjectPath &path) {
+    std::lock_guard<std::mutex> lock(engineMutex);
+    dataChannelPath = path;
+}
+
+// Begins a transfer of `count` bytes from `pData` (see StreamEngine.h)
+bool StreamEngine::sendBuffer(const void *pData, uint32_t count, ProgressCallback progress) {
+    if (nullptr == pData || 0 == count) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(engineMutex);
+    if (bActive) {
+        return false;
+    }
+
+    const guint8 *pBytes = static_cast<const guint8 *>(pData);
+    stagedPayload.assign(pBytes, pBytes + count);
+    mappedPayload = nullptr;
+    pPullFunc = nullptr;
+    pProgressFunc = progress;
+    totalBytes = count;
+    nextOffset = 0;
+    ackedBytes = 0;
+    nextSeq = 0;
+    lastAckCount = 0;
+    bHaveAck = false;
+    credits = kInitialCredits;
+    chunkPayloadSize = 0;
+    bActive = true;
+
+    // Bulk transfers want a short connection interval - force the throughput profile for the transfer's duration
+    Mgmt::setStreamActive(true);
+
+    schedulePump();
+    return true;
+}
+
+// As `sendBuffer`, but pulling the payload on demand (see StreamEngine.h)
+bool StreamEngine::sendPull(PullCallback pull, uint32_t totalBytes, ProgressCallback progress) {
+    if (nullptr == pull || 0 == totalBytes) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(engineMutex);
+    if (bActive) {
+        return false;
+    }
+
+    stagedPayload.clear();
+    mappedPayload = nullptr;
+    pPullFunc = pull;
+    pProgressFunc = progress;
+    this->totalBytes = totalBytes;
+    nextOffset = 0;
+    ackedBytes = 0;
+    nextSeq = 0;
+    lastAckCount = 0;
+    bHaveAck = false;
+    credits = kInitialCredits;
+    chunkPayloadSize = 0;
+    bActive = true;
+
+    // Bulk transfers want a short connection interval - force the throughput profile for the transfer's duration
+    Mgmt::setStreamActive(true);
+
+    schedulePump();
+    return true;
+}
+
+// As `sendBuffer`, but the payload is the file at `pPath`, memory-mapped rather than staged (see StreamEngine.h)
+bool StreamEngine::sendFile(const char *pPath, ProgressCallback progress) {
+    if (nullptr == pPath) {
+        return false;
+    }
+
+    // Map before taking the engine lock - mapping can touch the disk
+    MappedFile file;
+    file.bind(pPath);
+    std::shared_ptr<const FileMapping> pMapping = file.acquire();
+    if (nullptr == pMapping) {
+        return false;
+    }
+
+    if (pMapping->count > 0xffffffffu) {
+        Logger::error(SSTR << "Stream transfer rejected - '" << pPath << "' exceeds the 32-bit transfer limit");
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(engineMutex);
+    if (bActive) {
+        return false;
+    }
+
+    stagedPayload.clear();
+    mappedPayload = pMapping;
+    pPullFunc = nullptr;
+    pProgressFunc = progress;
+    totalBytes = static_cast<uint32_t>(pMapping->count);
+    nextOffset = 0;
+    ackedBytes = 0;
+    nextSeq = 0;
+    lastAckCount = 0;
+    bHaveAck = false;
+    credits = kInitialCredits;
+    chunkPayloadSize = 0;
+    bActive = true;
+
+    // Bulk transfers want a short connection interval - force the throughput profile for the transfer's duration
+    Mgmt::setStreamActive(true);
+
+    schedulePump();
+    return true;
+}
+
+// Aborts the in-flight transfer (if any)
+//
+// Note that a pump idle source may already be pending; it is left to fire and find the engine inactive rather than
+// removed here, so this stays safe to call from any thread.
+void StreamEngine::cancel() {
+    std::lock_guard<std::mutex> lock(engineMutex);
+    endTransfer();
+}
+
+// Returns true while a transfer is in flight
+bool StreamEngine::isActive() const {
+    std::lock_guard<std::mutex> lock(engineMutex);
+    return bActive;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Inbound control packets
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// Offers an inbound write packet to the engine (see StreamEngine.h)
+bool StreamEngine::handleControlPacket(const guint8 *pData, size_t count) {
+    if (nullptr == pData || kControlPacketSize != count || kControlMagic != pData[0]) {
+        return false;
+    }
+
+    ProgressCallback progressToFire = nullptr;
+    uint32_t progressAcked = 0;
+    uint32_t progressTotal = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(engineMutex);
+
+        // Control packets only mean something while a transfer is in flight - anything else is the application's
+        if (!bActive) {
+            return false;
+        }
+
+        if (kOpcodeAbort == pData[1]) {
+            Logger::info("Stream transfer aborted by the receiver");
+            endTransfer();
+            return true;
+        }
+
+        if (kOpcodeAck != pData[1]) {
+            Logger::warn(SSTR << "Stream control packet with unknown opcode " << static_cast<int>(pData[1]));
+            return true;
+        }
+
+        const uint16_t ackCount = static_cast<uint16_t>(pData[2] | (pData[3] << 8));
+        credits += pData[4];
+
+        // A duplicate cumulative ack is the receiver reporting a sequence gap - rewind to the first unacked chunk
+        // and retransmit from there (go-back-N)
+        if (bHaveAck && ackCount == lastAckCount) {
+            Logger::debug(SSTR << "Stream duplicate ack at chunk " << ackCount << " - rewinding for retransmit");
+            nextSeq = ackCount;
+            nextOffset = offsetForChunk(ackCount);
+        }
+
+        lastAckCount = ackCount;
+        bHaveAck = true;
+
+        const uint32_t newAckedBytes = std::min(totalBytes, offsetForChunk(ackCount));
+        if (newAckedBytes > ackedBytes) {
+            ackedBytes = newAckedBytes;
+            progressToFire = pProgressFunc;
+            progressAcked = ackedBytes;
+            progressTotal = totalBytes;
+        }
+
+        if (ackedBytes >= totalBytes) {
+            Logger::debug(SSTR << "Stream transfer complete (" << totalBytes << " bytes in " << nextSeq << " chunks)");
+            endTransfer();
+        } else {
+            schedulePump();
+        }
+    }
+
+    // The progress delegate is called outside the lock so it may call back into the engine (say, to cancel)
+    if (nullptr != progressToFire) {
+        progressToFire(progressAcked, progressTotal);
+    }
+
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Transmission
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the payload offset covered by chunks [0, chunkCount)
+//
+// The first chunk carries `kSizePrefixSize` fewer payload bytes than the rest (its size prefix eats into the MTU
+// budget), so the mapping is not a plain multiply.
+uint32_t StreamEngine::offsetForChunk(uint32_t chunkCount) const {
+    if (0 == chunkCount || 0 == chunkPayloadSize) {
+        return 0;
+    }
+
+    return (chunkPayloadSize - kSizePrefixSize) + (chunkCount - 1) * chunkPayloadSize;
+}
+
+// Fills `chunk` with the packet for sequence number `seq`
+bool StreamEngine::buildChunk(uint16_t seq, std::vector<guint8> &chunk) {
+    const uint32_t offset = offsetForChunk(seq);
+    uint32_t dataBytes = chunkPayloadSize - (0 == seq ? kSizePrefixSize : 0);
+    if (dataBytes > totalBytes - offset) {
+        dataBytes = totalBytes - offset;
+    }
+
+    guint8 flags = 0;
+    if (0 == seq) {
+        flags |= kFlagFirst;
+    }
+    if (offset + dataBytes >= totalBytes) {
+        flags |= kFlagLast;
+    }
+
+    chunk.clear();
+    chunk.reserve(kDataHeaderSize + kSizePrefixSize + dataBytes);
+    chunk.push_back(kDataMagic);
+    chunk.push_back(static_cast<guint8>(seq & 0xff));
+    chunk.push_back(static_cast<guint8>((seq >> 8) & 0xff));
+    chunk.push_back(flags);
+
+    if (0 == seq) {
+        chunk.push_back(static_cast<guint8>(totalBytes & 0xff));
+        chunk.push_back(static_cast<guint8>((totalBytes >> 8) & 0xff));
+        chunk.push_back(static_cast<guint8>((totalBytes >> 16) & 0xff));
+        chunk.push_back(static_cast<guint8>((totalBytes >> 24) & 0xff));
+    }
+
+    const size_t headerSize = chunk.size();
+    chunk.resize(headerSize + dataBytes);
+
+    if (nullptr != pPullFunc) {
+        // Note: the pull delegate is called with the engine lock held; it must not call back into the engine
+        if (pPullFunc(offset, chunk.data() + headerSize, dataBytes) != dataBytes) {
+            return false;
+        }
+    } else if (nullptr != mappedPayload) {
+        // Straight from the page cache - the mapping held since transfer start keeps the payload consistent even if
+        // the file is replaced mid-transfer
+        memcpy(chunk.data() + headerSize, mappedPayload->pData + offset, dataBytes);
+    } else {
+        memcpy(chunk.data() + headerSize, stagedPayload.data() + offset, dataBytes);
+    }
+
+    return true;
+}
+
+// Transmits chunks while credits remain
+//
+// This runs on the main loop (see `schedulePump`.) A transfer aborts here if the data channel has no acquired
+// notification fd, the client hangs up mid-transfer, or the pull delegate comes up short.
+void StreamEngine::pump() {
+    std::lock_guard<std::mutex> lock(engineMutex);
+    pumpIdleId = 0;
+
+    if (!bActive) {
+        return;
+    }
+
+    // Resolve the data channel (the characteristic lives for the life of the server, but binding happens before the
+    // server finishes construction, so we look it up here rather than at bind time)
+    std::shared_ptr<const GattCharacteristic> pCharacteristic;
+    if (nullptr != TheServer) {
+        std::shared_ptr<const DBusInterface> pInterface =
+            TheServer->findInterface(dataChannelPath, "org.bluez.GattCharacteristic1");
+        if (nullptr != pInterface) {
+            pCharacteristic = TRY_GET_CONST_INTERFACE_OF_TYPE(pInterface, GattCharacteristic);
+        }
+    }
+
+    if (nullptr == pCharacteristic) {
+        Logger::warn(SSTR << "Stream transfer aborted - no data channel at path '" << dataChannelPath << "'");
+        endTransfer();
+        return;
+    }
+
+    if (!pCharacteristic->isNotifyAcquired()) {
+        Logger::warn("Stream transfer aborted - no acquired notification fd on the data channel");
+        endTransfer();
+        return;
+    }
+
+    // Fix the chunk size from the negotiated MTU on the transfer's first pump, and flush anything the notification
+    // batcher may have staged so chunks don't interleave with stale value bytes
+    if (0 == chunkPayloadSize) {
+        uint16_t mtu = pCharacteristic->getNegotiatedMTU();
+        if (0 == mtu) {
+            mtu = kFallbackMtu;
+        }
+
+        chunkPayloadSize = static_cast<uint32_t>(mtu - kAttHeaderSize) - kDataHeaderSize;
+
+        // Sequence numbers don't wrap (see the discussion above) - make sure this payload fits in 65536 chunks
+        if (totalBytes > offsetForChunk(0x10000)) {
+            Logger::error(SSTR << "Stream transfer aborted - " << totalBytes << " bytes exceeds 65536 chunks at MTU " << mtu);
+            endTransfer();
+            chunkPayloadSize = 0;
+            return;
+        }
+
+        pCharacteristic->flushNotifyBatch();
+
+        LOG_DEBUG(
+            "Stream transfer starting: " << totalBytes << " bytes in chunks of " << chunkPayloadSize << " (MTU " << mtu
+                                         << ")"
+        );
+    }
+
+    std::vector<guint8> chunk;
+    while (bActive && credits > 0 && nextOffset < totalBytes) {
+        if (!buildChunk(nextSeq, chunk)) {
+            Logger::warn(SSTR << "Stream transfer aborted - pull delegate came up short at chunk " << nextSeq);
+            endTransfer();
+            return;
+        }
+
+        if (!pCharacteristic->writeNotifyFd(chunk.data(), chunk.size())) {
+            Logger::warn("Stream transfer aborted - client hung up the data channel");
+            endTransfer();
+            return;
+        }
+
+        credits -= 1;
+        nextSeq += 1;
+        nextOffset = offsetForChunk(nextSeq);
+    }
+}
+
+// Ends the in-flight transfer, releasing its resources (callers hold `engineMutex`)
+//
+// This is also where the connection-parameter machinery learns the transfer is over, so the application's requested
+// profile replaces the forced throughput profile (see `Mgmt::setStreamActive`.)
+void StreamEngine::endTransfer() {
+    bActive = false;
+    stagedPayload.clear();
+    mappedPayload = nullptr;
+    pPullFunc = nullptr;
+    pProgressFunc = nullptr;
+    Mgmt::setStreamActive(false);
+}
+
+// Schedules `pump` on the main loop (collapsing repeated calls into one idle source)
+//
+// Callers hold `engineMutex`.
+void StreamEngine::schedulePump() {
+    if (0 == pumpIdleId) {
+        pumpIdleId = g_idle_add(onPumpIdle, this);
+    }
+}
+
+// The main-loop trampoline for `schedulePump`
+gboolean StreamEngine::onPumpIdle(gpointer pUserData) {
+    static_cast<StreamEngine *>(pUserData)->pump();
+    return FALSE;
+}
+
+}; // namespace ggk
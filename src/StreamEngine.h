@@ -0,0 +1,142 @@
+// Copyright 2017-2019 Paul Nettle
+//
+// This file is part of Gobbledegook.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file in the root of the source tree.
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// >>
+// >>>  INSIDE THIS FILE
+// >>
+//
+// A streaming transfer engine with credit-based flow control, for pushing large payloads (firmware images, config
+// blobs) over a notifying characteristic without an application-level ack per chunk
+//
+// >>
+// >>>  DISCUSSION
+// >>
+//
+// See the discussion at the top of StreamEngine.cpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+#include <glib.h>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+#include "DBusObjectPath.h"
+#include "MappedFile.h"
+
+namespace ggk {
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Streaming transfer engine (see the discussion in StreamEngine.cpp)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class StreamEngine {
+public:
+    // Progress delegate - called (on the main loop) each time the cumulative ack advances, and a final time when the
+    // transfer completes (at which point `bytesAcked` equals `totalBytes`)
+    typedef void (*ProgressCallback)(uint32_t bytesAcked, uint32_t totalBytes);
+
+    // Pull delegate for transfers too large (or too dynamic) to stage in memory - called (on the main loop) to fill
+    // `pBuffer` with up to `count` bytes of the payload starting at `offset`. Returns the number of bytes provided;
+    // returning less than `count` before the end of the payload aborts the transfer.
+    typedef uint32_t (*PullCallback)(uint32_t offset, void *pBuffer, uint32_t count);
+
+    // Returns the instance to this singleton class
+    static StreamEngine &getInstance() {
+        static StreamEngine instance;
+        return instance;
+    }
+
+    // Binds the engine to the characteristic whose acquired notification fd carries the data chunks
+    //
+    // Called once from the server description (see Server.cpp.) Control packets are fed in from the paired write
+    // characteristic via `handleControlPacket`.
+    void bindDataChannel(const DBusObjectPath &path);
+
+    // Begins a transfer of `count` bytes from `pData` (which is copied - the caller's buffer may be released as soon
+    // as this returns)
+    //
+    // Returns true if the transfer was started, or false if one is already in flight. The transfer itself requires
+    // the client to hold an acquired notification fd on the data channel (see `enableAcquireNotify`) - without one
+    // the transfer aborts on its first pump.
+    bool sendBuffer(const void *pData, uint32_t count, ProgressCallback progress);
+
+    // As `sendBuffer`, but the payload is pulled on demand via `pull` instead of being staged in memory
+    bool sendPull(PullCallback pull, uint32_t totalBytes, ProgressCallback progress);
+
+    // As `sendBuffer`, but the payload is the file at `pPath`, memory-mapped rather than staged
+    //
+    // Chunks are built straight from the page cache - the file's size never lands on the heap. The mapping taken at
+    // transfer start is held to the end, so an in-place file replacement mid-transfer cannot tear the payload.
+    bool sendFile(const char *pPath, ProgressCallback progress);
+
+    // Aborts the in-flight transfer (if any.) Safe to call from any thread, including from a progress callback.
+    void cancel();
+
+    // Returns true while a transfer is in flight
+    bool isActive() const;
+
+    // Offers an inbound write packet to the engine
+    //
+    // Returns true if the packet was a stream control packet (an ack/credit grant or an abort) and was consumed; the
+    // caller should then skip its normal write handling. Returns false for anything else - including all control
+    // packets while no transfer is in flight - leaving the packet to the caller.
+    bool handleControlPacket(const guint8 *pData, size_t count);
+
+private:
+    StreamEngine() = default;
+
+    // Transmits chunks while credits remain (called on the main loop - see `schedulePump`)
+    void pump();
+
+    // Ends the in-flight transfer, releasing its resources and dropping the forced throughput connection profile
+    // (callers hold `engineMutex`)
+    void endTransfer();
+
+    // Schedules `pump` on the main loop (safe to call from any thread; collapses repeated calls)
+    void schedulePump();
+
+    // Fills `chunk` with the packet for sequence number `seq`. Returns false if the pull callback came up short.
+    bool buildChunk(uint16_t seq, std::vector<guint8> &chunk);
+
+    // Returns the payload offset covered by chunks [0, chunkCount)
+    uint32_t offsetForChunk(uint32_t chunkCount) const;
+
+    // The main-loop trampoline for `schedulePump`
+    static gboolean onPumpIdle(gpointer pUserData);
+
+    // Guards everything below (transfers start on application threads; pumping and acks happen on the main loop)
+    mutable std::mutex engineMutex;
+
+    // The object path of the data-channel characteristic (resolved lazily - see `pump`)
+    DBusObjectPath dataChannelPath;
+
+    // Transfer state
+    bool bActive = false;
+    std::vector<guint8> stagedPayload;
+    std::shared_ptr<const FileMapping> mappedPayload;
+    PullCallback pPullFunc = nullptr;
+    ProgressCallback pProgressFunc = nullptr;
+    uint32_t totalBytes = 0;
+    uint32_t nextOffset = 0;
+    uint32_t ackedBytes = 0;
+    uint16_t nextSeq = 0;
+    uint16_t lastAckCount = 0;
+    bool bHaveAck = false;
+    int credits = 0;
+
+    // The data bytes carried per chunk, fixed from the negotiated MTU when the transfer first pumps
+    uint32_t chunkPayloadSize = 0;
+
+    // The pending pump idle source (0 when none)
+    guint pumpIdleId = 0;
+};
+
+}; // namespace ggk
@@ -21,15 +21,10 @@
 // data on a regular basis or performing other periodic tasks. One example usage might be checking the battery level
 // every 60 seconds and if it has changed since the last update, send out a notification to subscribers.
 //
-// The frequency at which events fire is dependent upon two values: the driving timer's tick frequency multiplied by the
-// tick freuency of the TickEvent itself.
-//
-// The tick event's frequency is set when a tick event is added via the `onEvent()` method to the server description.
-//
-// The driving timer's frequency is a one-second-resolution low-frequency timer with a default of one second. To modify
-// this, see `kPeriodicTimerFrequencySeconds` at the top of Init.cpp. Note that the periodic timer (which drives tick
-// events) is intentionally a low-frequency timer. Higher frequency timers would lend themselves to using more battery
-// on both, the server and client.
+// Each event carries its own period in milliseconds. Events are collected from the server description into a central
+// min-heap schedule (see the tick scheduler in Init.cpp) which arms a one-shot timeout for whichever event is due
+// next - the event simply holds its period and fires when the scheduler says so. Periods registered via `onEvent()`
+// are in seconds (matching the original one-second driving timer); `onEventMS()` registers sub-second periods.
 //
 // When using a TickEvent, be careful not to demand too much of your client. Notifiations that are too frequent may
 // place undue stress on their battery to receive and process the updates.
@@ -68,14 +63,13 @@ struct TickEvent {
         void *pUserData
     );
 
-    // Construct a TickEvent that will fire after a specified 'tickFrequency' number of ticks of the periodic timer.
+    // Construct a TickEvent that will fire every 'tickFrequency' seconds
     //
-    // Note that the actual time between a callback's execution is the event's 'tickFrequency' multiplied by the time
-    // between each periodic timer tick.
+    // For sub-second periods, construct with any frequency and then call `setPeriodMS()` (see `onEventMS()` in
+    // DBusInterface.)
     TickEvent(const DBusInterface *pOwner, int tickFrequency, Callback callback, void *pUserData) :
         pOwner(pOwner),
-        elapsedTicks(0),
-        tickFrequency(tickFrequency),
+        periodMS(tickFrequency * 1000),
         callback(callback),
         pUserData(pUserData) {}
 
@@ -83,24 +77,14 @@ struct TickEvent {
     // Accessors
     //
 
-    // Returns the elapsed ticks since the last event firing
-    int getElapsedTicks() const {
-        return elapsedTicks;
-    }
-
-    // Sets the elapsed ticks since the last event firing
-    void setElapsedTicks(int elapsed) {
-        elapsedTicks = elapsed;
+    // Returns the period (in milliseconds) between firings of this event
+    int getPeriodMS() const {
+        return periodMS;
     }
 
-    // Returns the tick frequency between schedule tick events
-    int getTickFrequency() const {
-        return tickFrequency;
-    }
-
-    // Sets the tick frequency between schedule tick events
-    void setTickFrequency(int frequency) {
-        tickFrequency = frequency;
+    // Sets the period (in milliseconds) between firings of this event
+    void setPeriodMS(int periodMS) {
+        this->periodMS = periodMS;
     }
 
     // Returns the user data pointer associated to this TickEvent
@@ -124,25 +108,17 @@ struct TickEvent {
     }
 
     //
-    // Tick management
+    // Firing
     //
 
-    // Perform a single tick of a TickEvent
-    //
-    // A TickEvent is ticked each time the periodic timer fires. The TickEvent only fires after `tickFrequency` ticks.
-    // As a result, the `callback` is only called after a period of time equal to the time between firings of the
-    // periodic timer, multiplied by `tickFrequency`.
+    // Fire this TickEvent, calling its callback
     //
-    // Returns true if event fires, false otherwise
-    template <typename T> void tick(const DBusObjectPath &path, GDBusConnection *pConnection, void *pUserData) const {
-        elapsedTicks += 1;
-        if (elapsedTicks >= tickFrequency) {
-            if (nullptr != callback) {
-                Logger::debug(SSTR << "Ticking at path '" << path << "'");
-                callback(*static_cast<const T *>(pOwner), *this, pConnection, pUserData);
-            }
-
-            elapsedTicks = 0;
+    // The decision of *when* to fire belongs to the tick scheduler in Init.cpp, which tracks each event's next due
+    // time and calls this method (via `DBusInterface::fireTickEvent`) when that time arrives.
+    template <typename T> void fire(const DBusObjectPath &path, GDBusConnection *pConnection, void *pUserData) const {
+        if (nullptr != callback) {
+            LOG_DEBUG("Ticking at path '" << path << "'");
+            callback(*static_cast<const T *>(pOwner), *this, pConnection, pUserData);
         }
     }
 
@@ -152,8 +128,7 @@ private:
     //
 
     const DBusInterface *pOwner;
-    mutable int elapsedTicks;
-    int tickFrequency;
+    int periodMS;
     Callback callback;
     void *pUserData;
 };
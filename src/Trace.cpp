@@ -0,0 +1,121 @@
+// Copyright 2017-2019 Paul Nettle
+//
+// This file is part of Gobbledegook.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file in the root of the source tree.
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// >>
+// >>>  INSIDE THIS FILE
+// >>
+//
+// An always-on binary flight recorder: fixed-size trace records in a lock-free ring
+//
+// >>
+// >>>  DISCUSSION
+// >>
+//
+// The text logging path (`Logger::trace` plus `Utils::hex`) formats strings and allocates, so it stays off in
+// production - which means that when a field unit reports a slow pairing, the evidence is gone. This module is the
+// opposite trade: records are fixed-size binary (timestamp, event id, 8 payload bytes), recording is a relaxed atomic
+// increment plus a handful of stores, and the ring is always on. The cost per record is dominated by the clock read.
+//
+// The ring holds the most recent `kRingSize` records; older records are overwritten. Nothing is ever formatted or
+// allocated at record time - interpretation happens offline, after `ggkDumpTrace()` writes the raw ring to a file.
+// The dump file starts with a 16-byte header (magic "GGKTRACE", a format version, and the record size) followed by
+// the records, oldest first, so a decoder can sanity-check what it is reading.
+//
+// Recording is deliberately not synchronized with dumping: a record being written while the dump walks the ring may
+// be torn. Each record carries the low bits of the cursor that produced it, and the dump drops slots whose cursor
+// doesn't match the position being read - so a dump taken under load silently loses the handful of records that were
+// in flight, rather than stalling the hot paths with a lock.
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include <stdio.h>
+#include <string.h>
+
+#include "Metrics.h"
+#include "Trace.h"
+
+namespace ggk {
+
+// The storage definitions for our static members
+TraceRecord Trace::ring[Trace::kRingSize];
+std::atomic<uint64_t> Trace::writeCursor(0);
+
+// The dump-file header: a magic, a format version, and the record size, so a decoder can reject files it doesn't
+// understand
+static const char kDumpMagic[8] = {'G', 'G', 'K', 'T', 'R', 'A', 'C', 'E'};
+static const uint32_t kDumpVersion = 1;
+
+// Append one record to the ring
+//
+// Lock-free and safe from any thread: the cursor increment claims a slot, and concurrent writers never share one.
+// A reader may observe a slot mid-write - that's what `cursorLow` is for (see `dump`.)
+void Trace::record(EventId eventId, uint64_t payload) {
+    uint64_t cursor = writeCursor.fetch_add(1, std::memory_order_relaxed);
+    TraceRecord &slot = ring[cursor & (kRingSize - 1)];
+
+    slot.timestampNS = Metrics::timestampNS();
+    slot.eventId = eventId;
+    slot.reserved = 0;
+    slot.payload = payload;
+    slot.cursorLow = static_cast<uint32_t>(cursor);
+}
+
+// Packs up to the first 8 characters of `pText` into a payload (little-endian, NUL-padded)
+//
+// This is how string-ish context (a method name, a queue entry) rides in a fixed-size record without an allocation
+// or a string table. Eight characters is enough to tell ReadValue from WriteValue from StartNotify.
+uint64_t Trace::packString(const char *pText) {
+    uint64_t packed = 0;
+    for (int i = 0; i < 8 && 0 != pText[i]; ++i) {
+        packed |= static_cast<uint64_t>(static_cast<uint8_t>(pText[i])) << (i * 8);
+    }
+    return packed;
+}
+
+// Write the ring's contents (oldest record first) to the file at `pPath`
+//
+// Returns the number of records written, or -1 if the file could not be written. Recording continues while the dump
+// runs; slots overwritten or in flight during the walk are dropped (see the discussion above.)
+int Trace::dump(const char *pPath) {
+    FILE *pFile = fopen(pPath, "wb");
+    if (nullptr == pFile) {
+        return -1;
+    }
+
+    uint32_t recordSize = static_cast<uint32_t>(sizeof(TraceRecord));
+    if (1 != fwrite(kDumpMagic, sizeof(kDumpMagic), 1, pFile) || 1 != fwrite(&kDumpVersion, sizeof(kDumpVersion), 1, pFile) ||
+        1 != fwrite(&recordSize, sizeof(recordSize), 1, pFile)) {
+        fclose(pFile);
+        return -1;
+    }
+
+    uint64_t cursor = writeCursor.load(std::memory_order_acquire);
+    uint64_t first = cursor > kRingSize ? cursor - kRingSize : 0;
+
+    int written = 0;
+    for (uint64_t index = first; index < cursor; ++index) {
+        // Copy the slot out, then check that it still belongs to this position - if a writer lapped us (or is mid
+        // write), the cursor bits won't match and we drop the record rather than emit garbage
+        TraceRecord copy = ring[index & (kRingSize - 1)];
+        if (copy.cursorLow != static_cast<uint32_t>(index)) {
+            continue;
+        }
+
+        if (1 != fwrite(&copy, sizeof(copy), 1, pFile)) {
+            fclose(pFile);
+            return -1;
+        }
+
+        written += 1;
+    }
+
+    fclose(pFile);
+    return written;
+}
+
+}; // namespace ggk
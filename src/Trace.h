@@ -0,0 +1,81 @@
+// Copyright 2017-2019 Paul Nettle
+//
+// This file is part of Gobbledegook.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file in the root of the source tree.
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// >>
+// >>>  INSIDE THIS FILE
+// >>
+//
+// An always-on binary flight recorder: fixed-size trace records in a lock-free ring
+//
+// >>
+// >>>  DISCUSSION
+// >>
+//
+// See the discussion at the top of Trace.cpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace ggk {
+
+// One flight-recorder record - fixed size, trivially copyable, written in place in the ring
+//
+// `cursorLow` is the low 32 bits of the ring cursor that produced this record; a reader uses it to reject slots that
+// are being rewritten underneath the dump (see `Trace::dump`.)
+struct TraceRecord {
+    uint64_t timestampNS; // Monotonic, same timebase as Metrics
+    uint16_t eventId;     // One of Trace::EventId
+    uint16_t reserved;
+    uint32_t cursorLow;
+    uint64_t payload; // Event-specific (a byte count, an event/command code, packed characters, ...)
+};
+
+// Our flight recorder
+//
+// A fixed ring of binary records, written lock-free from any thread at a cost of one relaxed atomic increment, one
+// clock read, and four stores - cheap enough to leave enabled in production, which is the whole point: when a field
+// unit reports a slow pairing, the last few thousand HCI and D-Bus events are already in memory, waiting to be dumped
+// (see `ggkDumpTrace` in Gobbledegook.h.)
+struct Trace {
+    // The instrumented points. The payload column says what rides in each record's 8 payload bytes.
+    enum EventId : uint16_t {
+        EHciSocketRead = 1,   // bytes read from the HCI socket
+        EHciSocketWrite = 2,  // bytes written to the HCI socket
+        EHciEventReceived = 3, // HCI event code decoded by the event thread
+        EHciCommandSubmitted = 4, // HCI command code written to the controller
+        EHciCommandSettled = 5,   // HCI command code whose response arrived
+        EMethodEntry = 6, // first 8 characters of the D-Bus method name (see `packString`)
+        EMethodExit = 7,  // first 8 characters of the D-Bus method name
+        EUpdateDequeued = 8 // first 8 characters of the queued update entry
+    };
+
+    // Append one record to the ring (any thread, lock-free, nanosecond-scale)
+    static void record(EventId eventId, uint64_t payload);
+
+    // Packs up to the first 8 characters of `pText` into a payload (little-endian, NUL-padded)
+    static uint64_t packString(const char *pText);
+
+    // Write the ring's contents (oldest record first) to the file at `pPath` - see `ggkDumpTrace`
+    //
+    // Returns the number of records written, or -1 if the file could not be written.
+    static int dump(const char *pPath);
+
+private:
+    // Ring capacity in records (a power of two - the write cursor is masked, never compared)
+    static const size_t kRingSize = 8192;
+
+    static TraceRecord ring[kRingSize];
+    static std::atomic<uint64_t> writeCursor;
+};
+
+}; // namespace ggk
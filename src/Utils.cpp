@@ -29,12 +29,65 @@
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
 #include <algorithm>
+#include <atomic>
+#include <stddef.h>
 #include <string.h>
 
 #include "Utils.h"
 
 namespace ggk {
 
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Pooled byte buffers for GVariant payloads
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// Every byte-array GVariant we build (notification payloads, read responses) used to cost a fresh heap allocation for
+// the GBytes copy - at a steady notify rate that allocator churn is pure overhead. Instead, payloads that fit are
+// copied into one of a fixed set of preallocated MTU-sized buffers, handed to GLib with a free-function that simply
+// returns the buffer to the pool when the variant is released. Oversized payloads (or a momentarily exhausted pool)
+// fall back to the old heap path, so this is purely an optimization - never a constraint.
+
+// Each slot comfortably holds a maximum ATT payload (MTU up to 517 bytes)
+static const int kBytePoolSlotSize = 520;
+
+// Enough slots to cover a full update queue's worth of in-flight payloads
+static const int kBytePoolSlotCount = 32;
+
+// A single pooled buffer - `inUse` is the entire checkout protocol (set with a CAS to acquire, cleared to release)
+struct BytePoolSlot {
+    std::atomic<bool> inUse;
+    guint8 data[kBytePoolSlotSize];
+};
+
+static BytePoolSlot bytePool[kBytePoolSlotCount];
+
+// GDestroyNotify for pooled buffers - GLib calls this (from whatever thread drops the last reference) when the
+// GBytes wrapping the slot is released
+static void releaseBytePoolSlot(gpointer pData) {
+    BytePoolSlot *pSlot = reinterpret_cast<BytePoolSlot *>(
+        reinterpret_cast<guint8 *>(pData) - offsetof(BytePoolSlot, data)
+    );
+    pSlot->inUse.store(false, std::memory_order_release);
+}
+
+// Returns a GBytes backed by a pooled buffer holding a copy of `pBytes`, or nullptr if the payload doesn't fit or no
+// slot is free (in which case the caller should fall back to `g_bytes_new`)
+static GBytes *acquirePooledBytes(const guint8 *pBytes, int count) {
+    if (count > kBytePoolSlotSize) {
+        return nullptr;
+    }
+
+    for (int slot = 0; slot < kBytePoolSlotCount; ++slot) {
+        bool expected = false;
+        if (bytePool[slot].inUse.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            memcpy(bytePool[slot].data, pBytes, count);
+            return g_bytes_new_with_free_func(bytePool[slot].data, count, releaseBytePoolSlot, bytePool[slot].data);
+        }
+    }
+
+    return nullptr;
+}
+
 // ---------------------------------------------------------------------------------------------------------------------------------
 // Handy string functions
 // ---------------------------------------------------------------------------------------------------------------------------------
@@ -313,8 +366,15 @@ GVariant *Utils::gvariantFromByteArray(const std::string &str) {
 }
 
 // Returns an array of bytes ("ay") with the contents of the input array of unsigned 8-bit values
+//
+// The bytes are staged in a pooled buffer when they fit (see the byte pool at the top of this file), avoiding a heap
+// allocation per payload on the notify and read-response paths.
 GVariant *Utils::gvariantFromByteArray(const guint8 *pBytes, int count) {
-    GBytes *pGbytes = g_bytes_new(pBytes, count);
+    GBytes *pGbytes = acquirePooledBytes(pBytes, count);
+    if (nullptr == pGbytes) {
+        pGbytes = g_bytes_new(pBytes, count);
+    }
+
     GVariant *pGVariant = g_variant_new_from_bytes(G_VARIANT_TYPE_BYTESTRING, pGbytes, count);
     g_bytes_unref(pGbytes);
     return pGVariant;
@@ -322,10 +382,7 @@ GVariant *Utils::gvariantFromByteArray(const guint8 *pBytes, int count) {
 
 // Returns an array of bytes ("ay") with the contents of the input array of unsigned 8-bit values
 GVariant *Utils::gvariantFromByteArray(const std::vector<guint8> bytes) {
-    GBytes *pGbytes = g_bytes_new(bytes.data(), bytes.size());
-    GVariant *pGVariant = g_variant_new_from_bytes(G_VARIANT_TYPE_BYTESTRING, pGbytes, bytes.size());
-    g_bytes_unref(pGbytes);
-    return pGVariant;
+    return gvariantFromByteArray(bytes.data(), static_cast<int>(bytes.size()));
 }
 
 // Returns an array of bytes ("ay") containing a single unsigned 8-bit value
@@ -33,6 +33,7 @@
 #include <endian.h>
 #include <gio/gio.h>
 #include <glib.h>
+#include <ostream>
 #include <string>
 #include <vector>
 
@@ -218,4 +219,25 @@ struct Utils {
     }
 };
 
+// A deferred hex/ASCII dump of binary data
+//
+// Holds just a pointer and a count; the dump itself (see `Utils::hex(const uint8_t *, int)`) is only rendered when
+// the object is actually streamed. This lets a dump sit inside a level-gated logging macro without paying for the
+// (potentially multi-kilobyte) formatting when the level is filtered out:
+//
+//    LOG_DEBUG("  > Read " << response.size() << " bytes\n" << HexDump(response.data(), response.size()));
+//
+// The referenced data must outlive the statement that streams the dump.
+struct HexDump {
+    HexDump(const uint8_t *pData, int count) : pData(pData), count(count) {}
+
+    const uint8_t *pData;
+    int count;
+};
+
+// Render a deferred `HexDump` into a stream
+inline std::ostream &operator<<(std::ostream &stream, const HexDump &dump) {
+    return stream << Utils::hex(dump.pData, dump.count);
+}
+
 }; // namespace ggk
@@ -0,0 +1,316 @@
+// Copyright 2017-2019 Paul Nettle
+//
+// This file is part of Gobbledegook.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file in the root of the source tree.
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// >>
+// >>>  INSIDE THIS FILE
+// >>
+//
+// This is `ggk-bench`, a microbenchmark suite for the server's hot paths
+//
+// >>
+// >>>  DISCUSSION
+// >>
+//
+// The benchmarks cover the paths that matter at a 10Hz-and-up notification rate:
+//
+//     - Update queue push/pop throughput, single-threaded and under producer contention
+//     - `Server::findInterface` lookup cost on the real server tree, plus index lookup cost versus tree size
+//     - `Utils::gvariantFromByteArray` / `Utils::bytesVectorFromGVariantByteArray` conversion rates
+//     - An end-to-end mock-bus notification cycle (push -> pop -> resolve -> marshal) latency histogram
+//
+// No Bluetooth controller or D-Bus daemon is required - everything runs in-process against the library. Run it before
+// a release and compare the numbers against the previous release's output; the output is deliberately plain text so
+// two runs can be diffed.
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "../include/Gobbledegook.h"
+#include "DBusObjectPath.h"
+#include "Server.h"
+#include "Utils.h"
+
+using namespace ggk;
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Timing helpers
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the monotonic clock in nanoseconds
+static uint64_t nowNS() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Print one result line: a name, an operation count, and the elapsed time it took
+static void report(const char *pName, uint64_t operations, uint64_t elapsedNS) {
+    double seconds = elapsedNS / 1e9;
+    double opsPerSecond = 0 == elapsedNS ? 0 : operations / seconds;
+    double nsPerOp = 0 == operations ? 0 : static_cast<double>(elapsedNS) / operations;
+    printf("  %-56s %12.0f ops/s  %10.1f ns/op\n", pName, opsPerSecond, nsPerOp);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Benchmark: update queue throughput
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// Pushes `count` updates through the queue with `producerCount` producer threads and a single consumer (matching the
+// server's real topology - many application threads push, the main loop drains)
+static void benchUpdateQueue(int producerCount, uint64_t count) {
+    const uint64_t countPerProducer = count / producerCount;
+
+    uint64_t start = nowNS();
+
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < producerCount; ++producer) {
+        producers.push_back(std::thread([countPerProducer]() {
+            for (uint64_t i = 0; i < countPerProducer; ++i) {
+                // A full queue is not an error here - the consumer is draining as fast as it can, so just retry
+                while (0 == ggkPushUpdateQueue("/com/huupe/Huupe/state/get", "org.bluez.GattCharacteristic1")) {
+                    std::this_thread::yield();
+                }
+            }
+        }));
+    }
+
+    char element[256];
+    uint64_t popped = 0;
+    const uint64_t target = countPerProducer * producerCount;
+    while (popped < target) {
+        if (1 == ggkPopUpdateQueue(element, sizeof(element), 0)) {
+            popped += 1;
+        }
+    }
+
+    for (std::thread &producer : producers) {
+        producer.join();
+    }
+
+    uint64_t elapsed = nowNS() - start;
+    char name[128];
+    snprintf(name, sizeof(name), "update queue push+pop (%d producer%s)", producerCount, 1 == producerCount ? "" : "s");
+    report(name, target, elapsed);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Benchmark: interface lookup
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// Measures `Server::findInterface` on the real server tree (hot hit and miss), then the cost of the underlying index
+// lookup as the tree grows
+static void benchFindInterface(uint64_t iterations) {
+    const DBusObjectPath hitPath("/com/huupe/Huupe/state/get");
+    const DBusObjectPath missPath("/com/huupe/Huupe/no/such/path");
+    const std::string interfaceName = "org.bluez.GattCharacteristic1";
+
+    uint64_t start = nowNS();
+    uint64_t hits = 0;
+    for (uint64_t i = 0; i < iterations; ++i) {
+        if (nullptr != TheServer->findInterface(hitPath, interfaceName)) {
+            hits += 1;
+        }
+    }
+    report("findInterface (hit, real server tree)", iterations, nowNS() - start);
+
+    if (hits != iterations) {
+        printf("  WARNING: findInterface failed to resolve the state/get characteristic\n");
+    }
+
+    start = nowNS();
+    for (uint64_t i = 0; i < iterations; ++i) {
+        if (nullptr != TheServer->findInterface(missPath, interfaceName)) {
+            hits += 1;
+        }
+    }
+    report("findInterface (miss, real server tree)", iterations, nowNS() - start);
+
+    // The index is a flat hash from "path|interface" strings; show how lookup cost scales with the number of
+    // registered interfaces (i.e. with tree size)
+    for (size_t treeSize = 16; treeSize <= 1024; treeSize *= 4) {
+        std::unordered_map<std::string, int> index;
+        for (size_t i = 0; i < treeSize; ++i) {
+            index["/com/huupe/Huupe/characteristic" + std::to_string(i) + "|org.bluez.GattCharacteristic1"] = 1;
+        }
+
+        const std::string key =
+            "/com/huupe/Huupe/characteristic" + std::to_string(treeSize / 2) + "|org.bluez.GattCharacteristic1";
+
+        start = nowNS();
+        uint64_t found = 0;
+        for (uint64_t i = 0; i < iterations; ++i) {
+            found += index.count(key);
+        }
+        uint64_t elapsed = nowNS() - start;
+
+        char name[128];
+        snprintf(name, sizeof(name), "index lookup (%zu interfaces)", treeSize);
+        report(name, iterations, elapsed);
+
+        if (found != iterations) {
+            printf("  WARNING: synthetic index lookup failed\n");
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Benchmark: GVariant byte array conversions
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// Measures `gvariantFromByteArray` (marshal) and `bytesVectorFromGVariantByteArray` (unmarshal) at typical payload
+// sizes: a small telemetry sample, a full default-MTU notification, and a large negotiated-MTU notification
+static void benchGVariantConversions(uint64_t iterations) {
+    static const size_t kPayloadSizes[] = {20, 128, 512};
+
+    for (size_t sizeIndex = 0; sizeIndex < sizeof(kPayloadSizes) / sizeof(kPayloadSizes[0]); ++sizeIndex) {
+        const size_t payloadSize = kPayloadSizes[sizeIndex];
+        std::vector<guint8> payload(payloadSize, 0x5a);
+        char name[128];
+
+        uint64_t start = nowNS();
+        for (uint64_t i = 0; i < iterations; ++i) {
+            GVariant *pVariant = Utils::gvariantFromByteArray(payload.data(), static_cast<int>(payloadSize));
+            g_variant_unref(g_variant_ref_sink(pVariant));
+        }
+        snprintf(name, sizeof(name), "gvariantFromByteArray (%zu bytes)", payloadSize);
+        report(name, iterations, nowNS() - start);
+
+        GVariant *pSource =
+            g_variant_ref_sink(Utils::gvariantFromByteArray(payload.data(), static_cast<int>(payloadSize)));
+        start = nowNS();
+        for (uint64_t i = 0; i < iterations; ++i) {
+            std::vector<guchar> *pBytes = Utils::bytesVectorFromGVariantByteArray(pSource);
+            delete pBytes;
+        }
+        snprintf(name, sizeof(name), "bytesVectorFromGVariantByteArray (%zu bytes)", payloadSize);
+        report(name, iterations, nowNS() - start);
+        g_variant_unref(pSource);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Benchmark: end-to-end mock-bus notification latency
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// Runs the full notification cycle the server performs per update - push onto the queue, pop on the "main loop",
+// resolve the characteristic, marshal the payload - with the actual bus emission mocked out, and reports a latency
+// histogram with percentiles
+static void benchNotificationLatency(uint64_t iterations) {
+    const DBusObjectPath path("/com/huupe/Huupe/state/get");
+    const std::string interfaceName = "org.bluez.GattCharacteristic1";
+    std::vector<guint8> payload(128, 0x5a);
+
+    std::vector<uint64_t> latencies;
+    latencies.reserve(iterations);
+
+    char element[256];
+    for (uint64_t i = 0; i < iterations; ++i) {
+        uint64_t start = nowNS();
+
+        ggkPushUpdateQueue(path.c_str(), interfaceName.c_str());
+        if (1 != ggkPopUpdateQueue(element, sizeof(element), 0)) {
+            printf("  WARNING: update queue pop failed mid-benchmark\n");
+            return;
+        }
+
+        if (nullptr == TheServer->findInterface(path, interfaceName)) {
+            printf("  WARNING: interface resolution failed mid-benchmark\n");
+            return;
+        }
+
+        GVariant *pVariant = Utils::gvariantFromByteArray(payload.data(), static_cast<int>(payload.size()));
+        g_variant_unref(g_variant_ref_sink(pVariant));
+
+        latencies.push_back(nowNS() - start);
+    }
+
+    // Histogram buckets in nanoseconds (the last bucket is everything above)
+    static const uint64_t kBucketLimitsNS[] = {500, 1000, 2000, 5000, 10000, 20000, 50000, 100000, 1000000};
+    static const size_t kBucketCount = sizeof(kBucketLimitsNS) / sizeof(kBucketLimitsNS[0]) + 1;
+    uint64_t buckets[kBucketCount] = {0};
+
+    for (uint64_t latency : latencies) {
+        size_t bucket = 0;
+        while (bucket < kBucketCount - 1 && latency >= kBucketLimitsNS[bucket]) {
+            bucket += 1;
+        }
+        buckets[bucket] += 1;
+    }
+
+    printf("  notification cycle latency (%llu samples):\n", static_cast<unsigned long long>(iterations));
+    uint64_t previousLimit = 0;
+    for (size_t bucket = 0; bucket < kBucketCount; ++bucket) {
+        char range[64];
+        if (bucket < kBucketCount - 1) {
+            snprintf(
+                range,
+                sizeof(range),
+                "%6llu - %6llu ns",
+                static_cast<unsigned long long>(previousLimit),
+                static_cast<unsigned long long>(kBucketLimitsNS[bucket])
+            );
+            previousLimit = kBucketLimitsNS[bucket];
+        } else {
+            snprintf(range, sizeof(range), "       > %6llu ns", static_cast<unsigned long long>(previousLimit));
+        }
+        printf("    %s  %8llu\n", range, static_cast<unsigned long long>(buckets[bucket]));
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    printf(
+        "    p50 %llu ns, p95 %llu ns, p99 %llu ns, max %llu ns\n",
+        static_cast<unsigned long long>(latencies[latencies.size() / 2]),
+        static_cast<unsigned long long>(latencies[latencies.size() * 95 / 100]),
+        static_cast<unsigned long long>(latencies[latencies.size() * 99 / 100]),
+        static_cast<unsigned long long>(latencies.back())
+    );
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Entry point
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// A data getter/setter pair for the server description - the benchmarks never dereference real application data, so
+// these are stubs
+static const void *benchDataGetter(const char * /*pName*/) {
+    return nullptr;
+}
+
+static int benchDataSetter(const char * /*pName*/, const void * /*pData*/) {
+    return 1;
+}
+
+int main(int /*argc*/, char ** /*ppArgv*/) {
+    // Build the real server description so the lookup and latency benchmarks run against the actual tree
+    TheServer = std::make_shared<Server>("huupe", "", "", false, false, benchDataGetter, benchDataSetter);
+
+    printf("ggk-bench\n");
+
+    printf("\nUpdate queue throughput:\n");
+    benchUpdateQueue(1, 1000000);
+    benchUpdateQueue(2, 1000000);
+    benchUpdateQueue(4, 1000000);
+
+    printf("\nInterface lookup:\n");
+    benchFindInterface(1000000);
+
+    printf("\nGVariant conversions:\n");
+    benchGVariantConversions(1000000);
+
+    printf("\nNotification cycle (mock bus):\n");
+    benchNotificationLatency(100000);
+
+    TheServer = nullptr;
+    return 0;
+}
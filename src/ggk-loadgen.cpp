@@ -0,0 +1,660 @@
+// Copyright 2017-2019 Paul Nettle
+//
+// This file is part of Gobbledegook.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file in the root of the source tree.
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// >>
+// >>>  INSIDE THIS FILE
+// >>
+//
+// This is `ggk-loadgen`, a loopback load generator and soak-test harness for the server
+//
+// >>
+// >>>  DISCUSSION
+// >>
+//
+// Where `ggk-bench` microbenchmarks individual hot paths, this tool drives the whole server the way a client would -
+// without needing bluetoothd, a Bluetooth controller, or even a D-Bus daemon. It builds the real server description,
+// then connects a mock GDBus peer to it over a private socketpair (GDBus supports broker-less peer-to-peer
+// connections) and registers the object tree on the server end exactly the way Init.cpp registers it on the system
+// bus. Every ReadValue/WriteValue the peer issues therefore crosses the real `Server::callMethod` dispatch path, and
+// every notification crosses the real update-queue dispatch path, ending in a PropertiesChanged signal delivered back
+// to the peer.
+//
+// Three loads run concurrently for the duration of the run:
+//
+//     - A notification driver hammers `ggkNofifyUpdatedCharacteristic` at a configurable rate; the peer subscribes
+//       with StartNotify and timestamps each PropertiesChanged it receives (the publish time rides in the first
+//       eight payload bytes), giving push-to-delivery latency
+//     - A read client calls ReadValue as fast as replies come back, exercising the data getter delegate
+//     - A write client calls WriteValue with a configurable payload size, exercising the setter delegate
+//
+// At the end of the run, each load reports latency percentiles. Resident set size is sampled throughout and reported
+// alongside - a steadily climbing RSS over a soak run is how a GVariant reference leak shows up long before a unit in
+// the field falls over. Use `--soak` for a multi-hour run with periodic progress lines:
+//
+//     ggk-loadgen [--seconds N] [--rate N] [--payload N] [--soak]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <gio/gio.h>
+#include <mutex>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "../include/Gobbledegook.h"
+#include "DBusObject.h"
+#include "DBusObjectPath.h"
+#include "Logger.h"
+#include "Server.h"
+#include "Utils.h"
+
+using namespace ggk;
+
+namespace ggk {
+// Owned by Init.cpp; the update dispatcher hands it to each characteristic's onUpdatedValue callback. We point it at
+// our peer connection so notifications emitted during dispatch ride our socketpair.
+extern GDBusConnection *pBusConnection;
+
+// Owned by Gobbledegook.cpp; the update dispatcher only drains while the run state is ERunning, so we set it by hand
+// (this harness brings the server up without `ggkStart`'s HCI work)
+void setServerRunState(GGKServerRunState newState);
+}; // namespace ggk
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Configuration and counters
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// The characteristic the loads target
+static const char kTargetPath[] = "/com/huupe/Huupe/state/get";
+static const char kTargetWritePath[] = "/com/huupe/Huupe/state/set";
+static const char kCharacteristicInterface[] = "org.bluez.GattCharacteristic1";
+
+// Run configuration (see `main` for the flags that set these)
+static int runSeconds = 10;
+static int notifyRate = 100;
+static size_t payloadSize = 100;
+static bool bSoakMode = false;
+
+// Set false when the run duration elapses; the load threads poll it
+static std::atomic<bool> bRunning(true);
+
+// Counters the progress line and final report read
+static std::atomic<uint64_t> notifyPushCount(0);
+static std::atomic<uint64_t> notifyRejectCount(0);
+static std::atomic<uint64_t> notifyDeliveredCount(0);
+static std::atomic<uint64_t> readCount(0);
+static std::atomic<uint64_t> writeCount(0);
+static std::atomic<uint64_t> errorCount(0);
+
+// The publish timestamp the notification driver last stamped (the data getter embeds it in the served value)
+static std::atomic<uint64_t> notifyPublishTimeNS(0);
+
+// Latency samples, one vector per load (the notification vector is only touched from the main loop; the read/write
+// vectors are each owned by their client thread until the threads are joined)
+static std::vector<uint64_t> notifyLatencies;
+static std::vector<uint64_t> readLatencies;
+static std::vector<uint64_t> writeLatencies;
+
+// RSS tracking
+static long rssStartKB = 0;
+static long rssMaxKB = 0;
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the monotonic clock in nanoseconds
+static uint64_t nowNS() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Returns the current resident set size in kilobytes (0 if /proc isn't readable)
+static long currentRSSKB() {
+    FILE *pFile = fopen("/proc/self/statm", "r");
+    if (nullptr == pFile) {
+        return 0;
+    }
+
+    long sizePages = 0;
+    long rssPages = 0;
+    int matched = fscanf(pFile, "%ld %ld", &sizePages, &rssPages);
+    fclose(pFile);
+
+    if (2 != matched) {
+        return 0;
+    }
+
+    return rssPages * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+// Print one latency percentile line for a load (sorts `latencies` in place)
+static void reportPercentiles(const char *pName, std::vector<uint64_t> &latencies) {
+    if (latencies.empty()) {
+        printf("  %-24s (no samples)\n", pName);
+        return;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    printf(
+        "  %-24s %8zu samples  p50 %7.1f us  p95 %7.1f us  p99 %7.1f us  max %7.1f us\n",
+        pName,
+        latencies.size(),
+        latencies[latencies.size() / 2] / 1e3,
+        latencies[latencies.size() * 95 / 100] / 1e3,
+        latencies[latencies.size() * 99 / 100] / 1e3,
+        latencies.back() / 1e3
+    );
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Data delegates
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// The value served for state reads and notifications. Only the main loop reads it (the getter is called during method
+// and update dispatch), and only the getter writes the timestamp, so no lock is needed.
+static std::vector<guint8> stateValue;
+
+static const void *loadgenDataGetter(const char *pName) {
+    if (0 == strcmp(pName, "Huupe/state/get")) {
+        // Stamp the driver's publish time into the payload so the peer can compute push-to-delivery latency
+        uint64_t publishTime = notifyPublishTimeNS.load(std::memory_order_relaxed);
+        if (stateValue.size() >= sizeof(publishTime)) {
+            memcpy(stateValue.data(), &publishTime, sizeof(publishTime));
+        }
+        return &stateValue;
+    }
+
+    return nullptr;
+}
+
+static int loadgenDataSetter(const char *pName, const void *pData) {
+    if (0 == strcmp(pName, "Huupe/state/set")) {
+        // The write path hands us a heap-allocated vector (see `onWriteStateSet`); we own it from here
+        delete static_cast<const std::vector<guint8> *>(pData);
+        return 1;
+    }
+
+    return 1;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Server-side registration (the same shape as `registerObjects` in Init.cpp, against our peer connection)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// Handle D-Bus method calls arriving over the peer connection by handing them to the real server dispatch
+static void onLoadgenMethodCall(
+    GDBusConnection *pConnection,
+    const gchar * /*pSender*/,
+    const gchar *pObjectPath,
+    const gchar *pInterfaceName,
+    const gchar *pMethodName,
+    GVariant *pParameters,
+    GDBusMethodInvocation *pInvocation,
+    gpointer pUserData
+) {
+    DBusObjectPath objectPath(pObjectPath);
+    if (!TheServer
+             ->callMethod(objectPath, pInterfaceName, pMethodName, pConnection, pParameters, pInvocation, pUserData)) {
+        g_dbus_method_invocation_return_dbus_error(
+            pInvocation,
+            "org.bluez.Error.NotSupported",
+            "This method is not implemented"
+        );
+    }
+}
+
+// Registers one introspection node (and its children) on the peer connection
+static bool registerNode(GDBusConnection *pConnection, GDBusNodeInfo *pNode, const DBusObjectPath &basePath) {
+    static GDBusInterfaceVTable interfaceVtable;
+    interfaceVtable.method_call = onLoadgenMethodCall;
+
+    GDBusInterfaceInfo **ppInterface = pNode->interfaces;
+    while (nullptr != *ppInterface) {
+        GError *pError = nullptr;
+        guint registeredObjectId = g_dbus_connection_register_object(
+            pConnection,
+            basePath.c_str(),
+            *ppInterface,
+            &interfaceVtable,
+            nullptr,
+            nullptr,
+            &pError
+        );
+
+        if (0 == registeredObjectId) {
+            fprintf(
+                stderr,
+                "Failed to register %s: %s\n",
+                basePath.c_str(),
+                nullptr == pError ? "Unknown" : pError->message
+            );
+            return false;
+        }
+
+        ++ppInterface;
+    }
+
+    GDBusNodeInfo **ppChild = pNode->nodes;
+    while (nullptr != *ppChild) {
+        if (!registerNode(pConnection, *ppChild, basePath + (*ppChild)->path)) {
+            return false;
+        }
+        ++ppChild;
+    }
+
+    return true;
+}
+
+// Registers the full server tree on the peer connection
+static bool registerServerTree(GDBusConnection *pConnection) {
+    for (const DBusObject &object : TheServer->getObjects()) {
+        GError *pError = nullptr;
+        std::string xmlString = object.generateIntrospectionXML();
+        GDBusNodeInfo *pNode = g_dbus_node_info_new_for_xml(xmlString.c_str(), &pError);
+        if (nullptr == pNode) {
+            fprintf(stderr, "Failed to parse XML: %s\n", nullptr == pError ? "Unknown" : pError->message);
+            return false;
+        }
+
+        bool registered = registerNode(pConnection, pNode, DBusObjectPath(pNode->path));
+        g_dbus_node_info_unref(pNode);
+        if (!registered) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Peer connection plumbing
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// Wraps one end of a socketpair in a GIOStream suitable for `g_dbus_connection_new_sync`
+static GIOStream *streamFromFd(int fd) {
+    GError *pError = nullptr;
+    GSocket *pSocket = g_socket_new_from_fd(fd, &pError);
+    if (nullptr == pSocket) {
+        fprintf(stderr, "g_socket_new_from_fd: %s\n", nullptr == pError ? "Unknown" : pError->message);
+        return nullptr;
+    }
+
+    GSocketConnection *pStream = g_socket_connection_factory_create_connection(pSocket);
+    g_object_unref(pSocket);
+    return G_IO_STREAM(pStream);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Loads
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// The peer's handler for PropertiesChanged - recovers the publish timestamp from the payload and records the latency
+static void onPropertiesChanged(
+    GDBusConnection * /*pConnection*/,
+    const gchar * /*pSender*/,
+    const gchar * /*pObjectPath*/,
+    const gchar * /*pInterfaceName*/,
+    const gchar * /*pSignalName*/,
+    GVariant *pParameters,
+    gpointer /*pUserData*/
+) {
+    uint64_t receiveTime = nowNS();
+
+    GVariant *pChanged = g_variant_get_child_value(pParameters, 1);
+    GVariant *pValue = g_variant_lookup_value(pChanged, "Value", G_VARIANT_TYPE("ay"));
+    if (nullptr != pValue) {
+        gsize count = 0;
+        const void *pData = g_variant_get_fixed_array(pValue, &count, 1);
+        if (count >= sizeof(uint64_t)) {
+            uint64_t publishTime;
+            memcpy(&publishTime, pData, sizeof(publishTime));
+            if (0 != publishTime && receiveTime > publishTime) {
+                notifyLatencies.push_back(receiveTime - publishTime);
+            }
+        }
+        g_variant_unref(pValue);
+    }
+    g_variant_unref(pChanged);
+
+    notifyDeliveredCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+// The notification driver - pushes updates at the configured rate from its own thread, like an application would
+static void notifyDriverLoop() {
+    const std::chrono::nanoseconds period(1000000000ll / (notifyRate > 0 ? notifyRate : 1));
+    auto nextPush = std::chrono::steady_clock::now();
+
+    while (bRunning.load(std::memory_order_relaxed)) {
+        notifyPublishTimeNS.store(nowNS(), std::memory_order_relaxed);
+        if (0 != ggkNofifyUpdatedCharacteristic(kTargetPath)) {
+            notifyPushCount.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            notifyRejectCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        nextPush += period;
+        std::this_thread::sleep_until(nextPush);
+    }
+}
+
+// The read client - calls ReadValue over the peer connection as fast as replies come back
+static void readClientLoop(GDBusConnection *pConnection) {
+    while (bRunning.load(std::memory_order_relaxed)) {
+        GError *pError = nullptr;
+        uint64_t start = nowNS();
+        GVariant *pReply = g_dbus_connection_call_sync(
+            pConnection,
+            nullptr, // no destination on a peer-to-peer connection
+            kTargetPath,
+            kCharacteristicInterface,
+            "ReadValue",
+            g_variant_new("(@a{sv})", g_variant_new_array(G_VARIANT_TYPE("{sv}"), nullptr, 0)),
+            G_VARIANT_TYPE("(ay)"),
+            G_DBUS_CALL_FLAGS_NONE,
+            5000,
+            nullptr,
+            &pError
+        );
+
+        if (nullptr == pReply) {
+            errorCount.fetch_add(1, std::memory_order_relaxed);
+            if (nullptr != pError) {
+                g_error_free(pError);
+            }
+            continue;
+        }
+
+        readLatencies.push_back(nowNS() - start);
+        readCount.fetch_add(1, std::memory_order_relaxed);
+        g_variant_unref(pReply);
+    }
+}
+
+// The write client - calls WriteValue with the configured payload size, exercising the setter delegate
+static void writeClientLoop(GDBusConnection *pConnection) {
+    std::vector<guint8> payload(payloadSize, 0x5a);
+
+    while (bRunning.load(std::memory_order_relaxed)) {
+        GError *pError = nullptr;
+        uint64_t start = nowNS();
+        GVariant *pReply = g_dbus_connection_call_sync(
+            pConnection,
+            nullptr,
+            kTargetWritePath,
+            kCharacteristicInterface,
+            "WriteValue",
+            g_variant_new(
+                "(@ay@a{sv})",
+                g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, payload.data(), payload.size(), 1),
+                g_variant_new_array(G_VARIANT_TYPE("{sv}"), nullptr, 0)
+            ),
+            nullptr,
+            G_DBUS_CALL_FLAGS_NONE,
+            5000,
+            nullptr,
+            &pError
+        );
+
+        if (nullptr == pReply) {
+            errorCount.fetch_add(1, std::memory_order_relaxed);
+            if (nullptr != pError) {
+                g_error_free(pError);
+            }
+            continue;
+        }
+
+        writeLatencies.push_back(nowNS() - start);
+        writeCount.fetch_add(1, std::memory_order_relaxed);
+        g_variant_unref(pReply);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Run control (main loop sources)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static GMainLoop *pMainLoop = nullptr;
+
+// RSS sampler (and, in soak mode, the progress line)
+static gboolean onSampleTick(gpointer /*pUserData*/) {
+    long rssKB = currentRSSKB();
+    rssMaxKB = std::max(rssMaxKB, rssKB);
+
+    if (bSoakMode) {
+        printf(
+            "  soak: notify %llu/%llu (pushed/delivered), reads %llu, writes %llu, errors %llu, RSS %ld KB (%+ld KB)\n",
+            static_cast<unsigned long long>(notifyPushCount.load()),
+            static_cast<unsigned long long>(notifyDeliveredCount.load()),
+            static_cast<unsigned long long>(readCount.load()),
+            static_cast<unsigned long long>(writeCount.load()),
+            static_cast<unsigned long long>(errorCount.load()),
+            rssKB,
+            rssKB - rssStartKB
+        );
+        fflush(stdout);
+    }
+
+    return TRUE;
+}
+
+// Ends the run: stop the loads, then give in-flight calls a beat to complete before quitting the loop
+static gboolean onRunComplete(gpointer /*pUserData*/) {
+    bRunning.store(false);
+    g_timeout_add(500, [](gpointer) -> gboolean {
+        g_main_loop_quit(pMainLoop);
+        return FALSE;
+    }, nullptr);
+    return FALSE;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Entry point
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char **ppArgv) {
+    bool bSecondsGiven = false;
+    for (int i = 1; i < argc; ++i) {
+        if (0 == strcmp(ppArgv[i], "--seconds") && i + 1 < argc) {
+            runSeconds = atoi(ppArgv[++i]);
+            bSecondsGiven = true;
+        } else if (0 == strcmp(ppArgv[i], "--rate") && i + 1 < argc) {
+            notifyRate = atoi(ppArgv[++i]);
+        } else if (0 == strcmp(ppArgv[i], "--payload") && i + 1 < argc) {
+            payloadSize = static_cast<size_t>(atoi(ppArgv[++i]));
+        } else if (0 == strcmp(ppArgv[i], "--soak")) {
+            bSoakMode = true;
+        } else {
+            fprintf(stderr, "usage: ggk-loadgen [--seconds N] [--rate N] [--payload N] [--soak]\n");
+            return 1;
+        }
+    }
+
+    // A soak run defaults to four hours
+    if (bSoakMode && !bSecondsGiven) {
+        runSeconds = 4 * 60 * 60;
+    }
+
+    // Keep the harness quiet - the server logs every method call at info level
+    ggkLogRegisterError([](const char *pText) { fprintf(stderr, "E %s\n", pText); });
+    ggkLogRegisterFatal([](const char *pText) { fprintf(stderr, "F %s\n", pText); });
+
+    // The served value; the first eight bytes carry the notification publish timestamp
+    stateValue.assign(std::max(payloadSize, sizeof(uint64_t)), 0x5a);
+
+    // Build the real server description
+    TheServer = std::make_shared<Server>("huupe", "", "", false, false, loadgenDataGetter, loadgenDataSetter);
+
+    // Wire up the peer-to-peer connection pair over a socketpair. The client end handshakes from its own thread
+    // (both ends of a GDBus handshake block until the other side answers.)
+    int fds[2];
+    if (0 != socketpair(AF_UNIX, SOCK_STREAM, 0, fds)) {
+        fprintf(stderr, "socketpair failed\n");
+        return 1;
+    }
+
+    GDBusConnection *pClientConnection = nullptr;
+    std::thread clientSetup([&pClientConnection, &fds]() {
+        GIOStream *pStream = streamFromFd(fds[1]);
+        GError *pError = nullptr;
+        pClientConnection = g_dbus_connection_new_sync(
+            pStream,
+            nullptr, // client side provides no GUID
+            G_DBUS_CONNECTION_FLAGS_NONE,
+            nullptr,
+            nullptr,
+            &pError
+        );
+        if (nullptr == pClientConnection) {
+            fprintf(stderr, "client connection: %s\n", nullptr == pError ? "Unknown" : pError->message);
+        }
+        g_object_unref(pStream);
+    });
+
+    GIOStream *pServerStream = streamFromFd(fds[0]);
+    gchar *pGuid = g_dbus_generate_guid();
+    GError *pError = nullptr;
+    GDBusConnection *pServerConnection = g_dbus_connection_new_sync(
+        pServerStream,
+        pGuid,
+        static_cast<GDBusConnectionFlags>(
+            G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_SERVER | G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_ALLOW_ANONYMOUS |
+            G_DBUS_CONNECTION_FLAGS_DELAY_MESSAGE_PROCESSING
+        ),
+        nullptr,
+        nullptr,
+        &pError
+    );
+    g_free(pGuid);
+    g_object_unref(pServerStream);
+    clientSetup.join();
+
+    if (nullptr == pServerConnection || nullptr == pClientConnection) {
+        fprintf(stderr, "server connection: %s\n", nullptr == pError ? "Unknown" : pError->message);
+        return 1;
+    }
+
+    // Register the tree before the peer can send anything, then open the floodgates
+    if (!registerServerTree(pServerConnection)) {
+        return 1;
+    }
+    g_dbus_connection_start_message_processing(pServerConnection);
+
+    // Let the production update dispatcher run: it drains onto this connection, in the running state
+    pBusConnection = pServerConnection;
+    setServerRunState(ERunning);
+
+    // The peer subscribes to notifications the way BlueZ proxies a real client's CCCD write
+    g_dbus_connection_signal_subscribe(
+        pClientConnection,
+        nullptr,
+        "org.freedesktop.DBus.Properties",
+        "PropertiesChanged",
+        kTargetPath,
+        nullptr,
+        G_DBUS_SIGNAL_FLAGS_NONE,
+        onPropertiesChanged,
+        nullptr,
+        nullptr
+    );
+
+    GVariant *pReply = g_dbus_connection_call_sync(
+        pClientConnection,
+        nullptr,
+        kTargetPath,
+        kCharacteristicInterface,
+        "StartNotify",
+        nullptr,
+        nullptr,
+        G_DBUS_CALL_FLAGS_NONE,
+        5000,
+        nullptr,
+        &pError
+    );
+    if (nullptr == pReply) {
+        fprintf(stderr, "StartNotify failed: %s\n", nullptr == pError ? "Unknown" : pError->message);
+        return 1;
+    }
+    g_variant_unref(pReply);
+
+    printf(
+        "ggk-loadgen: %d second%s, %d notifications/s, %zu byte payloads%s\n",
+        runSeconds,
+        1 == runSeconds ? "" : "s",
+        notifyRate,
+        payloadSize,
+        bSoakMode ? " (soak mode)" : ""
+    );
+
+    rssStartKB = currentRSSKB();
+    rssMaxKB = rssStartKB;
+    notifyLatencies.reserve(static_cast<size_t>(runSeconds) * notifyRate);
+
+    // Start the loads and run the main loop for the configured duration
+    std::thread notifyDriver(notifyDriverLoop);
+    std::thread readClient(readClientLoop, pClientConnection);
+    std::thread writeClient(writeClientLoop, pClientConnection);
+
+    g_timeout_add_seconds(bSoakMode ? 30 : 5, onSampleTick, nullptr);
+    g_timeout_add_seconds(runSeconds, onRunComplete, nullptr);
+
+    pMainLoop = g_main_loop_new(nullptr, FALSE);
+    g_main_loop_run(pMainLoop);
+
+    notifyDriver.join();
+    readClient.join();
+    writeClient.join();
+
+    long rssEndKB = currentRSSKB();
+    rssMaxKB = std::max(rssMaxKB, rssEndKB);
+
+    printf("\nLatency:\n");
+    reportPercentiles("notification (loopback)", notifyLatencies);
+    reportPercentiles("ReadValue round trip", readLatencies);
+    reportPercentiles("WriteValue round trip", writeLatencies);
+
+    printf("\nThroughput:\n");
+    printf(
+        "  notifications pushed %llu, rejected %llu, delivered %llu\n",
+        static_cast<unsigned long long>(notifyPushCount.load()),
+        static_cast<unsigned long long>(notifyRejectCount.load()),
+        static_cast<unsigned long long>(notifyDeliveredCount.load())
+    );
+    printf(
+        "  reads %llu, writes %llu, errors %llu\n",
+        static_cast<unsigned long long>(readCount.load()),
+        static_cast<unsigned long long>(writeCount.load()),
+        static_cast<unsigned long long>(errorCount.load())
+    );
+
+    printf("\nMemory:\n");
+    printf(
+        "  RSS start %ld KB, end %ld KB, max %ld KB (delta %+ld KB over %d seconds)\n",
+        rssStartKB,
+        rssEndKB,
+        rssMaxKB,
+        rssEndKB - rssStartKB,
+        runSeconds
+    );
+
+    setServerRunState(EStopped);
+    pBusConnection = nullptr;
+    g_object_unref(pClientConnection);
+    g_object_unref(pServerConnection);
+    TheServer = nullptr;
+
+    return 0;
+}